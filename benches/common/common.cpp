@@ -0,0 +1,46 @@
+#include "common/common.h"
+
+#include <array>
+#include <cstddef>
+#include <format>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "evlist/device.h"
+
+std::vector<evlist::InputDevice> evlist::create_devices(std::size_t count) {
+    constexpr std::array<std::string_view, 4> NAMES{
+        "Logitech USB Receiver",
+        "AT Translated Set 2 keyboard",
+        "SynPS/2 Synaptics TouchPad",
+        "uinput virtual device"
+    };
+    constexpr std::array<std::string_view, 5> CAPABILITIES{
+        "EV_SYN", "EV_KEY", "EV_REL", "EV_ABS", "EV_MSC"
+    };
+
+    std::vector<InputDevice> devices{};
+    devices.reserve(count);
+    for (std::size_t i = 0; i < count; i++) {
+        std::vector<std::string> capabilities{};
+        for (std::size_t j = 0; j < CAPABILITIES.size(); j++) {
+            if (j == 0 || (i + j) % 3 != 0) {
+                capabilities.emplace_back(CAPABILITIES.at(j));
+            }
+        }
+
+        auto name = NAMES.at(i % NAMES.size());
+        devices.emplace_back(
+            std::format("/dev/input/event{}", i),
+            std::format("{} {}", name, i % 16),
+            i % 2 == 0 ? std::optional{std::format("usb-{}-event-kbd", i)}
+                       : std::nullopt,
+            std::format("platform-i8042-serio-{}-event", i),
+            std::move(capabilities)
+        );
+    }
+
+    return devices;
+}
@@ -0,0 +1,22 @@
+#ifndef EVLIST_UTILS_BENCH_H
+#define EVLIST_UTILS_BENCH_H
+
+#include <cstddef>
+#include <vector>
+
+#include "evlist/device.h"
+
+namespace evlist {
+
+/**
+ * Create synthetic devices which resemble a host with many virtual devices,
+ * where names, by-id paths and capabilities repeat across devices.
+ *
+ * @param count the number of devices
+ * @return the devices in natural sort order
+ */
+std::vector<InputDevice> create_devices(std::size_t count);
+
+} // namespace evlist
+
+#endif // EVLIST_UTILS_BENCH_H
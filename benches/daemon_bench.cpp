@@ -0,0 +1,73 @@
+#include <benchmark/benchmark.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstddef>
+#include <filesystem>
+#include <format>
+#include <stop_token>
+#include <thread>
+
+#include "common/common.h"
+#include "evlist/cli.h"
+#include "evlist/daemon.h"
+#include "evlist/device.h"
+#include "evlist/snapshot.h"
+
+namespace {
+
+constexpr std::size_t DEVICES{64};
+
+evlist::DeviceRequest create_request() {
+    evlist::DeviceRequest request{};
+    request.output_format = evlist::Format::CSV;
+    request.filter.emplace_back(evlist::FilterTerm{
+        evlist::Filter::CAPABILITIES, "EV_KEY", evlist::FilterOperator::EQUAL
+    });
+    return request;
+}
+
+// Filtering and formatting the snapshot, without the socket.
+void BM_Query(benchmark::State& state) {
+    const auto path = std::filesystem::temp_directory_path() /
+                      std::format("evlist_{}_bench_query.sock", getpid());
+    const evlist::InputDevicesSnapshot snapshot{
+        evlist::InputDevices{evlist::create_devices(DEVICES)}
+    };
+    const auto server = evlist::DeviceServer::bind(path, snapshot);
+    const auto request = create_request();
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(server->query(request));
+    }
+    std::filesystem::remove(path);
+}
+
+// A client round trip to a server running on another thread.
+void BM_RoundTrip(benchmark::State& state) {
+    using namespace std::chrono_literals;
+
+    const auto path = std::filesystem::temp_directory_path() /
+                      std::format("evlist_{}_bench_round_trip.sock", getpid());
+    const evlist::InputDevicesSnapshot snapshot{
+        evlist::InputDevices{evlist::create_devices(DEVICES)}
+    };
+    auto server = evlist::DeviceServer::bind(path, snapshot).value();
+    const std::jthread serve{[&server](const std::stop_token& stop) {
+        while (!stop.stop_requested()) {
+            server.poll(10ms);
+        }
+    }};
+
+    auto client = evlist::DeviceClient::connect(path).value();
+    const auto request = create_request();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(client.query(request));
+    }
+    std::filesystem::remove(path);
+}
+
+} // namespace
+
+BENCHMARK(BM_Query)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_RoundTrip)->Unit(benchmark::kMicrosecond)->UseRealTime();
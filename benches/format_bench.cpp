@@ -0,0 +1,43 @@
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <iterator>
+#include <string>
+
+#include "common/common.h"
+#include "evlist/cli.h"
+#include "evlist/device.h"
+
+namespace {
+
+constexpr std::size_t DEVICES{1024};
+
+void format(benchmark::State& state, evlist::Format output_format) {
+    auto devices = evlist::InputDevices{
+        output_format, evlist::create_devices(DEVICES)
+    }.with_parent_columns(state.range(0) != 0);
+
+    std::string output{};
+    for (auto _ : state) {
+        output.clear();
+        std::format_to(std::back_inserter(output), "{}", devices);
+        benchmark::DoNotOptimize(output.data());
+    }
+    state.SetItemsProcessed(
+        static_cast<int64_t>(state.iterations() * DEVICES)
+    );
+    state.SetBytesProcessed(
+        static_cast<int64_t>(state.iterations() * output.size())
+    );
+}
+
+} // namespace
+
+// The argument selects whether the parent columns are formatted.
+BENCHMARK_CAPTURE(format, Table, evlist::Format::TABLE)->Arg(0)->Arg(1);
+BENCHMARK_CAPTURE(format, Csv, evlist::Format::CSV)->Arg(0)->Arg(1);
+BENCHMARK_CAPTURE(format, Tsv, evlist::Format::TSV)->Arg(0)->Arg(1);
+BENCHMARK_CAPTURE(format, Json, evlist::Format::JSON)->Arg(0)->Arg(1);
+BENCHMARK_CAPTURE(format, Ndjson, evlist::Format::NDJSON)->Arg(0)->Arg(1);
@@ -0,0 +1,102 @@
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <regex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/common.h"
+#include "evlist/cli.h"
+#include "evlist/device.h"
+#include "evlist/glob.h"
+
+namespace {
+
+constexpr std::size_t DEVICES{1024};
+
+// Each glob and the regex it is equivalent to.
+const std::vector<std::pair<std::string, std::string>> PATTERNS{
+    {"usb-*-kbd", "^usb-.*-kbd$"},
+    {"/dev/input/event1?", "^/dev/input/event1.$"},
+    {"*Logitech*Receiver*", "^.*Logitech.*Receiver.*$"},
+    {"platform-i8042-serio-[0-9]*", "^platform-i8042-serio-[0-9].*$"},
+};
+
+std::vector<std::string> values() {
+    std::vector<std::string> out{};
+    for (const auto& device : evlist::create_devices(DEVICES)) {
+        out.emplace_back(device.device_path().string());
+        out.emplace_back(device.name());
+        out.emplace_back(device.by_id().value_or(""));
+        out.emplace_back(device.by_path().value_or(""));
+    }
+    return out;
+}
+
+void BM_MatchGlob(benchmark::State& state) {
+    auto inputs = values();
+    std::vector<evlist::Glob> globs{};
+    for (const auto& [glob, regex] : PATTERNS) {
+        globs.emplace_back(glob);
+    }
+
+    for (auto _ : state) {
+        for (const auto& glob : globs) {
+            for (const auto& input : inputs) {
+                benchmark::DoNotOptimize(glob.matches(input));
+            }
+        }
+    }
+    state.SetItemsProcessed(
+        static_cast<int64_t>(state.iterations() * globs.size() * inputs.size())
+    );
+}
+BENCHMARK(BM_MatchGlob);
+
+void BM_MatchRegex(benchmark::State& state) {
+    auto inputs = values();
+    std::vector<std::regex> regexes{};
+    for (const auto& [glob, regex] : PATTERNS) {
+        regexes.emplace_back(regex);
+    }
+
+    for (auto _ : state) {
+        for (const auto& regex : regexes) {
+            for (const auto& input : inputs) {
+                benchmark::DoNotOptimize(std::regex_search(input, regex));
+            }
+        }
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(
+        state.iterations() * regexes.size() * inputs.size()
+    ));
+}
+BENCHMARK(BM_MatchRegex);
+
+// Filtering includes compiling the patterns, which is done for every listing.
+void filter(benchmark::State& state, bool use_glob) {
+    const evlist::InputDevices devices{evlist::create_devices(DEVICES)};
+    const std::vector<evlist::FilterTerm> filter{
+        {evlist::Filter::BY_ID, use_glob ? "usb-*-kbd" : "^usb-.*-kbd$"},
+        {evlist::Filter::DEVICE_PATH,
+         use_glob ? "/dev/input/event1?" : "^/dev/input/event1.$"}
+    };
+
+    for (auto _ : state) {
+        auto filtered = devices;
+        filtered.filter(filter, !use_glob, use_glob);
+        benchmark::DoNotOptimize(filtered.devices().data());
+    }
+    state.SetItemsProcessed(
+        static_cast<int64_t>(state.iterations() * DEVICES)
+    );
+}
+
+void BM_FilterGlob(benchmark::State& state) { filter(state, true); }
+BENCHMARK(BM_FilterGlob);
+
+void BM_FilterRegex(benchmark::State& state) { filter(state, false); }
+BENCHMARK(BM_FilterRegex);
+
+} // namespace
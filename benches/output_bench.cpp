@@ -0,0 +1,76 @@
+#include <benchmark/benchmark.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <iterator>
+#include <string>
+
+#include "common/common.h"
+#include "evlist/cli.h"
+#include "evlist/device.h"
+#include "evlist/events.h"
+#include "evlist/output.h"
+
+namespace {
+
+constexpr std::size_t DEVICES{16384};
+
+evlist::InputDevices create_devices(evlist::Format output_format) {
+    return evlist::InputDevices{
+        output_format, evlist::create_devices(DEVICES)
+    };
+}
+
+// Formatting serially into one buffer and writing it, as before.
+void serial(benchmark::State& state, evlist::Format output_format) {
+    auto devices = create_devices(output_format);
+    const evlist::FileDescriptor null{
+        ::open("/dev/null", O_WRONLY | O_CLOEXEC)
+    };
+
+    std::string output{};
+    for (auto _ : state) {
+        output.clear();
+        std::format_to(std::back_inserter(output), "{}", devices);
+        benchmark::DoNotOptimize(
+            write(null.get(), output.data(), output.size())
+        );
+    }
+    state.SetItemsProcessed(
+        static_cast<int64_t>(state.iterations() * DEVICES)
+    );
+}
+
+// The argument is the number of threads formatting chunks of rows.
+void chunked(benchmark::State& state, evlist::Format output_format) {
+    auto devices = create_devices(output_format);
+    const evlist::FileDescriptor null{
+        ::open("/dev/null", O_WRONLY | O_CLOEXEC)
+    };
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(evlist::write_devices(
+            null.get(), devices, static_cast<std::size_t>(state.range(0))
+        ));
+    }
+    state.SetItemsProcessed(
+        static_cast<int64_t>(state.iterations() * DEVICES)
+    );
+}
+
+} // namespace
+
+// Threads format in parallel, so the benchmarks are measured in wall time.
+BENCHMARK_CAPTURE(serial, Table, evlist::Format::TABLE)->UseRealTime();
+BENCHMARK_CAPTURE(serial, Csv, evlist::Format::CSV)->UseRealTime();
+BENCHMARK_CAPTURE(chunked, Table, evlist::Format::TABLE)
+    ->RangeMultiplier(2)
+    ->Range(1, 8)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(chunked, Csv, evlist::Format::CSV)
+    ->RangeMultiplier(2)
+    ->Range(1, 8)
+    ->UseRealTime();
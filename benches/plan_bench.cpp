@@ -0,0 +1,97 @@
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/common.h"
+#include "evlist/cli.h"
+#include "evlist/device.h"
+#include "evlist/plan.h"
+
+namespace {
+
+constexpr std::size_t DEVICES{1024};
+
+void filter(
+    benchmark::State& state,
+    const std::vector<evlist::FilterTerm>& filter,
+    bool use_regex
+) {
+    // Devices are matched in place rather than filtering a copy, so that
+    // copying the devices is not measured.
+    const evlist::InputDevices devices{evlist::create_devices(DEVICES)};
+    for (auto _ : state) {
+        evlist::FilterPlan plan{filter, use_regex};
+        std::size_t matched = 0;
+        for (const auto& device : devices.devices()) {
+            matched += plan.matches(device) ? 1 : 0;
+        }
+        benchmark::DoNotOptimize(matched);
+    }
+    state.SetItemsProcessed(
+        static_cast<int64_t>(state.iterations() * DEVICES)
+    );
+}
+
+// The expensive capabilities regex comes first, but the path regex rejects
+// almost every device, so it should be evaluated first.
+void BM_FilterRegexBadlyOrdered(benchmark::State& state) {
+    filter(
+        state,
+        {{evlist::Filter::CAPABILITIES, "EV_(KEY|ABS)"},
+         {evlist::Filter::NAME, "^(Logitech|AT)"},
+         {evlist::Filter::DEVICE_PATH, "event1[0-9]$"}},
+        true
+    );
+}
+BENCHMARK(BM_FilterRegexBadlyOrdered);
+
+void BM_FilterRegexWellOrdered(benchmark::State& state) {
+    filter(
+        state,
+        {{evlist::Filter::DEVICE_PATH, "event1[0-9]$"},
+         {evlist::Filter::NAME, "^(Logitech|AT)"},
+         {evlist::Filter::CAPABILITIES, "EV_(KEY|ABS)"}},
+        true
+    );
+}
+BENCHMARK(BM_FilterRegexWellOrdered);
+
+// Equality filters where the only selective filter is last.
+void BM_FilterEqualityBadlyOrdered(benchmark::State& state) {
+    filter(
+        state,
+        {{evlist::Filter::CAPABILITIES, "EV_SYN"},
+         {evlist::Filter::BY_PATH, "platform-i8042-serio-10-event"},
+         {evlist::Filter::DEVICE_PATH, "/dev/input/event10"}},
+        false
+    );
+}
+BENCHMARK(BM_FilterEqualityBadlyOrdered);
+
+void BM_FilterEqualityWellOrdered(benchmark::State& state) {
+    filter(
+        state,
+        {{evlist::Filter::DEVICE_PATH, "/dev/input/event10"},
+         {evlist::Filter::BY_PATH, "platform-i8042-serio-10-event"},
+         {evlist::Filter::CAPABILITIES, "EV_SYN"}},
+        false
+    );
+}
+BENCHMARK(BM_FilterEqualityWellOrdered);
+
+// Capabilities and names repeat across devices, so each distinct value is
+// only searched once.
+void BM_FilterRegexRepeatedValues(benchmark::State& state) {
+    filter(
+        state,
+        {{evlist::Filter::CAPABILITIES, "EV_(ABS|MSC)"},
+         {evlist::Filter::NAME, "(USB|Synaptics).* [0-7]$"}},
+        true
+    );
+}
+BENCHMARK(BM_FilterRegexRepeatedValues);
+
+} // namespace
@@ -0,0 +1,87 @@
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <regex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "common/common.h"
+#include "evlist/search.h"
+
+namespace {
+
+constexpr std::size_t DEVICES{1024};
+
+std::vector<std::string> names() {
+    std::vector<std::string> out{};
+    for (const auto& device : evlist::create_devices(DEVICES)) {
+        out.emplace_back(device.name());
+        out.emplace_back(device.by_id().value_or(""));
+        out.emplace_back(device.by_path().value_or(""));
+    }
+    return out;
+}
+
+template <typename Match>
+void match(benchmark::State& state, Match match) {
+    auto inputs = names();
+    for (auto _ : state) {
+        for (const auto& input : inputs) {
+            benchmark::DoNotOptimize(match(input));
+        }
+    }
+    state.SetItemsProcessed(
+        static_cast<int64_t>(state.iterations() * inputs.size())
+    );
+}
+
+// `find` uses `memchr` for the first character, which is fastest when that
+// character is rare, such as the `R` of `Receiver`, but degrades when it is
+// common, such as the `-` of the separators in by-id and by-path values.
+void BM_Contains(benchmark::State& state, std::string_view substring) {
+    match(state, [&substring](std::string_view input) {
+        return evlist::contains(input, substring);
+    });
+}
+
+void BM_Find(benchmark::State& state, std::string_view substring) {
+    match(state, [&substring](std::string_view input) {
+        return input.find(substring) != std::string_view::npos;
+    });
+}
+
+void BM_Regex(benchmark::State& state, std::string_view substring) {
+    const std::regex regex{std::string{substring}};
+    match(state, [&regex](const std::string& input) {
+        return std::regex_search(input, regex);
+    });
+}
+
+BENCHMARK_CAPTURE(BM_Contains, rare, "Receiver");
+BENCHMARK_CAPTURE(BM_Find, rare, "Receiver");
+BENCHMARK_CAPTURE(BM_Regex, rare, "Receiver");
+BENCHMARK_CAPTURE(BM_Contains, common, "-event-kbd");
+BENCHMARK_CAPTURE(BM_Find, common, "-event-kbd");
+BENCHMARK_CAPTURE(BM_Regex, common, "-event-kbd");
+
+void BM_EqualsIgnoreCaseSearch(benchmark::State& state) {
+    match(state, [](std::string_view input) {
+        return evlist::equals_ignore_case(
+            input, "at translated set 2 keyboard 5"
+        );
+    });
+}
+BENCHMARK(BM_EqualsIgnoreCaseSearch);
+
+void BM_EqualsIgnoreCaseRegex(benchmark::State& state) {
+    const std::regex regex{
+        "^at translated set 2 keyboard 5$", std::regex::icase
+    };
+    match(state, [&regex](const std::string& input) {
+        return std::regex_search(input, regex);
+    });
+}
+BENCHMARK(BM_EqualsIgnoreCaseRegex);
+
+} // namespace
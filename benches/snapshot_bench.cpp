@@ -0,0 +1,120 @@
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+#include "common/common.h"
+#include "evlist/device.h"
+#include "evlist/snapshot.h"
+
+namespace {
+
+constexpr std::size_t DEVICES{64};
+
+evlist::InputDevices create_devices() {
+    return evlist::InputDevices{evlist::create_devices(DEVICES)};
+}
+
+/**
+ * The mutex guarded pointer which the snapshot replaces.
+ */
+class MutexSnapshot {
+public:
+    [[nodiscard]] std::shared_ptr<const evlist::InputDevices> load() const {
+        const std::lock_guard lock{mutex_};
+        return devices_;
+    }
+
+    void publish(evlist::InputDevices devices) {
+        auto snapshot =
+            std::make_shared<const evlist::InputDevices>(std::move(devices));
+        const std::lock_guard lock{mutex_};
+        devices_ = std::move(snapshot);
+    }
+
+private:
+    mutable std::mutex mutex_;
+    std::shared_ptr<const evlist::InputDevices> devices_{
+        std::make_shared<const evlist::InputDevices>(create_devices())
+    };
+};
+
+#ifdef __cpp_lib_atomic_shared_ptr
+/**
+ * `std::atomic<std::shared_ptr>`, which is not wait-free in libstdc++ and not
+ * available in libc++.
+ */
+class AtomicSnapshot {
+public:
+    [[nodiscard]] std::shared_ptr<const evlist::InputDevices> load() const {
+        return devices_.load();
+    }
+
+    void publish(evlist::InputDevices devices) {
+        devices_.store(
+            std::make_shared<const evlist::InputDevices>(std::move(devices))
+        );
+    }
+
+private:
+    std::atomic<std::shared_ptr<const evlist::InputDevices>> devices_{
+        std::make_shared<const evlist::InputDevices>(create_devices())
+    };
+};
+#endif
+
+template <typename Snapshot>
+Snapshot& shared() {
+    static Snapshot snapshot{};
+    return snapshot;
+}
+
+template <>
+evlist::InputDevicesSnapshot& shared() {
+    static evlist::InputDevicesSnapshot snapshot{create_devices()};
+    return snapshot;
+}
+
+// Every thread reads the shared snapshot.
+template <typename Snapshot>
+void BM_Load(benchmark::State& state) {
+    auto& snapshot = shared<Snapshot>();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(snapshot.load()->devices().size());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+
+// The first thread repeatedly publishes new snapshots while the others read,
+// and only reads are counted.
+template <typename Snapshot>
+void BM_LoadWhilePublishing(benchmark::State& state) {
+    auto& snapshot = shared<Snapshot>();
+    if (state.thread_index() == 0) {
+        auto devices = create_devices();
+        for (auto _ : state) {
+            snapshot.publish(devices);
+        }
+        return;
+    }
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(snapshot.load()->devices().size());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+
+} // namespace
+
+BENCHMARK(BM_Load<evlist::InputDevicesSnapshot>)->ThreadRange(1, 8);
+BENCHMARK(BM_Load<MutexSnapshot>)->ThreadRange(1, 8);
+BENCHMARK(BM_LoadWhilePublishing<evlist::InputDevicesSnapshot>)
+    ->ThreadRange(2, 8);
+BENCHMARK(BM_LoadWhilePublishing<MutexSnapshot>)->ThreadRange(2, 8);
+#ifdef __cpp_lib_atomic_shared_ptr
+BENCHMARK(BM_Load<AtomicSnapshot>)->ThreadRange(1, 8);
+BENCHMARK(BM_LoadWhilePublishing<AtomicSnapshot>)->ThreadRange(2, 8);
+#endif
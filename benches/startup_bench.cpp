@@ -0,0 +1,63 @@
+#include <benchmark/benchmark.h>
+#include <fcntl.h>
+#include <spawn.h>
+#include <sys/wait.h>
+
+#include <string>
+#include <vector>
+
+#ifndef EVLIST_BINARY
+#define EVLIST_BINARY "evlist"
+#endif
+
+namespace {
+
+/**
+ * Measure the time from `exec` to exit of the `evlist` binary, with output
+ * discarded, which is dominated by startup for short listings.
+ */
+void exec(benchmark::State& state, std::vector<std::string> args) {
+    args.insert(args.begin(), EVLIST_BINARY);
+    std::vector<char*> argv{};
+    for (auto& arg : args) {
+        argv.emplace_back(arg.data());
+    }
+    argv.emplace_back(nullptr);
+
+    posix_spawn_file_actions_t actions{};
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_addopen(
+        &actions, STDOUT_FILENO, "/dev/null", O_WRONLY, 0
+    );
+    posix_spawn_file_actions_addopen(
+        &actions, STDERR_FILENO, "/dev/null", O_WRONLY, 0
+    );
+
+    for (auto _ : state) {
+        pid_t pid{};
+        if (posix_spawnp(
+                &pid, argv.front(), &actions, nullptr, argv.data(), environ
+            ) != 0) {
+            state.SkipWithError("failed to spawn " EVLIST_BINARY);
+            break;
+        }
+        int status{};
+        waitpid(pid, &status, 0);
+    }
+
+    posix_spawn_file_actions_destroy(&actions);
+}
+
+} // namespace
+
+// Startup is measured in wall time, since the benchmark itself only waits.
+BENCHMARK_CAPTURE(exec, NoArguments, {})
+    ->Unit(benchmark::kMicrosecond)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(exec, CommonOptions, {"--format", "csv", "-f", "name*=a"})
+    ->Unit(benchmark::kMicrosecond)
+    ->UseRealTime();
+// Options other than the common ones are parsed by the full parser.
+BENCHMARK_CAPTURE(exec, FullParser, {"--limit", "1"})
+    ->Unit(benchmark::kMicrosecond)
+    ->UseRealTime();
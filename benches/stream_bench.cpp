@@ -0,0 +1,106 @@
+#include <benchmark/benchmark.h>
+#include <unistd.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <format>
+#include <fstream>
+
+#include "evlist/list.h"
+
+namespace fs = std::filesystem;
+
+namespace {
+
+/**
+ * A directory of devices which stand in for device nodes using `/dev/null`,
+ * with names in a sysfs directory.
+ */
+class Devices {
+public:
+    explicit Devices(std::size_t count)
+        : root_{
+              fs::temp_directory_path() /
+              std::format("evlist_{}_stream_bench_{}", getpid(), count)
+          } {
+        fs::create_directories(root_ / "input");
+        for (std::size_t i = 0; i < count; i++) {
+            auto device = std::format("event{}", i);
+            fs::create_directories(root_ / "sys" / device / "device");
+            fs::create_symlink("/dev/null", root_ / "input" / device);
+            std::ofstream{root_ / "sys" / device / "device/name"} << device;
+        }
+    }
+
+    Devices(const Devices&) = delete;
+    Devices(Devices&&) = delete;
+    Devices& operator=(const Devices&) = delete;
+    Devices& operator=(Devices&&) = delete;
+    ~Devices() { fs::remove_all(root_); }
+
+    [[nodiscard]] evlist::InputDeviceLister lister() const {
+        return evlist::InputDeviceLister{}
+            .with_input_directory(root_ / "input")
+            .with_sys_class(root_ / "sys");
+    }
+
+private:
+    fs::path root_;
+};
+
+// The time until the first device is available when listing every device.
+void BM_FirstDeviceList(benchmark::State& state) {
+    const Devices devices{static_cast<std::size_t>(state.range(0))};
+    auto lister = devices.lister();
+    for (auto _ : state) {
+        auto listed = lister.list_input_devices();
+        benchmark::DoNotOptimize(listed->devices().front());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+
+// The time until the first device is available when streaming, where the
+// stream is destroyed outside of the timed region.
+void BM_FirstDeviceStream(benchmark::State& state) {
+    const Devices devices{static_cast<std::size_t>(state.range(0))};
+    auto lister = devices.lister();
+    for (auto _ : state) {
+        auto stream = lister.stream_input_devices();
+        benchmark::DoNotOptimize(stream.next());
+        state.PauseTiming();
+        while (stream.next().value().has_value()) {
+        }
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+
+// The time to stream every device, compared to listing them.
+void BM_AllDevicesStream(benchmark::State& state) {
+    const Devices devices{static_cast<std::size_t>(state.range(0))};
+    auto lister = devices.lister();
+    for (auto _ : state) {
+        auto stream = lister.stream_input_devices();
+        while (auto device = stream.next().value()) {
+            benchmark::DoNotOptimize(device);
+        }
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+
+} // namespace
+
+// Probes finish on other threads, so the benchmarks are measured in wall time.
+BENCHMARK(BM_FirstDeviceList)
+    ->Range(8, 256)
+    ->Unit(benchmark::kMicrosecond)
+    ->UseRealTime();
+BENCHMARK(BM_FirstDeviceStream)
+    ->Range(8, 256)
+    ->Unit(benchmark::kMicrosecond)
+    ->UseRealTime();
+BENCHMARK(BM_AllDevicesStream)
+    ->Range(8, 256)
+    ->Unit(benchmark::kMicrosecond)
+    ->UseRealTime();
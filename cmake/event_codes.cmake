@@ -0,0 +1,40 @@
+# ~~~
+# Generate the event code table used by `src/codes.cpp` from `linux/input-event-codes.h`. Each code is written
+# as `EVLIST_EVENT_CODE(TYPE, NAME, ALIAS)` so that the compiler resolves the value of the macro, and the table
+# always matches the kernel headers that evlist is compiled against. `ALIAS` is true if the code is defined in
+# terms of another code, such as `BTN_A`.
+#
+# Usage:
+# cmake -DINPUT=/usr/include/linux/input-event-codes.h -DOUTPUT=event_codes.inc -P event_codes.cmake
+# ~~~
+
+if(NOT DEFINED INPUT OR NOT DEFINED OUTPUT)
+    message(FATAL_ERROR "INPUT and OUTPUT must be defined")
+endif()
+
+set(EVENT_CODE_PREFIXES "EV|KEY|BTN|REL|ABS|SW|LED|MSC|SND|INPUT_PROP")
+file(STRINGS "${INPUT}" DEFINES REGEX "^#define[ \t]+(${EVENT_CODE_PREFIXES})_[A-Z0-9_]+[ \t]")
+
+set(CONTENT "// Generated by cmake/event_codes.cmake from ${INPUT}, do not edit.\n")
+foreach(DEFINE IN LISTS DEFINES)
+    string(REGEX MATCH "^#define[ \t]+((${EVENT_CODE_PREFIXES})_[A-Z0-9_]+)[ \t]+([^ \t]+)" _ "${DEFINE}")
+    set(NAME "${CMAKE_MATCH_1}")
+    set(TYPE "${CMAKE_MATCH_2}")
+    set(ALIAS false)
+    if(CMAKE_MATCH_3 MATCHES "^[A-Z]")
+        set(ALIAS true)
+    endif()
+
+    # The `_CNT` values are one past the maximum code, so they are not codes themselves.
+    if(NAME MATCHES "_CNT$")
+        continue()
+    endif()
+    # Buttons share the key code space.
+    if(TYPE STREQUAL "BTN")
+        set(TYPE "KEY")
+    endif()
+
+    string(APPEND CONTENT "EVLIST_EVENT_CODE(${TYPE}, ${NAME}, ${ALIAS})\n")
+endforeach()
+
+file(WRITE "${OUTPUT}" "${CONTENT}")
@@ -24,6 +24,8 @@ class EvListRecipe(ConanFile):
         "build_bin": [True, False],
         # Whether to build test executables.
         "build_testing": [True, False],
+        # Whether to build the benchmark executable.
+        "build_benchmarks": [True, False],
         # Whether to run clang tidy.
         "run_clang_tidy": [True, False],
         # An optional clang tidy executable.
@@ -46,6 +48,7 @@ class EvListRecipe(ConanFile):
     default_options = {
         "build_bin": True,
         "build_testing": False,
+        "build_benchmarks": False,
         "run_clang_tidy": False,
         "clang_tidy_executable": None,
         "compiler_launcher": None,
@@ -55,6 +58,10 @@ class EvListRecipe(ConanFile):
         "verify_headers": False,
     }
 
+    def build_requirements(self):
+        if self.options.build_benchmarks:
+            self.test_requires("benchmark/[^1]")
+
     def validate(self):
         if self.settings.compiler.cppstd:
             check_min_cppstd(self, 23)
@@ -64,6 +71,7 @@ class EvListRecipe(ConanFile):
 
         tc.variables["EVLIST_BUILD_BIN"] = self.options.build_bin
         tc.variables["BUILD_TESTING"] = self.options.build_testing
+        tc.variables["EVLIST_BUILD_BENCHMARKS"] = self.options.build_benchmarks
         tc.variables["EVLIST_RUN_CLANG_TIDY"] = self.options.run_clang_tidy
         tc.variables["EVLIST_INSTALL_BIN"] = self.options.install_bin
         tc.variables["EVLIST_INSTALL_LIB"] = self.options.install_lib
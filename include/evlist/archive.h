@@ -0,0 +1,631 @@
+/**
+ * @file archive.h
+ *
+ * Contains definitions for a compressed columnar archive of recorded input
+ * events, and for querying archives.
+ */
+
+#ifndef EVLIST_ARCHIVE_H
+#define EVLIST_ARCHIVE_H
+
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <filesystem>
+#include <format>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+#include "evlist/cli.h"
+#include "evlist/codes.h"
+#include "evlist/device.h"
+#include "evlist/format.h"
+#include "evlist/record.h"
+
+/**
+ * The namespace for this project.
+ */
+namespace evlist {
+
+/**
+ * The index entry of a block of events from a single device. Blocks can be
+ * skipped without decoding them if the range of their values does not match
+ * a query.
+ */
+struct ArchiveBlock {
+    /**
+     * The index of the device in the archive.
+     */
+    uint32_t device;
+    /**
+     * The number of events in the block.
+     */
+    uint32_t events;
+    /**
+     * The minimum timestamp in microseconds.
+     */
+    int64_t min_time;
+    /**
+     * The maximum timestamp in microseconds.
+     */
+    int64_t max_time;
+    /**
+     * The minimum event type.
+     */
+    uint16_t min_type;
+    /**
+     * The maximum event type.
+     */
+    uint16_t max_type;
+    /**
+     * The minimum event code.
+     */
+    uint16_t min_code;
+    /**
+     * The maximum event code.
+     */
+    uint16_t max_code;
+    /**
+     * The encoded size in bytes of the timestamp, type, code and value
+     * columns.
+     */
+    std::array<uint32_t, 4> sizes;
+};
+
+static_assert(sizeof(ArchiveBlock) == 48);
+
+/**
+ * The events of a decoded block stored as columns.
+ */
+struct ArchiveColumns {
+    /**
+     * Timestamps in microseconds.
+     */
+    std::vector<int64_t> times;
+    /**
+     * Event types.
+     */
+    std::vector<uint16_t> types;
+    /**
+     * Event codes.
+     */
+    std::vector<uint16_t> codes;
+    /**
+     * Event values.
+     */
+    std::vector<int32_t> values;
+    /**
+     * Storage for varints before they are transformed into a column.
+     */
+    std::vector<uint64_t> varints;
+};
+
+/**
+ * A query over the events in an archive. Each set filter must match for an
+ * event to be selected.
+ */
+struct ArchiveQuery {
+    /**
+     * Only select events from this device index.
+     */
+    std::optional<uint32_t> device;
+    /**
+     * Only select events at or after this time in microseconds.
+     */
+    std::optional<int64_t> from;
+    /**
+     * Only select events before this time in microseconds.
+     */
+    std::optional<int64_t> to;
+    /**
+     * Only select events with this type.
+     */
+    std::optional<uint16_t> type;
+    /**
+     * Only select events with this code.
+     */
+    std::optional<uint16_t> code;
+
+    /**
+     * Parse a query from `KEY=VALUE` filters, where each key is one of:
+     * - `device`: the device path or device index
+     * - `from`, `to`: a time in seconds since the epoch
+     * - `type`: an event type name such as `EV_KEY`, or a number
+     * - `code`: an event code name such as `KEY_A`, or a number. A code name
+     *   also sets the type if it is not specified.
+     *
+     * @param filters the filters
+     * @param devices the devices in the archive, used to resolve paths
+     * @return the query or an error message
+     */
+    [[nodiscard]] static std::expected<ArchiveQuery, std::string> parse(
+        const std::vector<std::string>& filters,
+        const std::vector<InputDevice>& devices
+    );
+
+    /**
+     * Whether a block cannot contain any selected events, based on its index
+     * entry.
+     *
+     * @param block the block index entry
+     * @return whether the block can be skipped
+     */
+    [[nodiscard]] bool skip(const ArchiveBlock& block) const;
+};
+
+/**
+ * A columnar archive of recorded events. Events are grouped by device into
+ * fixed-size blocks, where each block stores its timestamps, types, codes and
+ * values as separate delta and varint encoded columns.
+ */
+class EventArchive {
+public:
+    /**
+     * The magic bytes identifying an archive.
+     */
+    static constexpr std::array<char, 8> MAGIC{
+        'E', 'V', 'L', 'I', 'S', 'T', 'A', 'R'
+    };
+
+    /**
+     * The current version of the archive format.
+     */
+    static constexpr uint32_t VERSION{1};
+
+    /**
+     * The default maximum number of events in a block.
+     */
+    static constexpr std::size_t BLOCK_SIZE{4096};
+
+    /**
+     * Encode events into an archive.
+     *
+     * @param devices the devices, in the order of their device index
+     * @param records the events, from oldest to newest
+     * @param block_size the maximum number of events in a block
+     * @return the encoded archive
+     */
+    [[nodiscard]] static std::string encode(
+        const std::vector<InputDevice>& devices,
+        std::span<const EventRecord> records,
+        std::size_t block_size = BLOCK_SIZE
+    );
+
+    /**
+     * Decode an archive.
+     *
+     * @param bytes the encoded archive
+     * @return the archive or an error if it is not a valid archive
+     */
+    [[nodiscard]] static std::expected<EventArchive, std::system_error>
+    decode(std::string bytes);
+
+    /**
+     * Write events to an archive file, replacing any existing file.
+     *
+     * @param path the path of the archive
+     * @param devices the devices, in the order of their device index
+     * @param records the events, from oldest to newest
+     * @return an error if the file could not be written
+     */
+    static std::expected<void, std::system_error> write(
+        const fs::path& path,
+        const std::vector<InputDevice>& devices,
+        std::span<const EventRecord> records
+    );
+
+    /**
+     * Open an archive file.
+     *
+     * @param path the path of the archive
+     * @return the archive or an error if the file could not be read or is not
+     *         a valid archive
+     */
+    [[nodiscard]] static std::expected<EventArchive, std::system_error> open(
+        const fs::path& path
+    );
+
+    /**
+     * Get the archived devices, in the order of their device index.
+     *
+     * @return archived devices
+     */
+    [[nodiscard]] const std::vector<InputDevice>& devices() const;
+
+    /**
+     * Get the block index.
+     *
+     * @return block index entries
+     */
+    [[nodiscard]] const std::vector<ArchiveBlock>& blocks() const;
+
+    /**
+     * Decode the columns of a block.
+     *
+     * @param block the index of the block
+     * @param columns the columns to decode into, reusing their storage
+     */
+    void columns(std::size_t block, ArchiveColumns& columns) const;
+
+    /**
+     * Scan the archive, skipping blocks using the index and filtering the
+     * decoded columns of the remaining blocks.
+     *
+     * @param query the query
+     * @param on_events called with the selected events of each block, where
+     *        the events are only valid for the duration of the call
+     * @return the number of selected events
+     */
+    std::size_t scan(
+        const ArchiveQuery& query,
+        std::invocable<std::span<const EventRecord>> auto on_events
+    ) const;
+
+    /**
+     * Get all selected events, ordered by device and then time.
+     *
+     * @param query the query
+     * @return the selected events
+     */
+    [[nodiscard]] std::vector<EventRecord> query(const ArchiveQuery& query
+    ) const;
+
+private:
+    EventArchive(
+        std::string bytes,
+        std::vector<InputDevice> devices,
+        std::vector<ArchiveBlock> blocks,
+        std::vector<std::size_t> offsets
+    );
+
+    std::string bytes_;
+    std::vector<InputDevice> devices_;
+    std::vector<ArchiveBlock> blocks_;
+    std::vector<std::size_t> offsets_;
+
+    static std::size_t select(
+        const ArchiveQuery& query,
+        const ArchiveColumns& columns,
+        std::vector<uint8_t>& selected
+    );
+};
+
+std::size_t EventArchive::scan(
+    const ArchiveQuery& query,
+    std::invocable<std::span<const EventRecord>> auto on_events
+) const {
+    ArchiveColumns decoded{};
+    std::vector<uint8_t> selected{};
+    std::vector<EventRecord> records{};
+
+    std::size_t total = 0;
+    for (std::size_t block = 0; block < blocks_.size(); block++) {
+        if (query.skip(blocks_[block])) {
+            continue;
+        }
+
+        columns(block, decoded);
+        if (select(query, decoded, selected) == 0) {
+            continue;
+        }
+
+        records.clear();
+        for (std::size_t i = 0; i < selected.size(); i++) {
+            if (selected[i] == 0) {
+                continue;
+            }
+
+            constexpr int64_t MICROSECONDS{1'000'000};
+            records.emplace_back(EventRecord{
+                .seconds = decoded.times[i] / MICROSECONDS,
+                .microseconds = decoded.times[i] % MICROSECONDS,
+                .device = blocks_[block].device,
+                .type = decoded.types[i],
+                .code = decoded.codes[i],
+                .value = decoded.values[i],
+                .reserved = 0
+            });
+        }
+
+        on_events(std::span<const EventRecord>{records});
+        total += records.size();
+    }
+
+    return total;
+}
+
+/**
+ * Selected events from an archive, for formatting.
+ */
+class ArchiveEvents {
+public:
+    /**
+     * The name of the header for the device path.
+     */
+    static constexpr std::string_view HEADER_DEVICE_PATH =
+        InputDevices::HEADER_DEVICE_PATH;
+
+    /**
+     * The name of the header for the timestamp.
+     */
+    static constexpr std::string_view HEADER_TIME = "TIME";
+
+    /**
+     * The name of the header for the event type.
+     */
+    static constexpr std::string_view HEADER_TYPE = "TYPE";
+
+    /**
+     * The name of the header for the event code.
+     */
+    static constexpr std::string_view HEADER_CODE = "CODE";
+
+    /**
+     * The name of the header for the event value.
+     */
+    static constexpr std::string_view HEADER_VALUE = "VALUE";
+
+    /**
+     * Create the archive events.
+     *
+     * @param output_format the output format
+     * @param devices the devices in the archive
+     * @param records the selected events
+     */
+    ArchiveEvents(
+        Format output_format,
+        std::vector<InputDevice> devices,
+        std::vector<EventRecord> records
+    );
+
+    /**
+     * Get the devices in the archive.
+     *
+     * @return devices
+     */
+    [[nodiscard]] const std::vector<InputDevice>& devices() const;
+
+    /**
+     * Get the selected events.
+     *
+     * @return events
+     */
+    [[nodiscard]] const std::vector<EventRecord>& records() const;
+
+    /**
+     * Get the output format.
+     *
+     * @return output format
+     */
+    [[nodiscard]] Format output_format() const;
+
+private:
+    Format output_format_{Format::TABLE};
+    std::vector<InputDevice> devices_;
+    std::vector<EventRecord> records_;
+};
+
+/**
+ * The number and rate of selected events per device in an archive.
+ */
+class ArchiveSummary {
+public:
+    /**
+     * The name of the header for the device path.
+     */
+    static constexpr std::string_view HEADER_DEVICE_PATH =
+        InputDevices::HEADER_DEVICE_PATH;
+
+    /**
+     * The name of the header for the device name.
+     */
+    static constexpr std::string_view HEADER_NAME = InputDevices::HEADER_NAME;
+
+    /**
+     * The name of the header for the number of events.
+     */
+    static constexpr std::string_view HEADER_EVENTS = "EVENTS";
+
+    /**
+     * The name of the header for the time between the first and last event.
+     */
+    static constexpr std::string_view HEADER_SECONDS = "SECONDS";
+
+    /**
+     * The name of the header for the rate of events.
+     */
+    static constexpr std::string_view HEADER_RATE = "EVENTS_PER_SEC";
+
+    /**
+     * Summarise the selected events of an archive.
+     *
+     * @param output_format the output format
+     * @param archive the archive
+     * @param query the query
+     */
+    ArchiveSummary(
+        Format output_format,
+        const EventArchive& archive,
+        const ArchiveQuery& query
+    );
+
+    /**
+     * Get the devices in the archive.
+     *
+     * @return devices
+     */
+    [[nodiscard]] const std::vector<InputDevice>& devices() const;
+
+    /**
+     * Get the number of selected events of a device.
+     *
+     * @param device the device index
+     * @return number of events
+     */
+    [[nodiscard]] uint64_t events(std::size_t device) const;
+
+    /**
+     * Get the time in seconds between the first and last selected event of a
+     * device.
+     *
+     * @param device the device index
+     * @return the duration in seconds
+     */
+    [[nodiscard]] double seconds(std::size_t device) const;
+
+    /**
+     * Get the rate of selected events per second of a device, or zero if
+     * there are less than two events.
+     *
+     * @param device the device index
+     * @return events per second
+     */
+    [[nodiscard]] double rate(std::size_t device) const;
+
+    /**
+     * Get the output format.
+     *
+     * @return output format
+     */
+    [[nodiscard]] Format output_format() const;
+
+private:
+    Format output_format_{Format::TABLE};
+    std::vector<InputDevice> devices_;
+    std::vector<uint64_t> events_;
+    std::vector<int64_t> first_;
+    std::vector<int64_t> last_;
+};
+
+} // namespace evlist
+
+/**
+ * Defines the
+ * [`std:formatter`](https://en.cppreference.com/w/cpp/utility/format/formatter)
+ * for formatting `evlist::ArchiveEvents`. Types and codes are output using
+ * their names when they are defined.
+ */
+template <>
+struct std::formatter<evlist::ArchiveEvents> {
+    /**
+     * Parse the events by beginning a new iterator from the context.
+     *
+     * @param ctx formatting context
+     * @return output iterator
+     */
+    static constexpr auto parse(const std::format_parse_context& ctx) {
+        return ctx.begin();
+    }
+
+    /**
+     * Format the events based on the output `Format`.
+     *
+     * @tparam Context context type
+     * @param events archive events
+     * @param ctx context parameter
+     * @return iterator after formatting
+     */
+    template <typename Context>
+    // NOLINTNEXTLINE(runtime/references)
+    constexpr auto format(const evlist::ArchiveEvents& events, Context& ctx)
+        const {
+        using Row = std::array<std::string, 5>;
+
+        std::vector<Row> rows{};
+        rows.reserve(events.records().size() + 1);
+        rows.emplace_back(Row{
+            std::string{evlist::ArchiveEvents::HEADER_DEVICE_PATH},
+            std::string{evlist::ArchiveEvents::HEADER_TIME},
+            std::string{evlist::ArchiveEvents::HEADER_TYPE},
+            std::string{evlist::ArchiveEvents::HEADER_CODE},
+            std::string{evlist::ArchiveEvents::HEADER_VALUE}
+        });
+        for (const auto& record : events.records()) {
+            auto type =
+                evlist::EventCodes::name(evlist::CodeType::EV, record.type);
+            auto code_type = evlist::EventCodes::code_type(record.type);
+            std::optional<std::string_view> code{};
+            if (code_type.has_value()) {
+                code = evlist::EventCodes::name(*code_type, record.code);
+            }
+
+            rows.emplace_back(Row{
+                events.devices().at(record.device).device_path().string(),
+                std::format("{}.{:06}", record.seconds, record.microseconds),
+                type.has_value() ? std::string{*type}
+                                 : std::format("{}", record.type),
+                code.has_value() ? std::string{*code}
+                                 : std::format("{}", record.code),
+                std::format("{}", record.value)
+            });
+        }
+
+        return evlist::format_rows(ctx, events.output_format(), rows);
+    }
+};
+
+/**
+ * Defines the
+ * [`std:formatter`](https://en.cppreference.com/w/cpp/utility/format/formatter)
+ * for formatting `evlist::ArchiveSummary`.
+ */
+template <>
+struct std::formatter<evlist::ArchiveSummary> {
+    /**
+     * Parse the summary by beginning a new iterator from the context.
+     *
+     * @param ctx formatting context
+     * @return output iterator
+     */
+    static constexpr auto parse(const std::format_parse_context& ctx) {
+        return ctx.begin();
+    }
+
+    /**
+     * Format the summary based on the output `Format`.
+     *
+     * @tparam Context context type
+     * @param summary archive summary
+     * @param ctx context parameter
+     * @return iterator after formatting
+     */
+    template <typename Context>
+    // NOLINTNEXTLINE(runtime/references)
+    constexpr auto format(const evlist::ArchiveSummary& summary, Context& ctx)
+        const {
+        using Row = std::array<std::string, 5>;
+
+        std::vector<Row> rows{};
+        rows.emplace_back(Row{
+            std::string{evlist::ArchiveSummary::HEADER_DEVICE_PATH},
+            std::string{evlist::ArchiveSummary::HEADER_NAME},
+            std::string{evlist::ArchiveSummary::HEADER_EVENTS},
+            std::string{evlist::ArchiveSummary::HEADER_SECONDS},
+            std::string{evlist::ArchiveSummary::HEADER_RATE}
+        });
+        for (std::size_t device = 0; device < summary.devices().size();
+             device++) {
+            if (summary.events(device) == 0) {
+                continue;
+            }
+
+            rows.emplace_back(Row{
+                summary.devices()[device].device_path().string(),
+                summary.devices()[device].name(),
+                std::format("{}", summary.events(device)),
+                std::format("{:.3f}", summary.seconds(device)),
+                std::format("{:.1f}", summary.rate(device))
+            });
+        }
+
+        return evlist::format_rows(ctx, summary.output_format(), rows);
+    }
+};
+
+#endif // EVLIST_ARCHIVE_H
@@ -7,10 +7,16 @@
 #ifndef EVLIST_CLI_H
 #define EVLIST_CLI_H
 
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
 #include <expected>
 #include <format>
-#include <map>
+#include <optional>
+#include <span>
 #include <string>
+#include <string_view>
 #include <utility>
 #include <vector>
 
@@ -32,7 +38,19 @@ enum class Format : uint8_t {
     /**
      * Output using CSV.
      */
-    CSV
+    CSV,
+    /**
+     * Output using tab separated values.
+     */
+    TSV,
+    /**
+     * Output as a JSON array of objects.
+     */
+    JSON,
+    /**
+     * Output as newline delimited JSON, with one object per line.
+     */
+    NDJSON
 };
 
 /**
@@ -58,7 +76,202 @@ enum class Filter : uint8_t {
     /**
      * Filter by the device capabilities.
      */
-    CAPABILITIES
+    CAPABILITIES,
+    /**
+     * Filter by the sysfs name of the parent input device, such as `input3`.
+     */
+    PARENT,
+    /**
+     * Filter by the vendor id of the parent input device.
+     */
+    VENDOR,
+    /**
+     * Filter by the product id of the parent input device.
+     */
+    PRODUCT,
+    /**
+     * Filter by the bus type of the parent input device.
+     */
+    BUS,
+    /**
+     * Filter by the physical path of the parent input device.
+     */
+    PHYS,
+    /**
+     * Filter by the unique identifier of the parent input device.
+     */
+    UNIQ
+};
+
+/**
+ * The name of each `Filter` as it is written on the command line.
+ */
+inline constexpr std::array<std::pair<std::string_view, Filter>, 11>
+    FILTER_NAMES{{
+        {"device_path", Filter::DEVICE_PATH},
+        {"name", Filter::NAME},
+        {"by_id", Filter::BY_ID},
+        {"by_path", Filter::BY_PATH},
+        {"capabilities", Filter::CAPABILITIES},
+        {"parent", Filter::PARENT},
+        {"vendor", Filter::VENDOR},
+        {"product", Filter::PRODUCT},
+        {"bus", Filter::BUS},
+        {"phys", Filter::PHYS},
+        {"uniq", Filter::UNIQ},
+    }};
+
+/**
+ * The name of each `Format` as it is written on the command line.
+ */
+inline constexpr std::array<std::pair<std::string_view, Format>, 5>
+    FORMAT_NAMES{{
+        {"table", Format::TABLE},
+        {"csv", Format::CSV},
+        {"tsv", Format::TSV},
+        {"json", Format::JSON},
+        {"ndjson", Format::NDJSON},
+    }};
+
+/**
+ * Get a value by its name in a table of names, ignoring ASCII case.
+ *
+ * @tparam T the type of the value
+ * @tparam N the number of names
+ * @param names the table of names
+ * @param name the name
+ * @return the value, or nothing if the name is unknown
+ */
+template <typename T, std::size_t N>
+constexpr std::optional<T> from_name(
+    const std::array<std::pair<std::string_view, T>, N>& names,
+    std::string_view name
+) {
+    auto lower = [](char character) {
+        return character >= 'A' && character <= 'Z'
+                   ? static_cast<char>(character - 'A' + 'a')
+                   : character;
+    };
+
+    for (const auto& [value_name, value] : names) {
+        if (std::ranges::equal(
+                value_name, name, {}, {}, [&lower](char character) {
+                    return lower(character);
+                }
+            )) {
+            return value;
+        }
+    }
+    return {};
+}
+
+/**
+ * Get a `Filter` by its name in `FILTER_NAMES`, ignoring ASCII case.
+ *
+ * @param name the name
+ * @return the filter, or nothing if the name is unknown
+ */
+constexpr std::optional<Filter> filter_from_name(std::string_view name) {
+    return from_name(FILTER_NAMES, name);
+}
+
+/**
+ * Get a `Format` by its name in `FORMAT_NAMES`, ignoring ASCII case.
+ *
+ * @param name the name
+ * @return the format, or nothing if the name is unknown
+ */
+constexpr std::optional<Format> format_from_name(std::string_view name) {
+    return from_name(FORMAT_NAMES, name);
+}
+
+/**
+ * How a filter compares a column value against the filter value.
+ */
+enum class FilterOperator : uint8_t {
+    /**
+     * `KEY=VALUE` matches columns equal to the value, or matching it as a
+     * regex or glob when using `--use-regex` or `--glob`.
+     */
+    EQUAL,
+    /**
+     * `KEY*=VALUE` matches columns which contain the value.
+     */
+    CONTAINS,
+    /**
+     * `KEY^=VALUE` matches columns which start with the value.
+     */
+    PREFIX,
+    /**
+     * `KEY~=VALUE` matches columns equal to the value ignoring ASCII case.
+     */
+    CASE_INSENSITIVE
+};
+
+/**
+ * The operator of each `FilterOperator` as it is written on the command line,
+ * before the `=`.
+ */
+inline constexpr std::array<std::pair<char, FilterOperator>, 3>
+    FILTER_OPERATORS{{
+        {'*', FilterOperator::CONTAINS},
+        {'^', FilterOperator::PREFIX},
+        {'~', FilterOperator::CASE_INSENSITIVE},
+    }};
+
+/**
+ * A single filter such as `name*=logi`, which a device matches if any value
+ * of the column matches.
+ */
+struct FilterTerm {
+    /**
+     * The column to compare.
+     */
+    Filter column;
+    /**
+     * The value to compare against.
+     */
+    std::string value;
+    /**
+     * How the column is compared against the value.
+     */
+    FilterOperator op{FilterOperator::EQUAL};
+
+    bool operator==(const FilterTerm&) const = default;
+};
+
+/**
+ * A named set of filters, such as `keyboards:capabilities=EV_KEY`, which is
+ * evaluated together with other queries in a single pass over devices.
+ */
+struct DeviceQuery {
+    /**
+     * The name of the query, which labels its results.
+     */
+    std::string name;
+    /**
+     * The filters which a device must all match, in the same form as
+     * `--filter`.
+     */
+    std::vector<FilterTerm> filter;
+};
+
+/**
+ * The command to run.
+ */
+enum class Command : uint8_t {
+    /**
+     * List devices, which is the default.
+     */
+    LIST,
+    /**
+     * Convert a recording into an archive.
+     */
+    ARCHIVE,
+    /**
+     * Query an archive.
+     */
+    QUERY
 };
 
 /**
@@ -74,6 +287,8 @@ public:
     /**
      * Parse the CLI, exiting the program if there are any errors. This handles
      * printing messages from `--help` and exiting if there is a parse error.
+     * Common invocations are parsed using `parse_common` without building the
+     * full parser.
      *
      * @param argc argc input argc
      * @param argv argv input argv
@@ -81,6 +296,43 @@ public:
      */
     std::expected<bool, int> parse(int argc, char** argv);
 
+    /**
+     * Parse the arguments of a common invocation without building the full
+     * parser, which is the startup cost of most runs. Only valid uses of
+     * `--format`, `--filter`, `--use-regex`, `--glob`, `--parent` and
+     * `--first` are accepted, and anything else, including errors and
+     * `--help`, is left to the full parser.
+     *
+     * @param args the arguments, excluding the program name
+     * @return the parsed CLI, or nothing if the full parser is needed
+     */
+    [[nodiscard]] static std::optional<Cli> parse_common(
+        std::span<const char* const> args
+    );
+
+    /**
+     * Parse a filter of the form `KEY=VALUE`, where the key is a filter column
+     * such as `name`, optionally followed by an operator in
+     * `FILTER_OPERATORS`, such as `name*=VALUE`.
+     *
+     * @param filter the filter to parse
+     * @return the filter or an error message
+     */
+    [[nodiscard]] static std::expected<FilterTerm, std::string> parse_filter(
+        std::string_view filter
+    );
+
+    /**
+     * Parse a query of the form `NAME:KEY=VALUE,...`, where each key is a
+     * filter column such as `name` and values cannot contain `,`.
+     *
+     * @param query the query to parse
+     * @return the query or an error message
+     */
+    [[nodiscard]] static std::expected<DeviceQuery, std::string> parse_query(
+        std::string_view query
+    );
+
     /**
      * Get the format.
      *
@@ -95,20 +347,163 @@ public:
      */
     [[nodiscard]] bool use_regex() const;
 
+    /**
+     * Get the use glob flag.
+     *
+     * @return use glob flag
+     */
+    [[nodiscard]] bool use_glob() const;
+
     /**
      * Get the filter.
      *
      * @return filter
      */
-    [[nodiscard]] const std::vector<std::pair<Filter, std::string>>&
-    filter() const;
+    [[nodiscard]] const std::vector<FilterTerm>& filter() const;
 
     /**
      * Get the filter, consuming self.
      *
      * @return filter
      */
-    [[nodiscard]] std::vector<std::pair<Filter, std::string>> into_filter() &&;
+    [[nodiscard]] std::vector<FilterTerm> into_filter() &&;
+
+    /**
+     * Get the path to a previous CSV listing to output differences against.
+     *
+     * @return diff against path
+     */
+    [[nodiscard]] const std::optional<std::string>& diff_against() const;
+
+    /**
+     * Get the top flag, which monitors the rate of events of devices.
+     *
+     * @return top flag
+     */
+    [[nodiscard]] bool top() const;
+
+    /**
+     * Get the interval between outputs when monitoring devices.
+     *
+     * @return interval
+     */
+    [[nodiscard]] std::chrono::duration<double> interval() const;
+
+    /**
+     * Get the path of the file to record events into.
+     *
+     * @return record path
+     */
+    [[nodiscard]] const std::optional<std::string>& record() const;
+
+    /**
+     * Get the number of events that fit in the recording ring buffer.
+     *
+     * @return recording capacity
+     */
+    [[nodiscard]] std::size_t capacity() const;
+
+    /**
+     * Get the latency flag, which measures the latency of reading events from
+     * devices.
+     *
+     * @return latency flag
+     */
+    [[nodiscard]] bool latency() const;
+
+    /**
+     * Get the total deadline for probing devices when listing them.
+     *
+     * @return deadline
+     */
+    [[nodiscard]] std::optional<std::chrono::duration<double>> deadline() const;
+
+    /**
+     * Get the maximum number of devices to list, which is one if `--first`
+     * is set.
+     *
+     * @return device limit
+     */
+    [[nodiscard]] std::optional<std::size_t> limit() const;
+
+    /**
+     * Get the boolean filter expression.
+     *
+     * @return filter expression
+     */
+    [[nodiscard]] const std::optional<std::string>& where() const;
+
+    /**
+     * Get the named queries to evaluate in a single pass over the devices.
+     *
+     * @return queries
+     */
+    [[nodiscard]] const std::vector<DeviceQuery>& queries() const;
+
+    /**
+     * Get the parent flag, which outputs the attributes of the parent input
+     * device of each device.
+     *
+     * @return parent flag
+     */
+    [[nodiscard]] bool parent() const;
+
+    /**
+     * Get the column to count devices by instead of listing them.
+     *
+     * @return group by column
+     */
+    [[nodiscard]] std::optional<Filter> group_by() const;
+
+    /**
+     * Get the socket path to serve device queries on.
+     *
+     * @return serve socket path
+     */
+    [[nodiscard]] const std::optional<std::string>& serve() const;
+
+    /**
+     * Get the socket path of a server to query devices from.
+     *
+     * @return connect socket path
+     */
+    [[nodiscard]] const std::optional<std::string>& connect() const;
+
+    /**
+     * Get the command to run.
+     *
+     * @return command
+     */
+    [[nodiscard]] Command command() const;
+
+    /**
+     * Get the path of the recording to convert into an archive.
+     *
+     * @return recording path
+     */
+    [[nodiscard]] const std::string& recording() const;
+
+    /**
+     * Get the path of the archive to create or query.
+     *
+     * @return archive path
+     */
+    [[nodiscard]] const std::string& archive() const;
+
+    /**
+     * Get the `KEY=VALUE` filters of an archive query.
+     *
+     * @return query filters
+     */
+    [[nodiscard]] const std::vector<std::string>& query() const;
+
+    /**
+     * Get the summary flag, which outputs the rate of queried events instead
+     * of the events.
+     *
+     * @return summary flag
+     */
+    [[nodiscard]] bool summary() const;
 
 private:
     static constexpr uint8_t INDENT_BY{30};
@@ -116,53 +511,40 @@ private:
     static constexpr uint8_t FILTER_INDENT_BY{5};
 
     Format format_{Format::TABLE};
-    std::map<Format, std::string> format_descriptions_{format_descriptions()};
-
-    std::vector<std::pair<Filter, std::string>> filter_;
-    std::map<Filter, std::string> filter_descriptions_{filter_descriptions()};
-
+    std::vector<FilterTerm> filter_;
     bool use_regex_{false};
+    bool use_glob_{false};
+    std::optional<std::string> diff_against_;
+    bool top_{false};
+    double interval_{1.0};
+    std::optional<std::string> record_;
+    std::size_t capacity_{std::size_t{1} << 20U};
+    bool latency_{false};
+    std::optional<double> deadline_;
+    std::optional<std::size_t> limit_;
+    bool first_{false};
+    bool parent_{false};
+    std::optional<Filter> group_by_;
+    std::optional<std::string> serve_;
+    std::optional<std::string> connect_;
+    std::vector<DeviceQuery> queries_;
+    std::optional<std::string> where_;
+    Command command_{Command::LIST};
+    std::string recording_;
+    std::string archive_;
+    std::vector<std::string> query_;
+    bool summary_{false};
 
-    static std::map<std::string, Format> format_mappings();
-    static std::map<Format, std::string> format_descriptions();
-
-    static std::map<std::string, Filter> filter_mappings();
-    static std::map<Filter, std::string> filter_descriptions();
+    std::expected<bool, int> parse_full(int argc, char** argv);
 
-    template <typename T>
     static std::string format_enum(
-        const std::string& value_descriptor,
-        const std::string& enum_description,
+        std::string_view value_descriptor,
+        std::string_view enum_description,
         uint8_t first_ident,
-        const std::map<T, std::string>& descriptions
+        std::span<const std::string_view> descriptions
     );
 };
 
-template <typename T>
-std::string Cli::format_enum(
-    const std::string& value_descriptor,
-    const std::string& enum_description,
-    uint8_t first_ident,
-    const std::map<T, std::string>& descriptions
-) {
-    auto out_description = std::format(
-        "<{}>{: <{}}{}\n\n{: <{}}Possible values:\n",
-        value_descriptor,
-        "",
-        first_ident,
-        enum_description,
-        "",
-        INDENT_BY
-    );
-    for (const auto& [_ignored, description] : descriptions) {
-        out_description.append(
-            std::format("{: <{}}{}\n", "", INDENT_BY, description)
-        );
-    }
-
-    return out_description;
-}
-
 } // namespace evlist
 
 #endif // EVLIST_CLI_H
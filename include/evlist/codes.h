@@ -0,0 +1,149 @@
+/**
+ * @file codes.h
+ *
+ * Contains lookup tables for the input event codes defined in
+ * `linux/input-event-codes.h`.
+ */
+
+#ifndef EVLIST_CODES_H
+#define EVLIST_CODES_H
+
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+/**
+ * The namespace for this project.
+ */
+namespace evlist {
+
+/**
+ * The type of an input event code, which corresponds to the prefix of the
+ * code name.
+ */
+enum class CodeType : uint8_t {
+    /**
+     * Event types, such as `EV_KEY`.
+     */
+    EV,
+    /**
+     * Keys and buttons, such as `KEY_A` and `BTN_LEFT`.
+     */
+    KEY,
+    /**
+     * Relative axes, such as `REL_X`.
+     */
+    REL,
+    /**
+     * Absolute axes, such as `ABS_X`.
+     */
+    ABS,
+    /**
+     * Switches, such as `SW_LID`.
+     */
+    SW,
+    /**
+     * LEDs, such as `LED_CAPSL`.
+     */
+    LED,
+    /**
+     * Miscellaneous events, such as `MSC_SCAN`.
+     */
+    MSC,
+    /**
+     * Sounds, such as `SND_BELL`.
+     */
+    SND,
+    /**
+     * Device properties, such as `INPUT_PROP_POINTER`.
+     */
+    INPUT_PROP
+};
+
+/**
+ * An input event code and its type.
+ */
+struct EventCode {
+    /**
+     * The type of the code.
+     */
+    CodeType type;
+    /**
+     * The value of the code.
+     */
+    uint16_t code;
+
+    /**
+     * Compare equality by the type and code.
+     *
+     * @param other compare to
+     * @return whether the codes are equal
+     */
+    bool operator==(const EventCode& other) const = default;
+};
+
+/**
+ * Lookup names and values of input event codes. The tables are generated
+ * from `linux/input-event-codes.h` at build time and constructed at compile
+ * time, so lookups do not allocate or require any startup work.
+ */
+class EventCodes {
+public:
+    /**
+     * Get the name of a code using an array lookup. If multiple names share
+     * the same code, such as `BTN_SOUTH` and `BTN_A`, then the specific name
+     * is preferred over aliases and range markers like `BTN_GAMEPAD`.
+     *
+     * @param type the type of the code
+     * @param code the code value
+     * @return the code name, or an empty optional if the code is not defined
+     */
+    [[nodiscard]] static std::optional<std::string_view> name(
+        CodeType type, uint16_t code
+    ) noexcept;
+
+    /**
+     * Get the type and value of a code name using a perfect hash. All names
+     * are recognised, including aliases.
+     *
+     * @param name the code name, such as `KEY_A`
+     * @return the code, or an empty optional if the name is not defined
+     */
+    [[nodiscard]] static std::optional<EventCode> code(std::string_view name
+    ) noexcept;
+
+    /**
+     * Get the number of codes of a type, which is the `_CNT` value such as
+     * `KEY_CNT`.
+     *
+     * @param type the type of the code
+     * @return the number of codes
+     */
+    [[nodiscard]] static uint16_t count(CodeType type) noexcept;
+
+    /**
+     * Get the type of the codes used by events of an event type, such as
+     * `CodeType::KEY` for `EV_KEY`.
+     *
+     * @param event_type the event type
+     * @return the code type, or an empty optional if the event type does not
+     *         have named codes
+     */
+    [[nodiscard]] static std::optional<CodeType> code_type(uint16_t event_type
+    ) noexcept;
+
+    /**
+     * Get the event type of a code type, such as `EV_KEY` for
+     * `CodeType::KEY`.
+     *
+     * @param type the code type
+     * @return the event type, or an empty optional if the code type is not
+     *         used by events
+     */
+    [[nodiscard]] static std::optional<uint16_t> event_type(CodeType type
+    ) noexcept;
+};
+
+} // namespace evlist
+
+#endif // EVLIST_CODES_H
@@ -0,0 +1,196 @@
+/**
+ * @file daemon.h
+ *
+ * Contains definitions for serving queries of cached input devices to local
+ * clients over a Unix domain socket.
+ */
+
+#ifndef EVLIST_DAEMON_H
+#define EVLIST_DAEMON_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+#include "evlist/cli.h"
+#include "evlist/device.h"
+#include "evlist/events.h"
+#include "evlist/snapshot.h"
+
+/**
+ * The namespace for this project.
+ */
+namespace evlist {
+
+/**
+ * A query for devices sent from a `DeviceClient` to a `DeviceServer`.
+ *
+ * Messages in both directions are framed by a 32-bit length in host byte
+ * order, since both ends run on the same host. A request is encoded as the
+ * format, a byte of flags, and then each filter as its column, operator,
+ * a 32-bit value length and the value. A response is a status byte followed
+ * by the formatted devices or an error message.
+ */
+struct DeviceRequest {
+    /**
+     * The format to output devices in.
+     */
+    Format output_format{Format::TABLE};
+    /**
+     * The filters which devices must all match.
+     */
+    std::vector<FilterTerm> filter;
+    /**
+     * Whether to compare filters using regex.
+     */
+    bool use_regex{false};
+    /**
+     * Whether to compare filters using a glob.
+     */
+    bool use_glob{false};
+    /**
+     * Whether to output the parent columns.
+     */
+    bool parent_columns{false};
+
+    /**
+     * Encode the request, excluding its length.
+     *
+     * @return the encoded request
+     */
+    [[nodiscard]] std::string encode() const;
+
+    /**
+     * Decode a request, excluding its length.
+     *
+     * @param message the encoded request
+     * @return the request, or nothing if the message is malformed
+     */
+    [[nodiscard]] static std::optional<DeviceRequest> decode(
+        std::string_view message
+    );
+
+    bool operator==(const DeviceRequest&) const = default;
+};
+
+/**
+ * Answers device queries from clients using the latest snapshot of input
+ * devices, so that a query only filters and formats devices which are
+ * already in memory, without any sysfs reads or ioctls. Clients are served
+ * on the calling thread while another thread refreshes the snapshot, such as
+ * when devices are hotplugged.
+ *
+ * Client sockets are non-blocking, and responses are buffered per client
+ * and sent as the client reads them, so a client which stops reading does
+ * not hold up the others. Requests are not read from a client until its
+ * previous responses have been sent.
+ */
+class DeviceServer {
+public:
+    /**
+     * The largest request that is accepted, beyond which a client is
+     * disconnected.
+     */
+    static constexpr std::uint32_t MAX_REQUEST{64 * 1024};
+
+    /**
+     * Create a socket at a path and listen for clients, replacing any stale
+     * socket at the path which no server is listening on.
+     *
+     * @param path the path of the socket
+     * @param snapshot the snapshot to answer queries from, which must outlive
+     *        the server
+     * @return the server or an error if the socket could not be created,
+     *         which is `std::errc::address_in_use` if another server is
+     *         listening at the path
+     */
+    [[nodiscard]] static std::expected<DeviceServer, std::system_error> bind(
+        const std::filesystem::path& path, const InputDevicesSnapshot& snapshot
+    );
+
+    /**
+     * Wait for up to the timeout for clients to connect, send requests or
+     * be ready to receive responses, then answer every complete request and
+     * send as much of each response as the clients accept without waiting.
+     * A client which disconnects is still answered if it sent complete
+     * requests before disconnecting.
+     *
+     * @param timeout how long to wait, where a negative timeout waits
+     *        indefinitely
+     * @return the number of requests answered, or an error if waiting failed
+     */
+    std::expected<std::size_t, std::system_error> poll(
+        std::chrono::milliseconds timeout
+    );
+
+    /**
+     * Answer a request using the latest snapshot.
+     *
+     * @param request the request
+     * @return the formatted devices, or an error message if a filter is
+     *         invalid
+     */
+    [[nodiscard]] std::expected<std::string, std::string> query(
+        const DeviceRequest& request
+    ) const;
+
+private:
+    struct Client {
+        FileDescriptor socket;
+        std::string input;
+        std::string output;
+        // Whether the client has stopped sending requests.
+        bool closed{false};
+    };
+
+    DeviceServer(FileDescriptor socket, const InputDevicesSnapshot& snapshot);
+
+    FileDescriptor socket_;
+    const InputDevicesSnapshot* snapshot_;
+    std::vector<Client> clients_;
+
+    bool receive(Client& client, std::size_t& answered) const;
+    static bool send(Client& client);
+};
+
+/**
+ * Sends device queries to a `DeviceServer`, such as for `--connect`.
+ */
+class DeviceClient {
+public:
+    /**
+     * Connect to a server.
+     *
+     * @param path the path of the socket
+     * @return the client or an error if the server could not be connected to
+     */
+    [[nodiscard]] static std::expected<DeviceClient, std::system_error>
+    connect(const std::filesystem::path& path);
+
+    /**
+     * Send a request and wait for the response.
+     *
+     * @param request the request
+     * @return the formatted devices, or an error if the request could not be
+     *         sent, or `std::errc::invalid_argument` if the server rejected it
+     */
+    std::expected<std::string, std::system_error> query(
+        const DeviceRequest& request
+    );
+
+private:
+    explicit DeviceClient(FileDescriptor socket);
+
+    FileDescriptor socket_;
+};
+
+} // namespace evlist
+
+#endif // EVLIST_DAEMON_H
@@ -7,17 +7,25 @@
 #ifndef EVLIST_DEVICE_H
 #define EVLIST_DEVICE_H
 
+#include <array>
+#include <atomic>
+#include <expected>
 #include <filesystem>
 #include <format>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <optional>
 #include <ranges>
-#include <regex>
+#include <span>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
 #include "evlist/cli.h"
+#include "evlist/format.h"
 
 /**
  * The namespace for this project.
@@ -26,6 +34,49 @@ namespace evlist {
 
 namespace fs = std::filesystem;
 
+class InputDevicesDiff;
+class FilterPlan;
+
+/**
+ * Attributes of the parent input device of an event device, read from
+ * `/sys/class/input/eventN/device`. Several event devices may share the same
+ * parent, such as `input3`. Missing attributes are empty.
+ */
+struct ParentDevice {
+    /**
+     * The sysfs name of the parent, such as `input3`.
+     */
+    std::string name;
+    /**
+     * The vendor id as four hex digits, from `id/vendor`.
+     */
+    std::string vendor;
+    /**
+     * The product id as four hex digits, from `id/product`.
+     */
+    std::string product;
+    /**
+     * The bus type as four hex digits, from `id/bustype`.
+     */
+    std::string bus;
+    /**
+     * The physical path, such as `usb-0000:00:14.0-2/input0`, from `phys`.
+     */
+    std::string phys;
+    /**
+     * The unique identifier, such as a serial number, from `uniq`.
+     */
+    std::string uniq;
+
+    /**
+     * Compare equality by each attribute.
+     *
+     * @param other compare to
+     * @return whether parents are equal
+     */
+    bool operator==(const ParentDevice& other) const = default;
+};
+
 /**
  * Store data such as paths and names of input event devices.
  */
@@ -41,13 +92,16 @@ public:
      * @param capabilities the device capabilities obtained by querying
      *        [ioctl using
      * EVIOCGBIT](https://www.kernel.org/doc/html/latest/input/ff.html#querying-device-capabilities).
+     * @param timed_out whether probing the device timed out, in which case
+     *        the name and capabilities are incomplete
      */
     InputDevice(
         fs::path device,
         std::string name,
         std::optional<std::string> by_id,
         std::optional<std::string> by_path,
-        std::vector<std::string> capabilities
+        std::vector<std::string> capabilities,
+        bool timed_out = false
     );
 
     /**
@@ -85,6 +139,48 @@ public:
      */
     [[nodiscard]] const std::vector<std::string>& capabilities() const;
 
+    /**
+     * Whether probing the device for its name and capabilities timed out.
+     *
+     * @return whether the device timed out
+     */
+    [[nodiscard]] bool timed_out() const;
+
+    /**
+     * Get the attributes of the parent input device.
+     *
+     * @return parent device
+     */
+    [[nodiscard]] const ParentDevice& parent() const;
+
+    /**
+     * Set the attributes of the parent input device.
+     *
+     * @param parent the parent device
+     * @return this instance of `InputDevice`
+     */
+    InputDevice& with_parent(ParentDevice parent);
+
+    /**
+     * Get the value of a column as it is formatted in the output, where
+     * missing symlinks are empty and capabilities are formatted as a list
+     * such as `[EV_SYN, EV_KEY]`.
+     *
+     * @param column the column to get
+     * @return the formatted value
+     */
+    [[nodiscard]] std::string value(Filter column) const;
+
+    /**
+     * Write the value of a column as it is formatted in the output into a
+     * buffer, replacing its contents. Reusing the buffer across devices
+     * avoids allocating for each value.
+     *
+     * @param column the column to get
+     * @param out the buffer to write into
+     */
+    void value_into(Filter column, std::string& out) const;
+
     /**
      * Partition a string into segments of numbers and characters, where
      * continuous numbers are part of the same partition. This is used to
@@ -109,6 +205,8 @@ private:
     std::optional<std::string> by_id_;
     std::optional<std::string> by_path_;
     std::vector<std::string> capabilities_;
+    bool timed_out_{false};
+    ParentDevice parent_;
 };
 
 /**
@@ -141,6 +239,78 @@ public:
      */
     static constexpr std::string_view HEADER_CAPABILITIES = "CAPABILITIES";
 
+    /**
+     * The name of the header for the parent input device.
+     */
+    static constexpr std::string_view HEADER_PARENT = "PARENT";
+
+    /**
+     * The name of the header for the vendor id.
+     */
+    static constexpr std::string_view HEADER_VENDOR = "VENDOR";
+
+    /**
+     * The name of the header for the product id.
+     */
+    static constexpr std::string_view HEADER_PRODUCT = "PRODUCT";
+
+    /**
+     * The name of the header for the bus type.
+     */
+    static constexpr std::string_view HEADER_BUS = "BUS";
+
+    /**
+     * The name of the header for the physical path.
+     */
+    static constexpr std::string_view HEADER_PHYS = "PHYS";
+
+    /**
+     * The name of the header for the unique identifier.
+     */
+    static constexpr std::string_view HEADER_UNIQ = "UNIQ";
+
+    /**
+     * All columns in the order that they are output.
+     */
+    static constexpr std::array COLUMNS{
+        Filter::NAME,
+        Filter::DEVICE_PATH,
+        Filter::BY_ID,
+        Filter::BY_PATH,
+        Filter::CAPABILITIES
+    };
+
+    /**
+     * The parent device columns, which are output before the capabilities
+     * if parent columns are enabled.
+     */
+    static constexpr std::array PARENT_COLUMNS{
+        Filter::PARENT,
+        Filter::VENDOR,
+        Filter::PRODUCT,
+        Filter::BUS,
+        Filter::PHYS,
+        Filter::UNIQ
+    };
+
+    /**
+     * All columns in the order that they are output if parent columns are
+     * enabled, where the parent columns are placed before the capabilities.
+     */
+    static constexpr std::array ALL_COLUMNS{
+        Filter::NAME,
+        Filter::DEVICE_PATH,
+        Filter::BY_ID,
+        Filter::BY_PATH,
+        Filter::PARENT,
+        Filter::VENDOR,
+        Filter::PRODUCT,
+        Filter::BUS,
+        Filter::PHYS,
+        Filter::UNIQ,
+        Filter::CAPABILITIES
+    };
+
     /**
      * Create input devices with the default format.
      *
@@ -156,21 +326,117 @@ public:
      */
     InputDevices(Format output_format, std::vector<InputDevice> input_devices);
 
+    /**
+     * Parse input devices from the CSV output of `evlist::Format::CSV`.
+     * Columns are matched by their header, so columns may be missing or
+     * in a different order.
+     *
+     * @param csv the CSV to parse
+     * @param output_format the output format of the parsed devices
+     * @return the input devices in the order of the CSV rows, or an error
+     *         message if the CSV could not be parsed
+     */
+    [[nodiscard]] static std::expected<InputDevices, std::string>
+    from_csv(std::string_view csv, Format output_format = Format::TABLE);
+
+    /**
+     * Get the header name of a column.
+     *
+     * @param column the column
+     * @return the header name
+     */
+    [[nodiscard]] static constexpr std::string_view header(Filter column);
+
+    /**
+     * Compute the difference between these devices and another set of
+     * devices. Devices are matched by their device path using a linear merge
+     * over both lists in natural sort order. Lists which are not sorted are
+     * sorted first.
+     *
+     * @param other the devices to compare against, such as a newer listing
+     * @return the devices which are only in `other`, the devices which are
+     *         only in these devices, and the devices whose fields changed
+     */
+    [[nodiscard]] InputDevicesDiff diff(const InputDevices& other) const;
+
     /**
      * Filter the devices so that only devices matching the filter remain.
      *
-     * @param filter filter by a vector of pairs of the filter type and string.
-     *        This will only include devices that equal the string for a given
-     *        filter. Capabilities include devices where all the capabilities
-     *        match the filters.
-     * @param use_regex whether to compare using a regex instead of equality
+     * @param filter filter by a vector of filter types, operators and
+     *        strings. This will only include devices that match the string
+     *        for a given filter. Capabilities include devices where all the
+     *        capabilities match the filters.
+     * @param use_regex whether to compare `FilterOperator::EQUAL` filters
+     *        using a regex instead of equality
+     * @param use_glob whether to compare `FilterOperator::EQUAL` filters
+     *        using a glob instead of equality
      * @return filtered input devices
      */
     InputDevices& filter(
-        const std::vector<std::pair<Filter, std::string>>& filter,
-        bool use_regex
+        const std::vector<FilterTerm>& filter,
+        bool use_regex,
+        bool use_glob = false
+    );
+
+    /**
+     * Filter the devices using a plan, which can be reused across calls so
+     * that patterns are compiled once and the order of evaluation carries
+     * over.
+     *
+     * @param plan the filter plan
+     * @return filtered input devices
+     */
+    InputDevices& filter(FilterPlan& plan);
+
+    /**
+     * Check whether a column of a device matches a comparison in the same
+     * way as `filter`, where a device matches on capabilities if any of its
+     * capabilities match.
+     *
+     * @param device the device
+     * @param filter the column to compare
+     * @param comparison the comparison applied to the column values
+     * @return whether the device matches
+     */
+    static bool filter_device(
+        const InputDevice& device,
+        Filter filter,
+        std::invocable<const std::string&> auto comparison
     );
 
+    /**
+     * Find the devices whose column equals a value, using the same equality
+     * as `filter` without modifying the devices. Each column is indexed by a
+     * hash table the first time it is queried, so later lookups do not scan
+     * the devices. This is safe to call concurrently.
+     *
+     * @param column the column to compare
+     * @param value the value to find
+     * @return the matching devices in their listed order, which are valid
+     *         until the devices are modified
+     */
+    [[nodiscard]] std::span<const InputDevice* const> find(
+        Filter column, std::string_view value
+    ) const;
+
+    /**
+     * Group the devices by their parent input device, where each group is in
+     * the order of its first device and devices without a parent are in
+     * their own group.
+     *
+     * @return the groups of devices
+     */
+    [[nodiscard]] std::vector<std::vector<InputDevice>> group_by_parent(
+    ) const;
+
+    /**
+     * Set whether to output the `PARENT_COLUMNS`.
+     *
+     * @param parent_columns whether to output parent columns
+     * @return this instance of `InputDevices`
+     */
+    InputDevices& with_parent_columns(bool parent_columns);
+
     /**
      * Set the maximum length of the device name field used for formatting
      * `evlist::Format` table output.
@@ -220,7 +486,7 @@ public:
      *
      * @return input devices
      */
-    [[nodiscard]] std::vector<InputDevice> devices() const;
+    [[nodiscard]] const std::vector<InputDevice>& devices() const;
 
     /**
      * Get the maximum length of the device name field used for formatting
@@ -254,6 +520,13 @@ public:
      */
     [[nodiscard]] size_t max_by_path() const;
 
+    /**
+     * Get whether to output the `PARENT_COLUMNS`.
+     *
+     * @return whether to output parent columns
+     */
+    [[nodiscard]] bool parent_columns() const;
+
     /**
      * Get the output format.
      *
@@ -262,8 +535,50 @@ public:
     [[nodiscard]] Format output_format() const;
 
 private:
+    static constexpr std::size_t INDEXED_COLUMNS{
+        COLUMNS.size() + PARENT_COLUMNS.size()
+    };
+
+    /**
+     * Hash indexes which are built on first use, and only allocated once an
+     * index is used. Copies and moves start with no indexes, and moves leave
+     * the moved-from indexes empty, since the indexes point into the devices
+     * they were built from.
+     */
+    class Indexes {
+    public:
+        using Index = std::unordered_map<
+            std::string_view,
+            std::vector<const InputDevice*>>;
+
+        Indexes() = default;
+        Indexes(const Indexes& other);
+        Indexes(Indexes&& other) noexcept;
+        Indexes& operator=(const Indexes& other);
+        Indexes& operator=(Indexes&& other) noexcept;
+        ~Indexes();
+
+        const Index& get(
+            Filter column, const std::vector<InputDevice>& devices
+        ) const;
+        void reset() noexcept;
+
+    private:
+        struct State {
+            std::array<std::once_flag, INDEXED_COLUMNS> built;
+            std::array<Index, INDEXED_COLUMNS> indexes;
+        };
+
+        // Created by the first reader, which may race with other readers.
+        mutable std::atomic<State*> state_{nullptr};
+
+        State& state() const;
+    };
+
     Format output_format_{Format::TABLE};
     std::vector<InputDevice> devices_;
+    bool parent_columns_{false};
+    Indexes indexes_;
 
     std::size_t MIN_SPACES{1};
     std::size_t max_name_size_{HEADER_NAME.length() + MIN_SPACES};
@@ -271,21 +586,42 @@ private:
     std::size_t max_by_id_size_{HEADER_BY_ID.length() + MIN_SPACES};
     std::size_t max_by_path_size_{HEADER_BY_PATH.length() + MIN_SPACES};
 
-    std::map<std::string, std::regex> regexes;
-
-    bool filter_regex(
-        const InputDevice& device, Filter filter, const std::string& value
-    );
-    static bool filter_equality(
-        const InputDevice& device, Filter filter, const std::string& value
-    );
-    static bool filter_device(
-        const InputDevice& device,
-        Filter filter,
-        std::invocable<const std::string&> auto comparison
+    static std::expected<std::vector<std::vector<std::string>>, std::string>
+    parse_csv(std::string_view csv);
+    static bool column_equal(
+        const InputDevice& lhs, const InputDevice& rhs, Filter column
     );
 };
 
+constexpr std::string_view InputDevices::header(Filter column) {
+    switch (column) {
+        case Filter::DEVICE_PATH:
+            return HEADER_DEVICE_PATH;
+        case Filter::NAME:
+            return HEADER_NAME;
+        case Filter::BY_ID:
+            return HEADER_BY_ID;
+        case Filter::BY_PATH:
+            return HEADER_BY_PATH;
+        case Filter::CAPABILITIES:
+            return HEADER_CAPABILITIES;
+        case Filter::PARENT:
+            return HEADER_PARENT;
+        case Filter::VENDOR:
+            return HEADER_VENDOR;
+        case Filter::PRODUCT:
+            return HEADER_PRODUCT;
+        case Filter::BUS:
+            return HEADER_BUS;
+        case Filter::PHYS:
+            return HEADER_PHYS;
+        case Filter::UNIQ:
+            return HEADER_UNIQ;
+    }
+
+    return "";
+}
+
 bool InputDevices::filter_device(
     const InputDevice& device,
     Filter filter,
@@ -300,31 +636,44 @@ bool InputDevices::filter_device(
             return comparison(device.by_id().value_or(""));
         case Filter::BY_PATH:
             return comparison(device.by_path().value_or(""));
-        case Filter::CAPABILITIES:
+        case Filter::CAPABILITIES: {
             const auto& capabilities = device.capabilities();
             return std::ranges::any_of(
                 capabilities, [&comparison](const auto& capability) {
                     return comparison(capability);
                 }
             );
+        }
+        case Filter::PARENT:
+            return comparison(device.parent().name);
+        case Filter::VENDOR:
+            return comparison(device.parent().vendor);
+        case Filter::PRODUCT:
+            return comparison(device.parent().product);
+        case Filter::BUS:
+            return comparison(device.parent().bus);
+        case Filter::PHYS:
+            return comparison(device.parent().phys);
+        case Filter::UNIQ:
+            return comparison(device.parent().uniq);
     }
 
     return true;
 }
 
 /**
- * Compare two input devices using natural sorting where multi-digit numbers
- * are treated as a single number.
+ * Compare two device paths using natural sorting where multi-digit numbers
+ * are treated as a single number, so that `event2` sorts before `event10`.
  *
- * @param lhs compare with left input device
- * @param rhs compare with right input device
+ * @param lhs compare with left device path
+ * @param rhs compare with right device path
  * @return the
  * [`std::strong_ordering`](https://en.cppreference.com/w/cpp/utility/compare/strong_ordering)
  *         sort order
  */
-inline auto operator<=>(const InputDevice& lhs, const InputDevice& rhs) {
-    auto lhs_device = lhs.device_path().string();
-    auto rhs_device = rhs.device_path().string();
+inline auto natural_order(const fs::path& lhs, const fs::path& rhs) {
+    auto lhs_device = lhs.string();
+    auto rhs_device = rhs.string();
 
     auto s1_partitions = InputDevice::partition(lhs_device);
     auto s2_partitions = InputDevice::partition(rhs_device);
@@ -341,6 +690,158 @@ inline auto operator<=>(const InputDevice& lhs, const InputDevice& rhs) {
     return lhs_device <=> rhs_device;
 }
 
+/**
+ * Compare two input devices using natural sorting of their device paths.
+ *
+ * @param lhs compare with left input device
+ * @param rhs compare with right input device
+ * @return the
+ * [`std::strong_ordering`](https://en.cppreference.com/w/cpp/utility/compare/strong_ordering)
+ *         sort order
+ */
+inline auto operator<=>(const InputDevice& lhs, const InputDevice& rhs) {
+    return natural_order(lhs.device_path(), rhs.device_path());
+}
+
+/**
+ * Writes input devices one row at a time using a `RowWriter`, so that rows
+ * can be written as soon as each device is available. Values are written
+ * into buffers which are reused for every device.
+ *
+ * @tparam Writer the `RowWriter` of the output format
+ * @tparam N the number of columns
+ */
+template <typename Writer, std::size_t N>
+class DeviceRowWriter {
+public:
+    /**
+     * Create a writer for the columns.
+     *
+     * @param columns the columns to write
+     * @param widths the widths that tables pad each column to
+     * @param index the index of the first row, for writing rows in chunks
+     */
+    constexpr explicit DeviceRowWriter(
+        const std::array<Filter, N>& columns,
+        const std::array<std::size_t, N>& widths = {},
+        std::size_t index = 0
+    );
+
+    /**
+     * Write the header.
+     *
+     * @param out the output iterator
+     * @return the iterator after writing
+     */
+    template <typename Out>
+    constexpr Out begin(Out out) const;
+
+    /**
+     * Write the row of a device.
+     *
+     * @param out the output iterator
+     * @param device the device
+     * @return the iterator after writing
+     */
+    template <typename Out>
+    constexpr Out row(Out out, const InputDevice& device);
+
+    /**
+     * Write the end of the output after the last row.
+     *
+     * @param out the output iterator
+     * @return the iterator after writing
+     */
+    template <typename Out>
+    constexpr Out end(Out out) const;
+
+private:
+    std::array<Filter, N> columns_;
+    std::array<std::size_t, N> widths_;
+    std::array<std::string_view, N> header_{};
+    std::array<std::string, N> buffers_{};
+    std::array<std::string_view, N> values_{};
+    std::size_t index_{0};
+};
+
+template <typename Writer, std::size_t N>
+constexpr DeviceRowWriter<Writer, N>::DeviceRowWriter(
+    const std::array<Filter, N>& columns,
+    const std::array<std::size_t, N>& widths,
+    std::size_t index
+)
+    : columns_{columns}, widths_{widths}, index_{index} {
+    for (std::size_t i = 0; i < N; i++) {
+        header_.at(i) = InputDevices::header(columns_.at(i));
+    }
+}
+
+template <typename Writer, std::size_t N>
+template <typename Out>
+constexpr Out DeviceRowWriter<Writer, N>::begin(Out out) const {
+    return Writer::begin(std::move(out), header_, widths_);
+}
+
+template <typename Writer, std::size_t N>
+template <typename Out>
+constexpr Out DeviceRowWriter<Writer, N>::row(
+    Out out, const InputDevice& device
+) {
+    for (std::size_t i = 0; i < N; i++) {
+        device.value_into(columns_.at(i), buffers_.at(i));
+        values_.at(i) = buffers_.at(i);
+    }
+    return Writer::row(std::move(out), header_, values_, widths_, index_++);
+}
+
+template <typename Writer, std::size_t N>
+template <typename Out>
+constexpr Out DeviceRowWriter<Writer, N>::end(Out out) const {
+    return Writer::end(std::move(out));
+}
+
+/**
+ * Call a function with the columns that input devices are output with and
+ * the widths that tables pad them to, so that widths are computed once
+ * before any rows are written.
+ *
+ * @param devices the input devices
+ * @param function called with the columns and the widths
+ * @return the result of the function
+ */
+template <typename Function>
+constexpr auto with_output_columns(
+    const InputDevices& devices, Function&& function
+) {
+    if (!devices.parent_columns()) {
+        const std::array widths{
+            devices.max_name(),
+            devices.max_device_path(),
+            devices.max_by_id(),
+            devices.max_by_path(),
+            std::size_t{0}
+        };
+        return function(InputDevices::COLUMNS, widths);
+    }
+
+    constexpr auto& columns = InputDevices::ALL_COLUMNS;
+
+    // Only tables need widths, which are measured in a separate pass.
+    std::array<std::size_t, columns.size()> widths{};
+    if (devices.output_format() == Format::TABLE) {
+        std::string value{};
+        for (std::size_t i = 0; i < columns.size(); i++) {
+            auto width = InputDevices::header(columns.at(i)).length();
+            for (const auto& device : devices.devices()) {
+                device.value_into(columns.at(i), value);
+                width = std::ranges::max(width, value.length());
+            }
+            widths.at(i) = width + 1;
+        }
+    }
+    return function(columns, widths);
+}
+
 } // namespace evlist
 
 /**
@@ -373,89 +874,38 @@ struct std::formatter<evlist::InputDevices> {
     constexpr auto format(
         const evlist::InputDevices& devices, Context& ctx
     ) const {
-        auto csv_escape_quotes = [](std::string_view str) {
-            std::string out = {};
-            out.reserve(str.length());
-
-            for (const auto character : str) {
-                if (character == '"') {
-                    out.push_back('"');
-                }
-                out.push_back(character);
-            }
-
-            return out;
-        };
-
-        auto format = [&csv_escape_quotes, &ctx, &devices](
-                          std::string_view name,
-                          std::string_view device,
-                          std::string_view by_id,
-                          std::string_view by_path,
-                          std::string_view capabilities
-                      ) {
-            switch (devices.output_format()) {
-                case evlist::Format::TABLE:
-                    std::format_to(
-                        ctx.out(),
-                        "{:<{}}{: <{}}{: <{}}{: <{}}{}\n",
-                        name,
-                        devices.max_name(),
-                        device,
-                        devices.max_device_path(),
-                        by_id,
-                        devices.max_by_id(),
-                        by_path,
-                        devices.max_by_path(),
-                        capabilities
-                    );
-                    break;
-                case evlist::Format::CSV:
-                    std::format_to(
-                        ctx.out(),
-                        R"("{}","{}","{}","{}","{}")"
-                        "\n",
-                        csv_escape_quotes(name),
-                        csv_escape_quotes(device),
-                        csv_escape_quotes(by_id),
-                        csv_escape_quotes(by_path),
-                        csv_escape_quotes(capabilities)
-                    );
-                    break;
+        return evlist::with_output_columns(
+            devices,
+            [&](const auto& columns, const auto& widths) {
+                return format_columns(devices, ctx, columns, widths);
             }
-        };
-
-        format(
-            evlist::InputDevices::HEADER_NAME,
-            evlist::InputDevices::HEADER_DEVICE_PATH,
-            evlist::InputDevices::HEADER_BY_ID,
-            evlist::InputDevices::HEADER_BY_PATH,
-            evlist::InputDevices::HEADER_CAPABILITIES
         );
+    }
 
-        for (const auto& device : devices.devices()) {
-            auto capabilities = device.capabilities();
-            std::string capabilities_str{};
-            if (!capabilities.empty()) {
-                capabilities_str += "[";
-                for (auto name : device.capabilities()) {
-                    capabilities_str += std::format("{}, ", name);
+private:
+    /**
+     * Format the columns of each device using the `evlist::RowWriter` of the
+     * output format, which is chosen once for all rows.
+     */
+    template <typename Context, std::size_t N>
+    // NOLINTNEXTLINE(runtime/references)
+    static constexpr auto format_columns(
+        const evlist::InputDevices& devices,
+        Context& ctx,
+        const std::array<evlist::Filter, N>& columns,
+        const std::array<std::size_t, N>& widths
+    ) {
+        return evlist::with_row_writer(
+            devices.output_format(),
+            [&]<typename Writer>(Writer) {
+                evlist::DeviceRowWriter<Writer, N> writer{columns, widths};
+                auto out = writer.begin(ctx.out());
+                for (const auto& device : devices.devices()) {
+                    out = writer.row(std::move(out), device);
                 }
-
-                capabilities_str.erase(capabilities_str.length() - 2);
-                capabilities_str += "]";
+                return writer.end(std::move(out));
             }
-
-            format(
-                device.name(),
-                device.device_path().string(),
-                device.by_id().value_or(""),
-                device.by_path().value_or(""),
-                capabilities_str
-            );
-        }
-
-        return std::format_to(ctx.out(), "");
+        );
     }
 };
 
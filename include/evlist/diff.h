@@ -0,0 +1,223 @@
+/**
+ * @file diff.h
+ *
+ * Contains definitions for the difference between two listings of input
+ * devices.
+ */
+
+#ifndef EVLIST_DIFF_H
+#define EVLIST_DIFF_H
+
+#include <array>
+#include <format>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "evlist/cli.h"
+#include "evlist/device.h"
+#include "evlist/format.h"
+
+/**
+ * The namespace for this project.
+ */
+namespace evlist {
+
+/**
+ * An input device which is present in both listings, but has different
+ * column values.
+ */
+class ChangedInputDevice {
+public:
+    /**
+     * Create the changed input device.
+     *
+     * @param previous the device in the previous listing
+     * @param current the device in the current listing
+     * @param columns the columns which changed
+     */
+    ChangedInputDevice(
+        InputDevice previous, InputDevice current, std::vector<Filter> columns
+    );
+
+    /**
+     * Get the device in the previous listing.
+     *
+     * @return previous device
+     */
+    [[nodiscard]] const InputDevice& previous() const;
+
+    /**
+     * Get the device in the current listing.
+     *
+     * @return current device
+     */
+    [[nodiscard]] const InputDevice& current() const;
+
+    /**
+     * Get the columns which changed.
+     *
+     * @return changed columns
+     */
+    [[nodiscard]] const std::vector<Filter>& columns() const;
+
+private:
+    InputDevice previous_;
+    InputDevice current_;
+    std::vector<Filter> columns_;
+};
+
+/**
+ * The difference between two listings of `evlist::InputDevices`, created
+ * using `evlist::InputDevices::diff`.
+ */
+class InputDevicesDiff {
+public:
+    /**
+     * The name of the header for the kind of change.
+     */
+    static constexpr std::string_view HEADER_CHANGE = "CHANGE";
+
+    /**
+     * The name of the header for the changed column.
+     */
+    static constexpr std::string_view HEADER_COLUMN = "COLUMN";
+
+    /**
+     * The name of the header for the previous value.
+     */
+    static constexpr std::string_view HEADER_PREVIOUS = "PREVIOUS";
+
+    /**
+     * The name of the header for the current value.
+     */
+    static constexpr std::string_view HEADER_CURRENT = "CURRENT";
+
+    /**
+     * Create the difference between two listings.
+     *
+     * @param output_format the output format
+     * @param added devices which are only in the current listing
+     * @param removed devices which are only in the previous listing
+     * @param changed devices which are in both listings with different values
+     */
+    InputDevicesDiff(
+        Format output_format,
+        std::vector<InputDevice> added,
+        std::vector<InputDevice> removed,
+        std::vector<ChangedInputDevice> changed
+    );
+
+    /**
+     * Get the devices which are only in the current listing.
+     *
+     * @return added devices
+     */
+    [[nodiscard]] const std::vector<InputDevice>& added() const;
+
+    /**
+     * Get the devices which are only in the previous listing.
+     *
+     * @return removed devices
+     */
+    [[nodiscard]] const std::vector<InputDevice>& removed() const;
+
+    /**
+     * Get the devices which are in both listings with different values.
+     *
+     * @return changed devices
+     */
+    [[nodiscard]] const std::vector<ChangedInputDevice>& changed() const;
+
+    /**
+     * Whether there are no differences between the listings.
+     *
+     * @return whether the diff is empty
+     */
+    [[nodiscard]] bool empty() const;
+
+    /**
+     * Get the output format.
+     *
+     * @return output format
+     */
+    [[nodiscard]] Format output_format() const;
+
+private:
+    Format output_format_{Format::TABLE};
+    std::vector<InputDevice> added_;
+    std::vector<InputDevice> removed_;
+    std::vector<ChangedInputDevice> changed_;
+};
+
+} // namespace evlist
+
+/**
+ * Defines the
+ * [`std:formatter`](https://en.cppreference.com/w/cpp/utility/format/formatter)
+ * for formatting `evlist::InputDevicesDiff`. Each change is output as a row
+ * containing the kind of change, the device path, and for changed devices,
+ * the column with its previous and current value. Removed and added devices
+ * output the device name as the previous and current value respectively.
+ */
+template <>
+struct std::formatter<evlist::InputDevicesDiff> {
+    /**
+     * Parse the diff by beginning a new iterator from the context.
+     *
+     * @param ctx formatting context
+     * @return output iterator
+     */
+    static constexpr auto parse(const std::format_parse_context& ctx) {
+        return ctx.begin();
+    }
+
+    /**
+     * Format the diff based on the output `Format`.
+     *
+     * @tparam Context context type
+     * @param diff input devices diff
+     * @param ctx context parameter
+     * @return iterator after formatting
+     */
+    template <typename Context>
+    // NOLINTNEXTLINE(runtime/references)
+    constexpr auto format(const evlist::InputDevicesDiff& diff, Context& ctx)
+        const {
+        using Row = std::array<std::string, 5>;
+
+        std::vector<Row> rows{};
+        rows.emplace_back(Row{
+            std::string{evlist::InputDevicesDiff::HEADER_CHANGE},
+            std::string{evlist::InputDevices::HEADER_DEVICE_PATH},
+            std::string{evlist::InputDevicesDiff::HEADER_COLUMN},
+            std::string{evlist::InputDevicesDiff::HEADER_PREVIOUS},
+            std::string{evlist::InputDevicesDiff::HEADER_CURRENT}
+        });
+        for (const auto& device : diff.removed()) {
+            rows.emplace_back(Row{
+                "removed", device.device_path().string(), "", device.name(), ""
+            });
+        }
+        for (const auto& device : diff.added()) {
+            rows.emplace_back(Row{
+                "added", device.device_path().string(), "", "", device.name()
+            });
+        }
+        for (const auto& device : diff.changed()) {
+            for (const auto column : device.columns()) {
+                rows.emplace_back(Row{
+                    "changed",
+                    device.current().device_path().string(),
+                    std::string{evlist::InputDevices::header(column)},
+                    device.previous().value(column),
+                    device.current().value(column)
+                });
+            }
+        }
+
+        return evlist::format_rows(ctx, diff.output_format(), rows);
+    }
+};
+
+#endif // EVLIST_DIFF_H
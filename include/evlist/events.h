@@ -0,0 +1,219 @@
+/**
+ * @file events.h
+ *
+ * Contains definitions for reading input events from multiple devices.
+ */
+
+#ifndef EVLIST_EVENTS_H
+#define EVLIST_EVENTS_H
+
+#include <linux/input.h>
+#include <sys/epoll.h>
+
+#include <chrono>
+#include <concepts>
+#include <cstddef>
+#include <expected>
+#include <span>
+#include <system_error>
+#include <vector>
+
+#include "evlist/device.h"
+
+/**
+ * The namespace for this project.
+ */
+namespace evlist {
+
+/**
+ * An owned file descriptor which is closed when destroyed.
+ */
+class FileDescriptor {
+public:
+    /**
+     * Create an invalid file descriptor.
+     */
+    FileDescriptor() = default;
+
+    /**
+     * Take ownership of a file descriptor.
+     *
+     * @param descriptor the file descriptor
+     */
+    explicit FileDescriptor(int descriptor);
+
+    /**
+     * Close the file descriptor.
+     */
+    ~FileDescriptor();
+
+    FileDescriptor(const FileDescriptor&) = delete;
+    FileDescriptor& operator=(const FileDescriptor&) = delete;
+
+    /**
+     * Move the file descriptor.
+     *
+     * @param other move from
+     */
+    FileDescriptor(FileDescriptor&& other) noexcept;
+
+    /**
+     * Move the file descriptor, closing the current one.
+     *
+     * @param other move from
+     * @return this instance of `FileDescriptor`
+     */
+    FileDescriptor& operator=(FileDescriptor&& other) noexcept;
+
+    /**
+     * Get the file descriptor.
+     *
+     * @return file descriptor
+     */
+    [[nodiscard]] int get() const;
+
+    /**
+     * Whether the file descriptor is valid.
+     *
+     * @return is valid
+     */
+    [[nodiscard]] bool valid() const;
+
+    /**
+     * Close the file descriptor early.
+     */
+    void close();
+
+private:
+    int descriptor_{-1};
+};
+
+/**
+ * Reads batches of `input_event` from multiple devices using a single
+ * `epoll` instance. Devices are identified by their index in the order they
+ * were opened.
+ */
+class EventPoller {
+public:
+    /**
+     * The maximum number of events read using a single `read` call.
+     */
+    static constexpr std::size_t BATCH_SIZE{256};
+
+    /**
+     * Open the devices in non-blocking mode for reading.
+     *
+     * @param devices the devices to open
+     * @return the event poller or an error if a device could not be opened
+     */
+    [[nodiscard]] static std::expected<EventPoller, std::system_error> open(
+        const std::vector<InputDevice>& devices
+    );
+
+    /**
+     * Read from already opened file descriptors, which should be
+     * non-blocking. This is useful for reading from pipes or other sources
+     * of events.
+     *
+     * @param descriptors the file descriptors
+     * @return the event poller or an error if `epoll` could not be set up
+     */
+    [[nodiscard]] static std::expected<EventPoller, std::system_error>
+    from_descriptors(std::vector<FileDescriptor> descriptors);
+
+    /**
+     * Wait for events for up to the timeout, and read all available events
+     * from devices which are ready. Devices which are removed or reach the
+     * end of their input are closed.
+     *
+     * @param timeout how long to wait for events
+     * @param on_events called with the device index and each batch of
+     *        events, where the batch is only valid for the duration of the
+     *        call
+     * @return the number of events read, or an error if polling or reading
+     *         failed. Returns zero if interrupted by a signal.
+     */
+    std::expected<std::size_t, std::system_error> poll(
+        std::chrono::milliseconds timeout,
+        std::invocable<std::size_t, std::span<const input_event>> auto on_events
+    );
+
+    /**
+     * Get the number of devices.
+     *
+     * @return number of devices
+     */
+    [[nodiscard]] std::size_t size() const;
+
+    /**
+     * Whether all devices have been closed.
+     *
+     * @return whether there are no open devices
+     */
+    [[nodiscard]] bool closed() const;
+
+    /**
+     * Get the file descriptor of a device, for example to use `ioctl`.
+     *
+     * @param device the device index
+     * @return the file descriptor
+     */
+    [[nodiscard]] int descriptor(std::size_t device) const;
+
+private:
+    explicit EventPoller(
+        FileDescriptor epoll, std::vector<FileDescriptor> descriptors
+    );
+
+    FileDescriptor epoll_;
+    std::vector<FileDescriptor> descriptors_;
+    std::size_t open_{0};
+    std::vector<epoll_event> ready_;
+    std::vector<std::size_t> ready_devices_;
+    std::vector<input_event> buffer_;
+
+    std::expected<std::span<const std::size_t>, std::system_error> wait(
+        std::chrono::milliseconds timeout
+    );
+    std::expected<std::span<const input_event>, std::system_error> read(
+        std::size_t device
+    );
+};
+
+std::expected<std::size_t, std::system_error> EventPoller::poll(
+    std::chrono::milliseconds timeout,
+    std::invocable<std::size_t, std::span<const input_event>> auto on_events
+) {
+    auto ready = wait(timeout);
+    if (!ready.has_value()) {
+        return std::unexpected{ready.error()};
+    }
+
+    std::size_t total = 0;
+    for (const auto device : *ready) {
+        // Keep reading until the device is drained so that fast devices do
+        // not overflow their kernel buffer between polls.
+        while (true) {
+            auto events = read(device);
+            if (!events.has_value()) {
+                return std::unexpected{events.error()};
+            }
+            if (events->empty()) {
+                break;
+            }
+
+            on_events(device, *events);
+            total += events->size();
+
+            if (events->size() < BATCH_SIZE) {
+                break;
+            }
+        }
+    }
+
+    return total;
+}
+
+} // namespace evlist
+
+#endif // EVLIST_EVENTS_H
@@ -7,8 +7,29 @@
 #ifndef EVLIST_EVLIST_H
 #define EVLIST_EVLIST_H
 
+#include "evlist/archive.h"
 #include "evlist/cli.h"
+#include "evlist/codes.h"
+#include "evlist/daemon.h"
 #include "evlist/device.h"
+#include "evlist/diff.h"
+#include "evlist/events.h"
+#include "evlist/expression.h"
+#include "evlist/format.h"
+#include "evlist/glob.h"
+#include "evlist/group.h"
+#include "evlist/hash.h"
+#include "evlist/hotplug.h"
+#include "evlist/latency.h"
 #include "evlist/list.h"
+#include "evlist/memo.h"
+#include "evlist/output.h"
+#include "evlist/pipeline.h"
+#include "evlist/plan.h"
+#include "evlist/queries.h"
+#include "evlist/record.h"
+#include "evlist/search.h"
+#include "evlist/snapshot.h"
+#include "evlist/top.h"
 
 #endif // EVLIST_EVLIST_H
@@ -0,0 +1,256 @@
+/**
+ * @file evlist_c.h
+ *
+ * Contains the stable C ABI for listing input devices without running the
+ * `evlist` binary. All devices are returned by a single call as one packed
+ * buffer of fixed-layout records, which is freed using `evlist_free`.
+ */
+
+#ifndef EVLIST_EVLIST_C_H
+#define EVLIST_EVLIST_C_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(__GNUC__)
+#define EVLIST_C_API __attribute__((visibility("default")))
+#else
+#define EVLIST_C_API
+#endif
+
+/**
+ * The version of the buffer layout, which changes if the layout of
+ * `evlist_devices` or `evlist_device_record` changes.
+ */
+#define EVLIST_ABI_VERSION 2
+
+/**
+ * Set on a record if the device has a by-id path.
+ */
+#define EVLIST_DEVICE_HAS_BY_ID 0x1U
+
+/**
+ * Set on a record if the device has a by-path path.
+ */
+#define EVLIST_DEVICE_HAS_BY_PATH 0x2U
+
+/**
+ * Set on a record if probing the device timed out, in which case the name
+ * and capabilities are incomplete.
+ */
+#define EVLIST_DEVICE_TIMED_OUT 0x4U
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * The column to filter devices by.
+ */
+typedef enum evlist_column {
+    /**
+     * The device path.
+     */
+    EVLIST_COLUMN_DEVICE_PATH = 0,
+    /**
+     * The device name.
+     */
+    EVLIST_COLUMN_NAME = 1,
+    /**
+     * The by-id path.
+     */
+    EVLIST_COLUMN_BY_ID = 2,
+    /**
+     * The by-path path.
+     */
+    EVLIST_COLUMN_BY_PATH = 3,
+    /**
+     * The device capabilities.
+     */
+    EVLIST_COLUMN_CAPABILITIES = 4,
+    /**
+     * The sysfs name of the parent input device.
+     */
+    EVLIST_COLUMN_PARENT = 5,
+    /**
+     * The vendor id of the parent input device.
+     */
+    EVLIST_COLUMN_VENDOR = 6,
+    /**
+     * The product id of the parent input device.
+     */
+    EVLIST_COLUMN_PRODUCT = 7,
+    /**
+     * The bus type of the parent input device.
+     */
+    EVLIST_COLUMN_BUS = 8,
+    /**
+     * The physical path of the parent input device.
+     */
+    EVLIST_COLUMN_PHYS = 9,
+    /**
+     * The unique identifier of the parent input device.
+     */
+    EVLIST_COLUMN_UNIQ = 10
+} evlist_column;
+
+/**
+ * A filter on a column, equivalent to `--filter column=value`.
+ */
+typedef struct evlist_filter {
+    /**
+     * The column to filter.
+     */
+    int32_t column;
+    /**
+     * The NUL-terminated value to filter by.
+     */
+    const char* value;
+} evlist_filter;
+
+/**
+ * A string stored in the buffer. The offset is from the start of the
+ * `evlist_devices` buffer, and the string is also NUL-terminated.
+ */
+typedef struct evlist_string {
+    /**
+     * The offset of the string from the start of the buffer.
+     */
+    uint32_t offset;
+    /**
+     * The length of the string, excluding the NUL terminator.
+     */
+    uint32_t length;
+} evlist_string;
+
+/**
+ * A listed device.
+ */
+typedef struct evlist_device_record {
+    /**
+     * The device path, such as `/dev/input/event3`.
+     */
+    evlist_string device_path;
+    /**
+     * The device name.
+     */
+    evlist_string name;
+    /**
+     * The by-id path, which is empty if there is none.
+     */
+    evlist_string by_id;
+    /**
+     * The by-path path, which is empty if there is none.
+     */
+    evlist_string by_path;
+    /**
+     * The capabilities separated by `,`, such as `EV_SYN,EV_KEY`.
+     */
+    evlist_string capabilities;
+    /**
+     * The capabilities as a bitmask indexed by the event type.
+     */
+    uint64_t capability_bits;
+    /**
+     * A combination of the `EVLIST_DEVICE_*` flags.
+     */
+    uint32_t flags;
+    /**
+     * Reserved, which is always zero.
+     */
+    uint32_t reserved;
+    /**
+     * The sysfs name of the parent input device, such as `input3`, which is
+     * empty if there is none.
+     */
+    evlist_string parent;
+    /**
+     * The vendor id of the parent input device as four hex digits.
+     */
+    evlist_string vendor;
+    /**
+     * The product id of the parent input device as four hex digits.
+     */
+    evlist_string product;
+    /**
+     * The bus type of the parent input device as four hex digits.
+     */
+    evlist_string bus;
+    /**
+     * The physical path of the parent input device.
+     */
+    evlist_string phys;
+    /**
+     * The unique identifier of the parent input device.
+     */
+    evlist_string uniq;
+} evlist_device_record;
+
+/**
+ * The header of the buffer returned by `evlist_list_devices`. The records
+ * follow the header, and the strings follow the records.
+ */
+typedef struct evlist_devices {
+    /**
+     * The layout version, which is `EVLIST_ABI_VERSION`.
+     */
+    uint32_t abi_version;
+    /**
+     * The size of each record in bytes.
+     */
+    uint32_t record_size;
+    /**
+     * The number of records.
+     */
+    uint32_t count;
+    /**
+     * The offset of the first record from the start of the buffer.
+     */
+    uint32_t records_offset;
+    /**
+     * The total size of the buffer in bytes.
+     */
+    uint64_t size;
+} evlist_devices;
+
+/**
+ * List input devices on the system, applying filters in the same way as the
+ * `evlist` binary.
+ *
+ * @param filters the filters, which may be null if `filter_count` is zero
+ * @param filter_count the number of filters
+ * @param use_regex whether to compare filters using regex
+ * @param out set to the buffer of devices on success, which must be freed
+ *        using `evlist_free`
+ * @return zero on success, or an `errno` value on failure
+ */
+EVLIST_C_API int evlist_list_devices(
+    const evlist_filter* filters,
+    size_t filter_count,
+    int use_regex,
+    evlist_devices** out
+);
+
+/**
+ * Get a record from a buffer.
+ *
+ * @param devices the buffer
+ * @param index the index of the record, which must be less than `count`
+ * @return the record
+ */
+EVLIST_C_API const evlist_device_record* evlist_device_at(
+    const evlist_devices* devices, uint32_t index
+);
+
+/**
+ * Free a buffer returned by `evlist_list_devices`.
+ *
+ * @param devices the buffer, which may be null
+ */
+EVLIST_C_API void evlist_free(evlist_devices* devices);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // EVLIST_EVLIST_C_H
@@ -0,0 +1,128 @@
+/**
+ * @file expression.h
+ *
+ * Contains definitions for boolean filter expressions such as
+ * `(name~"Logitech" or by_id~"kbd") and not capabilities=EV_ABS`.
+ */
+
+#ifndef EVLIST_EXPRESSION_H
+#define EVLIST_EXPRESSION_H
+
+#include <cstdint>
+#include <expected>
+#include <optional>
+#include <regex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "evlist/cli.h"
+#include "evlist/device.h"
+#include "evlist/memo.h"
+
+/**
+ * The namespace for this project.
+ */
+namespace evlist {
+
+/**
+ * A boolean expression over device columns, which is compiled once into a
+ * flat program that short-circuits when evaluated.
+ *
+ * Each comparison has the form `KEY=VALUE` for equality or `KEY~VALUE` for a
+ * regex search, or uses the operators of `--filter`, where `KEY*=VALUE`
+ * matches values containing the value, `KEY^=VALUE` matches values starting
+ * with the value and `KEY~=VALUE` matches values equal to the value ignoring
+ * case. Keys are the same as `--filter` and values are either bare words or
+ * double-quoted strings with `\"` and `\\` escapes.
+ * Comparisons are combined with `not`, `and` and `or` in decreasing order of
+ * precedence, and grouped with parentheses.
+ */
+class FilterExpression {
+public:
+    /**
+     * Parse and compile an expression.
+     *
+     * @param expression the expression
+     * @return the compiled expression or an error message
+     */
+    [[nodiscard]] static std::expected<FilterExpression, std::string> parse(
+        std::string_view expression
+    );
+
+    /**
+     * The results of each regex comparison of an expression for every
+     * distinct value, which are kept by the caller for a single evaluation
+     * over many devices since the expression itself is immutable.
+     */
+    using Memos = std::vector<PredicateMemo>;
+
+    /**
+     * Create empty memos for evaluating the expression over many devices.
+     *
+     * @return the memos
+     */
+    [[nodiscard]] Memos memos() const;
+
+    /**
+     * Check whether a device matches the expression.
+     *
+     * @param device the device
+     * @return whether the device matches
+     */
+    [[nodiscard]] bool matches(const InputDevice& device) const;
+
+    /**
+     * Check whether a device matches the expression, where each regex is only
+     * searched once for each distinct value of columns whose values repeat
+     * across devices.
+     *
+     * @param device the device
+     * @param memos the memos of this evaluation, created by `memos`
+     * @return whether the device matches
+     */
+    [[nodiscard]] bool matches(const InputDevice& device, Memos& memos) const;
+
+    /**
+     * Get the number of instructions in the compiled program.
+     *
+     * @return number of instructions
+     */
+    [[nodiscard]] std::size_t size() const;
+
+private:
+    enum class Opcode : uint8_t {
+        TEST,
+        JUMP_IF_FALSE,
+        JUMP_IF_TRUE,
+        NOT
+    };
+
+    struct Instruction {
+        Opcode opcode;
+        uint32_t operand;
+    };
+
+    struct Predicate {
+        Filter column;
+        std::string value;
+        FilterOperator op;
+        std::optional<std::regex> regex;
+    };
+
+    class Parser;
+
+    std::vector<Instruction> program_;
+    std::vector<Predicate> predicates_;
+
+    FilterExpression() = default;
+    [[nodiscard]] static bool test(
+        const InputDevice& device,
+        const Predicate& predicate,
+        PredicateMemo& memo
+    );
+};
+
+} // namespace evlist
+
+#endif // EVLIST_EXPRESSION_H
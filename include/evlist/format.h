@@ -0,0 +1,472 @@
+/**
+ * @file format.h
+ *
+ * Contains shared helpers for formatting rows of output.
+ */
+
+#ifndef EVLIST_FORMAT_H
+#define EVLIST_FORMAT_H
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "evlist/cli.h"
+
+/**
+ * The namespace for this project.
+ */
+namespace evlist {
+
+/**
+ * Write a value to an output iterator. Formatting a single `{}` writes the
+ * value in one block rather than a character at a time.
+ *
+ * @param out the output iterator
+ * @param value the value to write
+ * @return iterator after writing
+ */
+template <typename Out>
+constexpr Out write_value(Out out, std::string_view value) {
+    return std::format_to(std::move(out), "{}", value);
+}
+
+/**
+ * Write a value to an output iterator, escaping the characters marked in a
+ * table. Runs of characters which do not need escaping are written in one
+ * block, so values without special characters are written as a single block.
+ *
+ * @param out the output iterator
+ * @param value the value to write
+ * @param special which characters need escaping
+ * @param escape writes the escaped form of a character and returns the
+ *        iterator after writing
+ * @return iterator after writing
+ */
+template <typename Out, typename Escape>
+constexpr Out write_escaped(
+    Out out,
+    std::string_view value,
+    const std::array<bool, UINT8_MAX + 1>& special,
+    Escape escape
+) {
+    std::size_t start = 0;
+    for (std::size_t i = 0; i < value.length(); i++) {
+        if (special.at(static_cast<std::uint8_t>(value[i]))) {
+            out = write_value(std::move(out), value.substr(start, i - start));
+            out = escape(std::move(out), value[i]);
+            start = i + 1;
+        }
+    }
+    return write_value(std::move(out), value.substr(start));
+}
+
+/**
+ * Writes rows of output in a single `Format`. Each format is a specialisation
+ * that is chosen once before any rows are written, so that writing a row does
+ * not check the format, and values are escaped directly into the output
+ * without allocating.
+ *
+ * Each specialisation has the static functions:
+ * - `begin(out, header, widths)`, which is called before the first row.
+ * - `row(out, header, values, widths, index)`, which writes the row at
+ *   `index`.
+ * - `end(out)`, which is called after the last row.
+ *
+ * The header and values are arrays of `std::string_view` with one element per
+ * column, and `widths` are the widths that tables pad each column to. Each
+ * function returns the iterator after writing.
+ *
+ * @tparam F the format to write
+ */
+template <Format F>
+struct RowWriter;
+
+/**
+ * Writes a table which pads each column except the last to its width.
+ */
+template <>
+struct RowWriter<Format::TABLE> {
+    template <typename Out, std::size_t N>
+    static constexpr Out begin(
+        Out out,
+        const std::array<std::string_view, N>& header,
+        const std::array<std::size_t, N>& widths
+    ) {
+        return row(std::move(out), header, header, widths, 0);
+    }
+
+    template <typename Out, std::size_t N>
+    static constexpr Out row(
+        Out out,
+        const std::array<std::string_view, N>& /*header*/,
+        const std::array<std::string_view, N>& values,
+        const std::array<std::size_t, N>& widths,
+        std::size_t /*index*/
+    ) {
+        for (std::size_t i = 0; i < N - 1; i++) {
+            out = std::format_to(
+                std::move(out), "{:<{}}", values.at(i), widths.at(i)
+            );
+        }
+        return std::format_to(std::move(out), "{}\n", values.at(N - 1));
+    }
+
+    template <typename Out>
+    static constexpr Out end(Out out) {
+        return out;
+    }
+};
+
+/**
+ * Writes CSV which quotes every value and doubles quotes within values.
+ */
+template <>
+struct RowWriter<Format::CSV> {
+    template <typename Out, std::size_t N>
+    static constexpr Out begin(
+        Out out,
+        const std::array<std::string_view, N>& header,
+        const std::array<std::size_t, N>& widths
+    ) {
+        return row(std::move(out), header, header, widths, 0);
+    }
+
+    template <typename Out, std::size_t N>
+    static constexpr Out row(
+        Out out,
+        const std::array<std::string_view, N>& /*header*/,
+        const std::array<std::string_view, N>& values,
+        const std::array<std::size_t, N>& /*widths*/,
+        std::size_t /*index*/
+    ) {
+        for (std::size_t i = 0; i < N; i++) {
+            *out++ = '"';
+            out = write_quoted(std::move(out), values.at(i));
+            out = write_value(std::move(out), i == N - 1 ? "\"\n" : "\",");
+        }
+        return out;
+    }
+
+    template <typename Out>
+    static constexpr Out end(Out out) {
+        return out;
+    }
+
+private:
+    template <typename Out>
+    static constexpr Out write_quoted(Out out, std::string_view value) {
+        // Quotes are rare, so they are found using a vectorised search.
+        for (auto quote = value.find('"'); quote != std::string_view::npos;
+             quote = value.find('"')) {
+            out = write_value(std::move(out), value.substr(0, quote + 1));
+            *out++ = '"';
+            value.remove_prefix(quote + 1);
+        }
+        return write_value(std::move(out), value);
+    }
+};
+
+/**
+ * Writes tab separated values, where tabs, newlines, carriage returns and
+ * backslashes within values are escaped as `\t`, `\n`, `\r` and `\\`.
+ */
+template <>
+struct RowWriter<Format::TSV> {
+    template <typename Out, std::size_t N>
+    static constexpr Out begin(
+        Out out,
+        const std::array<std::string_view, N>& header,
+        const std::array<std::size_t, N>& widths
+    ) {
+        return row(std::move(out), header, header, widths, 0);
+    }
+
+    template <typename Out, std::size_t N>
+    static constexpr Out row(
+        Out out,
+        const std::array<std::string_view, N>& /*header*/,
+        const std::array<std::string_view, N>& values,
+        const std::array<std::size_t, N>& /*widths*/,
+        std::size_t /*index*/
+    ) {
+        for (std::size_t i = 0; i < N; i++) {
+            out = write_escaped(
+                std::move(out), values.at(i), SPECIAL, escape<Out>
+            );
+            *out++ = i == N - 1 ? '\n' : '\t';
+        }
+        return out;
+    }
+
+    template <typename Out>
+    static constexpr Out end(Out out) {
+        return out;
+    }
+
+private:
+    static constexpr std::array<bool, UINT8_MAX + 1> SPECIAL{[] {
+        std::array<bool, UINT8_MAX + 1> special{};
+        for (const auto character : {'\t', '\n', '\r', '\\'}) {
+            special.at(static_cast<std::uint8_t>(character)) = true;
+        }
+        return special;
+    }()};
+
+    template <typename Out>
+    static constexpr Out escape(Out out, char character) {
+        *out++ = '\\';
+        switch (character) {
+            case '\t':
+                *out++ = 't';
+                break;
+            case '\n':
+                *out++ = 'n';
+                break;
+            case '\r':
+                *out++ = 'r';
+                break;
+            default:
+                *out++ = character;
+                break;
+        }
+        return out;
+    }
+};
+
+/**
+ * Escapes JSON strings, where quotes, backslashes and control characters are
+ * escaped.
+ */
+struct JsonEscape {
+    /**
+     * Which characters need escaping in a JSON string.
+     */
+    static constexpr std::array<bool, UINT8_MAX + 1> SPECIAL{[] {
+        std::array<bool, UINT8_MAX + 1> special{};
+        for (std::size_t i = 0; i < ' '; i++) {
+            special.at(i) = true;
+        }
+        special.at('"') = true;
+        special.at('\\') = true;
+        return special;
+    }()};
+
+    /**
+     * Write a value as a JSON string, including its quotes.
+     *
+     * @param out the output iterator
+     * @param value the value
+     * @return iterator after writing
+     */
+    template <typename Out>
+    static constexpr Out write_string(Out out, std::string_view value) {
+        *out++ = '"';
+        out = write_escaped(std::move(out), value, SPECIAL, escape<Out>);
+        *out++ = '"';
+        return out;
+    }
+
+    /**
+     * Write a row as a JSON object, using the header as the keys.
+     *
+     * @param out the output iterator
+     * @param header the header
+     * @param values the values of the row
+     * @return iterator after writing
+     */
+    template <typename Out, std::size_t N>
+    static constexpr Out write_object(
+        Out out,
+        const std::array<std::string_view, N>& header,
+        const std::array<std::string_view, N>& values
+    ) {
+        *out++ = '{';
+        for (std::size_t i = 0; i < N; i++) {
+            if (i != 0) {
+                *out++ = ',';
+            }
+            out = write_string(std::move(out), header.at(i));
+            *out++ = ':';
+            out = write_string(std::move(out), values.at(i));
+        }
+        *out++ = '}';
+        return out;
+    }
+
+private:
+    template <typename Out>
+    static constexpr Out escape(Out out, char character) {
+        switch (character) {
+            case '"':
+                return write_value(std::move(out), R"(\")");
+            case '\\':
+                return write_value(std::move(out), R"(\\)");
+            case '\n':
+                return write_value(std::move(out), R"(\n)");
+            case '\r':
+                return write_value(std::move(out), R"(\r)");
+            case '\t':
+                return write_value(std::move(out), R"(\t)");
+            default:
+                return std::format_to(
+                    std::move(out),
+                    "\\u{:04x}",
+                    static_cast<std::uint8_t>(character)
+                );
+        }
+    }
+};
+
+/**
+ * Writes a JSON array with one object per row, keyed by the header.
+ */
+template <>
+struct RowWriter<Format::JSON> {
+    template <typename Out, std::size_t N>
+    static constexpr Out begin(
+        Out out,
+        const std::array<std::string_view, N>& /*header*/,
+        const std::array<std::size_t, N>& /*widths*/
+    ) {
+        *out++ = '[';
+        return out;
+    }
+
+    template <typename Out, std::size_t N>
+    static constexpr Out row(
+        Out out,
+        const std::array<std::string_view, N>& header,
+        const std::array<std::string_view, N>& values,
+        const std::array<std::size_t, N>& /*widths*/,
+        std::size_t index
+    ) {
+        out = write_value(std::move(out), index == 0 ? "\n" : ",\n");
+        return JsonEscape::write_object(std::move(out), header, values);
+    }
+
+    template <typename Out>
+    static constexpr Out end(Out out) {
+        return write_value(std::move(out), "\n]\n");
+    }
+};
+
+/**
+ * Writes newline delimited JSON with one object per line, keyed by the
+ * header.
+ */
+template <>
+struct RowWriter<Format::NDJSON> {
+    template <typename Out, std::size_t N>
+    static constexpr Out begin(
+        Out out,
+        const std::array<std::string_view, N>& /*header*/,
+        const std::array<std::size_t, N>& /*widths*/
+    ) {
+        return out;
+    }
+
+    template <typename Out, std::size_t N>
+    static constexpr Out row(
+        Out out,
+        const std::array<std::string_view, N>& header,
+        const std::array<std::string_view, N>& values,
+        const std::array<std::size_t, N>& /*widths*/,
+        std::size_t /*index*/
+    ) {
+        out = JsonEscape::write_object(std::move(out), header, values);
+        *out++ = '\n';
+        return out;
+    }
+
+    template <typename Out>
+    static constexpr Out end(Out out) {
+        return out;
+    }
+};
+
+/**
+ * Call a function with the `RowWriter` of a format, so that the format is
+ * checked once rather than for every row.
+ *
+ * @param output_format the output format
+ * @param function called with a default constructed `RowWriter`
+ * @return the result of the function
+ */
+template <typename Function>
+constexpr auto with_row_writer(Format output_format, Function&& function) {
+    switch (output_format) {
+        case Format::CSV:
+            return function(RowWriter<Format::CSV>{});
+        case Format::TSV:
+            return function(RowWriter<Format::TSV>{});
+        case Format::JSON:
+            return function(RowWriter<Format::JSON>{});
+        case Format::NDJSON:
+            return function(RowWriter<Format::NDJSON>{});
+        case Format::TABLE:
+            break;
+    }
+    return function(RowWriter<Format::TABLE>{});
+}
+
+/**
+ * Format rows of columns, where the first row is the header. Tables align
+ * each column to its widest value, CSV quotes every value, and JSON formats
+ * use the header as the keys of each row.
+ *
+ * @tparam N the number of columns
+ * @tparam Context context type
+ * @param ctx context parameter
+ * @param output_format the output format
+ * @param rows the rows to format
+ * @return iterator after formatting
+ */
+template <std::size_t N, typename Context>
+// NOLINTNEXTLINE(runtime/references)
+constexpr auto format_rows(
+    Context& ctx,
+    Format output_format,
+    const std::vector<std::array<std::string, N>>& rows
+) {
+    std::array<std::size_t, N> widths{};
+    if (output_format == Format::TABLE) {
+        for (const auto& row : rows) {
+            for (std::size_t i = 0; i < N; i++) {
+                widths.at(i) =
+                    std::ranges::max(widths.at(i), row.at(i).length() + 1);
+            }
+        }
+    }
+
+    auto views = [](const std::array<std::string, N>& row) {
+        std::array<std::string_view, N> values{};
+        std::ranges::copy(row, values.begin());
+        return values;
+    };
+
+    return with_row_writer(output_format, [&]<typename Writer>(Writer) {
+        auto out = ctx.out();
+        if (rows.empty()) {
+            return out;
+        }
+
+        auto header = views(rows.front());
+        out = Writer::begin(std::move(out), header, widths);
+        for (std::size_t i = 1; i < rows.size(); i++) {
+            out = Writer::row(
+                std::move(out), header, views(rows.at(i)), widths, i - 1
+            );
+        }
+        return Writer::end(std::move(out));
+    });
+}
+
+} // namespace evlist
+
+#endif // EVLIST_FORMAT_H
@@ -0,0 +1,102 @@
+/**
+ * @file glob.h
+ *
+ * Contains definitions for matching values against shell-style globs.
+ */
+
+#ifndef EVLIST_GLOB_H
+#define EVLIST_GLOB_H
+
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * The namespace for this project.
+ */
+namespace evlist {
+
+/**
+ * A shell-style glob which is compiled once and then matched against whole
+ * values, such as `usb-*-kbd` or `event1?`.
+ *
+ * `*` matches any sequence of characters, `?` matches any single character,
+ * and `[...]` matches a single character from a set of characters and ranges
+ * such as `[0-9a-f]`, which is negated by a leading `!` or `^`. A `\` matches
+ * the following character literally. Any other character matches itself.
+ *
+ * The pattern is split at each `*` into fixed-length segments. Since a
+ * segment can always be matched at its leftmost position, matching never
+ * backtracks and does not allocate. Segments without wildcards are found
+ * using a substring search.
+ */
+class Glob {
+public:
+    /**
+     * Compile a glob. Every pattern is valid, and an unterminated `[` or a
+     * trailing `\` matches itself.
+     *
+     * @param pattern the glob pattern
+     */
+    explicit Glob(std::string_view pattern);
+
+    /**
+     * Check whether the whole value matches the glob.
+     *
+     * @param value the value
+     * @return whether the value matches
+     */
+    [[nodiscard]] bool matches(std::string_view value) const;
+
+    /**
+     * Get the only value matched by the glob if it has no wildcards, with any
+     * escapes removed. This value can be compared for equality rather than
+     * matching the glob.
+     *
+     * @return the literal value, or nothing if the glob has wildcards
+     */
+    [[nodiscard]] std::optional<std::string_view> literal() const;
+
+private:
+    enum class Kind : uint8_t { LITERAL, ANY, CLASS };
+
+    struct Atom {
+        Kind kind;
+        char character;
+        uint32_t set;
+    };
+
+    struct Segment {
+        std::vector<Atom> atoms;
+        // The segment as a string if every atom is a literal character.
+        std::optional<std::string> literal;
+    };
+
+    using CharacterSet =
+        std::bitset<std::numeric_limits<unsigned char>::max() + 1>;
+
+    // The segments between each `*`, where the first and last segments are
+    // anchored to the start and end of the value.
+    std::vector<Segment> segments_;
+    std::vector<CharacterSet> classes_;
+
+    [[nodiscard]] std::size_t parse_class(
+        std::string_view pattern, std::size_t position
+    );
+
+    [[nodiscard]] bool matches_at(
+        const Segment& segment, std::string_view value, std::size_t position
+    ) const;
+    [[nodiscard]] std::size_t find(
+        const Segment& segment, std::string_view value, std::size_t position
+    ) const;
+};
+
+} // namespace evlist
+
+#endif // EVLIST_GLOB_H
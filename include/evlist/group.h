@@ -0,0 +1,143 @@
+/**
+ * @file group.h
+ *
+ * Contains definitions for counting input devices grouped by the value of a
+ * column.
+ */
+
+#ifndef EVLIST_GROUP_H
+#define EVLIST_GROUP_H
+
+#include <array>
+#include <cstddef>
+#include <format>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "evlist/cli.h"
+#include "evlist/device.h"
+#include "evlist/format.h"
+#include "evlist/hash.h"
+
+/**
+ * The namespace for this project.
+ */
+namespace evlist {
+
+/**
+ * Counts input devices grouped by the value of a column, such as for
+ * `--group-by`. Devices are added one at a time, so groups are counted while
+ * devices are listed without keeping them.
+ *
+ * Devices are counted once for each of their capabilities when grouped by
+ * capabilities, and by the bus prefix of their by-path symlink, such as `pci`
+ * or `platform`, when grouped by by-path, since by-path symlinks are unique
+ * to each device.
+ */
+class DeviceGroups {
+public:
+    /**
+     * The name of the header for the count of each group.
+     */
+    static constexpr std::string_view HEADER_COUNT = "COUNT";
+
+    /**
+     * Create empty groups.
+     *
+     * @param output_format the output format
+     * @param column the column to group by
+     */
+    DeviceGroups(Format output_format, Filter column);
+
+    /**
+     * Count a device in its groups.
+     *
+     * @param device the device
+     */
+    void add(const InputDevice& device);
+
+    /**
+     * Get the value and count of each group, ordered by the most devices
+     * first and then by value.
+     *
+     * @return the groups
+     */
+    [[nodiscard]] std::vector<std::pair<std::string_view, std::size_t>>
+    counts() const;
+
+    /**
+     * Get the column that devices are grouped by.
+     *
+     * @return the column
+     */
+    [[nodiscard]] Filter column() const;
+
+    /**
+     * Get the output format.
+     *
+     * @return output format
+     */
+    [[nodiscard]] Format output_format() const;
+
+private:
+    Format output_format_;
+    Filter column_;
+    std::unordered_map<std::string, std::size_t, StringHash, std::equal_to<>>
+        counts_;
+    std::string value_;
+
+    void count(std::string_view value);
+};
+
+} // namespace evlist
+
+/**
+ * Defines the
+ * [`std:formatter`](https://en.cppreference.com/w/cpp/utility/format/formatter)
+ * for formatting `evlist::DeviceGroups`.
+ */
+template <>
+struct std::formatter<evlist::DeviceGroups> {
+    /**
+     * Parse the groups by beginning a new iterator from the context.
+     *
+     * @param ctx formatting context
+     * @return output iterator
+     */
+    static constexpr auto parse(const std::format_parse_context& ctx) {
+        return ctx.begin();
+    }
+
+    /**
+     * Format the groups based on the output `Format`.
+     *
+     * @tparam Context context type
+     * @param groups device groups
+     * @param ctx context parameter
+     * @return iterator after formatting
+     */
+    template <typename Context>
+    // NOLINTNEXTLINE(runtime/references)
+    constexpr auto format(
+        const evlist::DeviceGroups& groups, Context& ctx
+    ) const {
+        using Row = std::array<std::string, 2>;
+
+        std::vector<Row> rows{};
+        rows.emplace_back(Row{
+            std::string{evlist::InputDevices::header(groups.column())},
+            std::string{evlist::DeviceGroups::HEADER_COUNT}
+        });
+        for (const auto& [value, count] : groups.counts()) {
+            rows.emplace_back(Row{std::string{value}, std::to_string(count)});
+        }
+
+        return evlist::format_rows(ctx, groups.output_format(), rows);
+    }
+};
+
+#endif // EVLIST_GROUP_H
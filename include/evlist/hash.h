@@ -0,0 +1,40 @@
+/**
+ * @file hash.h
+ *
+ * Contains definitions for hashing strings in unordered containers.
+ */
+
+#ifndef EVLIST_HASH_H
+#define EVLIST_HASH_H
+
+#include <cstddef>
+#include <functional>
+#include <string_view>
+
+/**
+ * The namespace for this project.
+ */
+namespace evlist {
+
+/**
+ * A transparent string hash which, together with `std::equal_to<>`, allows
+ * unordered containers keyed by `std::string` to be searched using a
+ * `std::string_view` without allocating a key.
+ */
+struct StringHash {
+    using is_transparent = void;
+
+    /**
+     * Hash a string.
+     *
+     * @param value the string
+     * @return the hash
+     */
+    std::size_t operator()(std::string_view value) const {
+        return std::hash<std::string_view>{}(value);
+    }
+};
+
+} // namespace evlist
+
+#endif // EVLIST_HASH_H
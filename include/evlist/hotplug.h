@@ -0,0 +1,250 @@
+/**
+ * @file hotplug.h
+ *
+ * Contains definitions for listening to input devices being added, removed
+ * or changed using kernel uevents.
+ */
+
+#ifndef EVLIST_HOTPLUG_H
+#define EVLIST_HOTPLUG_H
+
+#include <array>
+#include <chrono>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <system_error>
+
+#include "evlist/device.h"
+#include "evlist/events.h"
+#include "evlist/list.h"
+
+/**
+ * The namespace for this project.
+ */
+namespace evlist {
+
+/**
+ * The action of a uevent.
+ */
+enum class UeventAction : uint8_t {
+    /**
+     * A device was added.
+     */
+    ADD,
+    /**
+     * A device was removed.
+     */
+    REMOVE,
+    /**
+     * The attributes of a device changed.
+     */
+    CHANGE
+};
+
+/**
+ * A uevent sent by the kernel, where each field is a view into the message
+ * it was parsed from.
+ */
+struct Uevent {
+    /**
+     * The action of the event.
+     */
+    UeventAction action;
+    /**
+     * The sysfs path of the device, such as
+     * `/devices/.../input/input3/event5`.
+     */
+    std::string_view devpath;
+    /**
+     * The subsystem of the device, such as `input`.
+     */
+    std::string_view subsystem;
+    /**
+     * The device node relative to `/dev`, such as `input/event5`, which is
+     * empty if the device has no node.
+     */
+    std::string_view devname;
+
+    /**
+     * Parse a uevent message from the kernel, which is a header of the form
+     * `ACTION@DEVPATH` followed by `KEY=VALUE` fields, each terminated by a
+     * null character. This does not allocate.
+     *
+     * @param message the message
+     * @return the uevent, or nothing if the message is not a uevent from the
+     *         kernel or has an action other than add, remove or change
+     */
+    [[nodiscard]] static std::optional<Uevent> parse(
+        std::span<const char> message
+    );
+
+    /**
+     * Get the file name of the event device, such as `event5`, if this is an
+     * event of the `input` subsystem for an `eventN` device node.
+     *
+     * @return the file name of the event device, or nothing
+     */
+    [[nodiscard]] std::optional<std::string_view> event_device() const;
+};
+
+/**
+ * A source of uevent messages, which is abstract so that messages can be
+ * injected without a kernel socket.
+ */
+class UeventSource {
+public:
+    UeventSource() = default;
+    UeventSource(const UeventSource&) = delete;
+    UeventSource(UeventSource&&) = default;
+    UeventSource& operator=(const UeventSource&) = delete;
+    UeventSource& operator=(UeventSource&&) = default;
+    virtual ~UeventSource() = default;
+
+    /**
+     * Wait for up to the timeout and receive a single message.
+     *
+     * @param buffer the buffer to receive into
+     * @param timeout how long to wait for a message, where a negative timeout
+     *        waits indefinitely
+     * @return the size of the message, zero if no message was received before
+     *         the timeout, or an error, where `std::errc::no_buffer_space`
+     *         means that messages were dropped and receiving can continue
+     */
+    virtual std::expected<std::size_t, std::system_error> receive(
+        std::span<char> buffer, std::chrono::milliseconds timeout
+    ) = 0;
+};
+
+/**
+ * Receives uevents from the kernel using a `NETLINK_KOBJECT_UEVENT` socket.
+ * Messages which were not sent by the kernel or which do not fit in the
+ * buffer are ignored. If uevents arrive faster than they are received, the
+ * kernel drops them and this reports `std::errc::no_buffer_space`.
+ */
+class NetlinkUeventSource final : public UeventSource {
+public:
+    /**
+     * Open a socket subscribed to kernel uevents.
+     *
+     * @return the source or an error if the socket could not be opened
+     */
+    [[nodiscard]] static std::expected<NetlinkUeventSource, std::system_error>
+    open();
+
+    std::expected<std::size_t, std::system_error> receive(
+        std::span<char> buffer, std::chrono::milliseconds timeout
+    ) override;
+
+private:
+    explicit NetlinkUeventSource(FileDescriptor socket);
+
+    FileDescriptor socket_;
+};
+
+/**
+ * An input device which was added, removed or changed.
+ */
+struct HotplugEvent {
+    /**
+     * The action of the event.
+     */
+    UeventAction action;
+    /**
+     * The file name of the event device, such as `event5`.
+     */
+    std::string_view name;
+    /**
+     * The probed device if it was added or changed and matches the filters
+     * of the lister.
+     */
+    std::optional<InputDevice> device;
+};
+
+/**
+ * Listens for input devices being added, removed or changed, and probes
+ * only the affected `eventN` devices. The kernel sends the uevent of an
+ * event device after its parent input device is registered, so its sysfs
+ * name is readable when it is probed. The `by-id` and `by-path` symlinks are
+ * created afterwards by udev, so they may not exist yet.
+ */
+class HotplugListener {
+public:
+    /**
+     * The size of the buffer that messages are received into, which fits the
+     * largest uevent the kernel sends.
+     */
+    static constexpr std::size_t BUFFER_SIZE{8192};
+
+    /**
+     * Create a listener.
+     *
+     * @param source the source of uevent messages
+     * @param lister the lister used to probe devices
+     */
+    HotplugListener(
+        std::unique_ptr<UeventSource> source, InputDeviceLister lister
+    );
+
+    /**
+     * Wait for up to the timeout for a uevent, then handle all uevents which
+     * are available without waiting.
+     *
+     * @param timeout how long to wait for the first uevent
+     * @param on_event called with each input device event, where the event
+     *        is only valid for the duration of the call
+     * @return the number of input device events, or an error if receiving
+     *         or probing failed, where `std::errc::no_buffer_space` means
+     *         that events were dropped and devices should be listed again
+     *         before polling continues
+     */
+    std::expected<std::size_t, std::system_error> poll(
+        std::chrono::milliseconds timeout,
+        std::invocable<const HotplugEvent&> auto on_event
+    );
+
+private:
+    std::unique_ptr<UeventSource> source_;
+    InputDeviceLister lister_;
+    std::array<char, BUFFER_SIZE> buffer_{};
+
+    [[nodiscard]] std::expected<std::optional<HotplugEvent>, std::system_error>
+    handle(std::span<const char> message) const;
+};
+
+std::expected<std::size_t, std::system_error> HotplugListener::poll(
+    std::chrono::milliseconds timeout,
+    std::invocable<const HotplugEvent&> auto on_event
+) {
+    std::size_t total = 0;
+    while (true) {
+        auto received = source_->receive(buffer_, timeout);
+        if (!received.has_value()) {
+            return std::unexpected{received.error()};
+        }
+        if (*received == 0) {
+            return total;
+        }
+
+        auto event = handle(std::span{buffer_}.first(*received));
+        if (!event.has_value()) {
+            return std::unexpected{event.error()};
+        }
+        if (event->has_value()) {
+            on_event(**event);
+            total++;
+        }
+
+        // Handle the remaining uevents without waiting.
+        timeout = std::chrono::milliseconds{0};
+    }
+}
+
+} // namespace evlist
+
+#endif // EVLIST_HOTPLUG_H
@@ -0,0 +1,286 @@
+/**
+ * @file latency.h
+ *
+ * Contains definitions for measuring the latency between the kernel timestamp
+ * of input events and when they are read.
+ */
+
+#ifndef EVLIST_LATENCY_H
+#define EVLIST_LATENCY_H
+
+#include <linux/input.h>
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <format>
+#include <limits>
+#include <span>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+#include "evlist/cli.h"
+#include "evlist/device.h"
+#include "evlist/format.h"
+
+/**
+ * The namespace for this project.
+ */
+namespace evlist {
+
+/**
+ * A fixed-size histogram with log-linear buckets, similar to an HDR
+ * histogram. Values below `2^(SUB_BUCKET_BITS + 1)` are exact, and larger
+ * values are recorded with a relative error of at most `2^-SUB_BUCKET_BITS`.
+ */
+class LatencyHistogram {
+public:
+    /**
+     * The number of bits of precision of each bucket.
+     */
+    static constexpr std::size_t SUB_BUCKET_BITS{5};
+
+    /**
+     * The number of linear sub-buckets within each power of two.
+     */
+    static constexpr std::size_t SUB_BUCKETS{std::size_t{1}
+                                             << SUB_BUCKET_BITS};
+
+    /**
+     * The total number of buckets, which covers all `uint64_t` values.
+     */
+    static constexpr std::size_t BUCKETS{
+        SUB_BUCKETS *
+        (std::numeric_limits<uint64_t>::digits - SUB_BUCKET_BITS + 1)
+    };
+
+    /**
+     * Record a value. This does not allocate.
+     *
+     * @param value the value
+     */
+    void record(uint64_t value) noexcept;
+
+    /**
+     * Reset the histogram.
+     */
+    void reset() noexcept;
+
+    /**
+     * Get the number of recorded values.
+     *
+     * @return number of values
+     */
+    [[nodiscard]] uint64_t count() const;
+
+    /**
+     * Get the maximum recorded value.
+     *
+     * @return maximum value
+     */
+    [[nodiscard]] uint64_t max() const;
+
+    /**
+     * Get the value at a percentile, which is the highest value that is
+     * equivalent to the bucket containing the percentile, limited to the
+     * maximum recorded value.
+     *
+     * @param percentile the percentile between 0 and 100
+     * @return the value, or zero if the histogram is empty
+     */
+    [[nodiscard]] uint64_t percentile(double percentile) const;
+
+    /**
+     * Get the bucket index of a value.
+     *
+     * @param value the value
+     * @return bucket index
+     */
+    [[nodiscard]] static std::size_t bucket(uint64_t value) noexcept;
+
+    /**
+     * Get the highest value which is recorded in a bucket.
+     *
+     * @param bucket the bucket index
+     * @return highest value of the bucket
+     */
+    [[nodiscard]] static uint64_t highest(std::size_t bucket) noexcept;
+
+private:
+    std::array<uint64_t, BUCKETS> counts_{};
+    uint64_t count_{0};
+    uint64_t max_{0};
+};
+
+/**
+ * Set the clock used for the timestamps of events read from a device to
+ * `CLOCK_MONOTONIC` using `EVIOCSCLOCKID`, so that timestamps can be compared
+ * to `std::chrono::steady_clock`.
+ *
+ * @param descriptor the file descriptor of the device
+ * @return an error if the clock could not be set
+ */
+std::expected<void, std::system_error> set_monotonic_clock(int descriptor);
+
+/**
+ * Tracks a latency histogram in microseconds for a set of devices, such as
+ * for `--latency`.
+ */
+class DeviceLatencies {
+public:
+    /**
+     * The name of the header for the device path.
+     */
+    static constexpr std::string_view HEADER_DEVICE_PATH =
+        InputDevices::HEADER_DEVICE_PATH;
+
+    /**
+     * The name of the header for the device name.
+     */
+    static constexpr std::string_view HEADER_NAME = InputDevices::HEADER_NAME;
+
+    /**
+     * The name of the header for the number of events.
+     */
+    static constexpr std::string_view HEADER_EVENTS = "EVENTS";
+
+    /**
+     * The name of the header for the median latency.
+     */
+    static constexpr std::string_view HEADER_P50 = "P50_US";
+
+    /**
+     * The name of the header for the 99th percentile latency.
+     */
+    static constexpr std::string_view HEADER_P99 = "P99_US";
+
+    /**
+     * The name of the header for the 99.9th percentile latency.
+     */
+    static constexpr std::string_view HEADER_P999 = "P999_US";
+
+    /**
+     * The name of the header for the maximum latency.
+     */
+    static constexpr std::string_view HEADER_MAX = "MAX_US";
+
+    /**
+     * Create the device latencies.
+     *
+     * @param output_format the output format
+     * @param devices the devices being measured, in the order of their
+     *        device index
+     */
+    DeviceLatencies(Format output_format, std::vector<InputDevice> devices);
+
+    /**
+     * Record the latency of a batch of events, which is the difference
+     * between the read time and the kernel timestamp of each event. Events
+     * with a timestamp after the read time are recorded as zero. This does
+     * not allocate.
+     *
+     * @param device the device index
+     * @param events the events read from the device
+     * @param read_time the monotonic time that the events were read
+     */
+    void record(
+        std::size_t device,
+        std::span<const input_event> events,
+        std::chrono::microseconds read_time
+    ) noexcept;
+
+    /**
+     * Get the devices being measured.
+     *
+     * @return devices
+     */
+    [[nodiscard]] const std::vector<InputDevice>& devices() const;
+
+    /**
+     * Get the histogram of a device.
+     *
+     * @param device the device index
+     * @return latency histogram
+     */
+    [[nodiscard]] const LatencyHistogram& histogram(std::size_t device) const;
+
+    /**
+     * Get the output format.
+     *
+     * @return output format
+     */
+    [[nodiscard]] Format output_format() const;
+
+private:
+    Format output_format_{Format::TABLE};
+    std::vector<InputDevice> devices_;
+    std::vector<LatencyHistogram> histograms_;
+};
+
+} // namespace evlist
+
+/**
+ * Defines the
+ * [`std:formatter`](https://en.cppreference.com/w/cpp/utility/format/formatter)
+ * for formatting `evlist::DeviceLatencies`.
+ */
+template <>
+struct std::formatter<evlist::DeviceLatencies> {
+    /**
+     * Parse the latencies by beginning a new iterator from the context.
+     *
+     * @param ctx formatting context
+     * @return output iterator
+     */
+    static constexpr auto parse(const std::format_parse_context& ctx) {
+        return ctx.begin();
+    }
+
+    /**
+     * Format the latencies based on the output `Format`.
+     *
+     * @tparam Context context type
+     * @param latencies device latencies
+     * @param ctx context parameter
+     * @return iterator after formatting
+     */
+    template <typename Context>
+    // NOLINTNEXTLINE(runtime/references)
+    constexpr auto format(
+        const evlist::DeviceLatencies& latencies, Context& ctx
+    ) const {
+        using Row = std::array<std::string, 7>;
+
+        std::vector<Row> rows{};
+        rows.emplace_back(Row{
+            std::string{evlist::DeviceLatencies::HEADER_DEVICE_PATH},
+            std::string{evlist::DeviceLatencies::HEADER_NAME},
+            std::string{evlist::DeviceLatencies::HEADER_EVENTS},
+            std::string{evlist::DeviceLatencies::HEADER_P50},
+            std::string{evlist::DeviceLatencies::HEADER_P99},
+            std::string{evlist::DeviceLatencies::HEADER_P999},
+            std::string{evlist::DeviceLatencies::HEADER_MAX}
+        });
+        for (std::size_t device = 0; device < latencies.devices().size();
+             device++) {
+            const auto& histogram = latencies.histogram(device);
+            rows.emplace_back(Row{
+                latencies.devices()[device].device_path().string(),
+                latencies.devices()[device].name(),
+                std::format("{}", histogram.count()),
+                std::format("{}", histogram.percentile(50)),
+                std::format("{}", histogram.percentile(99)),
+                std::format("{}", histogram.percentile(99.9)),
+                std::format("{}", histogram.max())
+            });
+        }
+
+        return evlist::format_rows(ctx, latencies.output_format(), rows);
+    }
+};
+
+#endif // EVLIST_LATENCY_H
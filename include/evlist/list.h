@@ -7,25 +7,61 @@
 #ifndef EVLIST_LIST_H
 #define EVLIST_LIST_H
 
+#include <chrono>
+#include <cstddef>
 #include <expected>
+#include <functional>
+#include <future>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <optional>
+#include <span>
+#include <stop_token>
+#include <string_view>
 #include <string>
+#include <thread>
 #include <utility>
 #include <vector>
 
 #include "evlist/device.h"
+#include "evlist/expression.h"
+#include "evlist/pipeline.h"
 
 /**
  * The namespace for this project.
  */
 namespace evlist {
 
+class FilterPlan;
+class InputDeviceStream;
+
 /**
- * List all input devices on the system.
+ * List all input devices on the system. Devices are probed for their name
+ * and capabilities on a bounded pool of threads shared by every lister, so
+ * that a device which blocks does not block the listing past its deadline.
+ * The attributes of parent input devices are read once per parent and
+ * shared by its event devices.
  */
 class InputDeviceLister {
 public:
+    /**
+     * The name of devices whose name could not be read before the deadline.
+     */
+    static constexpr std::string_view TIMED_OUT_NAME = "<timed out>";
+
+    /**
+     * The maximum number of threads which probe devices. A device which
+     * never responds holds its thread until it does, so this also bounds
+     * the threads that blocked devices can hold.
+     */
+    static constexpr std::size_t MAX_PROBE_THREADS{32};
+
+    /**
+     * The default deadline for probing each device.
+     */
+    static constexpr std::chrono::milliseconds DEFAULT_PROBE_DEADLINE{1000};
+
     /**
      * Create an event device lister with default values.
      */
@@ -41,7 +77,7 @@ public:
     InputDeviceLister(
         Format output_format,
         bool use_regex,
-        std::vector<std::pair<Filter, std::string>> filter
+        std::vector<FilterTerm> filter
     );
 
     /**
@@ -54,26 +90,246 @@ public:
     [[nodiscard]] std::expected<InputDevices, fs::filesystem_error>
     list_input_devices() const;
 
+    /**
+     * Probe a single device in the input directory, such as `event5`,
+     * applying filters. This is used to probe only the devices which were
+     * added or changed rather than listing all devices again.
+     *
+     * @param name the file name of the device
+     * @return the input device, nothing if it does not match the filters, or
+     *         a filesystem error if any error occurred
+     */
+    [[nodiscard]] std::
+        expected<std::optional<InputDevice>, fs::filesystem_error>
+        list_input_device(std::string_view name) const;
+
+    /**
+     * Stream input devices in natural sort order, applying filters and the
+     * limit, so that each device can be output as soon as it and every
+     * device before it have been probed rather than after all devices have
+     * been probed. Unlike `list_input_devices`, every device is probed even
+     * if a limit is set.
+     *
+     * @return the stream of input devices
+     */
+    [[nodiscard]] InputDeviceStream stream_input_devices() const;
+
+    /**
+     * Set the deadline for probing each device, measured from when probing
+     * starts.
+     *
+     * @param probe_deadline the deadline for each device
+     * @return this instance of `InputDeviceLister`
+     */
+    InputDeviceLister& with_probe_deadline(
+        std::chrono::milliseconds probe_deadline
+    );
+
+    /**
+     * Set the total time budget for probing all devices. Devices which have
+     * not been probed when the budget runs out are listed without
+     * capabilities, and with `TIMED_OUT_NAME` as their name if it was not
+     * read in time.
+     *
+     * @param deadline the total deadline
+     * @return this instance of `InputDeviceLister`
+     */
+    InputDeviceLister& with_deadline(std::chrono::milliseconds deadline);
+
+    /**
+     * Limit the listing to the first devices in natural sort order which
+     * match the filters. Devices are probed in order in batches, where the
+     * first batch probes up to `limit` devices, capped at `MAX_PROBE_THREADS`,
+     * and each later batch is twice the size of the one before. Probing stops
+     * once enough matching devices are found.
+     *
+     * @param limit the maximum number of devices
+     * @return this instance of `InputDeviceLister`
+     */
+    InputDeviceLister& with_limit(std::size_t limit);
+
+    /**
+     * Compare filters using a glob instead of equality. This is ignored if
+     * filters are compared using regex.
+     *
+     * @param use_glob whether to compare filters using a glob
+     * @return this instance of `InputDeviceLister`
+     */
+    InputDeviceLister& with_glob(bool use_glob);
+
+    /**
+     * Only list devices which match an expression, in addition to the
+     * filters.
+     *
+     * @param where the expression
+     * @return this instance of `InputDeviceLister`
+     */
+    InputDeviceLister& with_where(FilterExpression where);
+
+    /**
+     * Set the directory containing device nodes, which defaults to
+     * `/dev/input`.
+     *
+     * @param input_directory the input directory
+     * @return this instance of `InputDeviceLister`
+     */
+    InputDeviceLister& with_input_directory(std::string input_directory);
+
+    /**
+     * Set the sysfs directory containing device names, which defaults to
+     * `/sys/class/input`.
+     *
+     * @param sys_class the sysfs directory
+     * @return this instance of `InputDeviceLister`
+     */
+    InputDeviceLister& with_sys_class(std::string sys_class);
+
 private:
+    friend class InputDeviceStream;
+
     Format output_format_{Format::TABLE};
     bool use_regex_{false};
-    std::vector<std::pair<Filter, std::string>> filter_;
+    bool use_glob_{false};
+    std::vector<FilterTerm> filter_;
 
     std::string input_directory_{"/dev/input"};
     std::string by_id_{input_directory_ + "/by-id"};
     std::string by_path_{input_directory_ + "/by-path"};
     std::string sys_class_{"/sys/class/input"};
     std::string name_path_{"device/name"};
-    std::map<uint32_t, std::string> event_names_{event_names()};
+
+    std::chrono::milliseconds probe_deadline_{DEFAULT_PROBE_DEADLINE};
+    std::optional<std::chrono::milliseconds> deadline_;
+    std::optional<std::size_t> limit_;
+    std::optional<FilterExpression> where_;
+
+    // A device timed out if it has no capabilities, and its name is only
+    // missing if reading the name also timed out.
+    struct Probe {
+        std::optional<std::string> name;
+        std::optional<std::vector<std::string>> capabilities;
+    };
+
+    // The name is published by the probe before it queries capabilities, so
+    // that it is not lost if querying capabilities times out.
+    struct ProbeProgress {
+        std::mutex mutex;
+        std::optional<std::string> name;
+
+        [[nodiscard]] Probe timed_out();
+    };
 
     static std::expected<std::optional<fs::path>, fs::filesystem_error>
     check_symlink(const fs::path& entry, const fs::path& path) noexcept;
-    [[nodiscard]] static std::map<uint32_t, std::string> event_names();
 
-    [[nodiscard]] std::string name(const fs::path& device) const;
-    [[nodiscard]] std::vector<std::string> capabilities(
-        const fs::path& device
+    [[nodiscard]] std::expected<std::vector<InputDevice>, fs::filesystem_error>
+    probe_devices(
+        std::span<const fs::path> paths,
+        std::chrono::steady_clock::time_point deadline,
+        FilterPlan& plan,
+        FilterExpression::Memos& memos,
+        std::size_t limit,
+        std::map<fs::path, ParentDevice>& parents
+    ) const;
+    [[nodiscard]] std::expected<InputDevice, fs::filesystem_error> device(
+        fs::path path, Probe probe, std::map<fs::path, ParentDevice>& parents
+    ) const;
+    [[nodiscard]] bool matches(
+        const InputDevice& device,
+        FilterPlan& plan,
+        FilterExpression::Memos& memos
+    ) const;
+    [[nodiscard]] FilterExpression::Memos where_memos() const;
+    [[nodiscard]] ParentDevice parent(
+        const fs::path& device, std::map<fs::path, ParentDevice>& parents
     ) const;
+    [[nodiscard]] std::future<Probe> probe(
+        const fs::path& device,
+        std::chrono::steady_clock::time_point until,
+        std::shared_ptr<ProbeProgress> progress
+    ) const;
+    [[nodiscard]] bool probe(
+        const fs::path& device,
+        std::chrono::steady_clock::time_point until,
+        std::shared_ptr<ProbeProgress> progress,
+        std::move_only_function<void(Probe)> on_probe
+    ) const;
+    [[nodiscard]] static std::string name(const fs::path& name_path);
+    [[nodiscard]] static std::vector<std::string> capabilities(
+        const fs::path& device
+    );
+};
+
+/**
+ * A stream of input devices which are probed, filtered and output by a
+ * pipeline of stages running concurrently. Probe workers push results onto a
+ * lock-free queue shared by all of them, a filter stage reads parents and
+ * symlinks and applies filters, and passes devices to the consumer through a
+ * single producer queue. The consumer restores natural sort order using a
+ * reorder buffer keyed by the position of each device.
+ *
+ * Devices which have not been probed before the deadlines of the lister
+ * are output without capabilities, as with `InputDeviceLister`.
+ */
+class InputDeviceStream {
+public:
+    InputDeviceStream(const InputDeviceStream&) = delete;
+    InputDeviceStream(InputDeviceStream&&) = delete;
+    InputDeviceStream& operator=(const InputDeviceStream&) = delete;
+    InputDeviceStream& operator=(InputDeviceStream&&) = delete;
+    ~InputDeviceStream() = default;
+
+    /**
+     * Wait for the next device in natural sort order which matches the
+     * filters.
+     *
+     * @return the input device, nothing if there are no more devices, or a
+     *         filesystem error if any error occurred for a device, after
+     *         which the stream continues from the next device
+     */
+    [[nodiscard]] std::
+        expected<std::optional<InputDevice>, fs::filesystem_error>
+        next();
+
+private:
+    friend class InputDeviceLister;
+
+    struct Probed {
+        std::size_t position;
+        InputDeviceLister::Probe probe;
+    };
+
+    struct Filtered {
+        std::size_t position;
+        std::expected<std::optional<InputDevice>, fs::filesystem_error> device;
+    };
+
+    InputDeviceStream(
+        InputDeviceLister lister,
+        std::vector<fs::path> paths,
+        std::chrono::steady_clock::time_point deadline
+    );
+
+    void filter(
+        const std::stop_token& stop,
+        std::chrono::steady_clock::time_point deadline
+    );
+
+    InputDeviceLister lister_;
+    std::vector<fs::path> paths_;
+    std::size_t limit_;
+    std::size_t listed_{0};
+
+    // Probe workers may finish after the stream is destroyed, so they share
+    // ownership of their queue and progress.
+    std::shared_ptr<MpscQueue<Probed>> probed_;
+    std::vector<std::shared_ptr<InputDeviceLister::ProbeProgress>> progress_;
+    SpscQueue<Filtered> filtered_;
+    ReorderBuffer<std::optional<InputDevice>> reorder_;
+
+    // The filter stage is declared last so that it is stopped and joined
+    // before the queues it uses are destroyed.
+    std::jthread filter_;
 };
 } // namespace evlist
 
@@ -0,0 +1,113 @@
+/**
+ * @file memo.h
+ *
+ * Contains definitions for memoising the result of a predicate per distinct
+ * value.
+ */
+
+#ifndef EVLIST_MEMO_H
+#define EVLIST_MEMO_H
+
+#include <concepts>
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include "evlist/cli.h"
+#include "evlist/hash.h"
+
+/**
+ * The namespace for this project.
+ */
+namespace evlist {
+
+/**
+ * The results of a single predicate for each distinct value it was evaluated
+ * on, so that values which repeat across devices, such as capabilities like
+ * `EV_SYN` or the names of multi-node devices, are only matched once. Each
+ * distinct value is interned as a key of the memo.
+ *
+ * Once `CAPACITY` distinct values have been seen, further values are still
+ * evaluated but no longer remembered, which bounds the memory used by columns
+ * whose values are all unique, such as device paths.
+ */
+class PredicateMemo {
+public:
+    /**
+     * The maximum number of distinct values that are remembered.
+     */
+    static constexpr std::size_t CAPACITY{4096};
+
+    /**
+     * Get the result of the predicate for a value, evaluating it only if the
+     * value has not been seen before.
+     *
+     * @param value the value
+     * @param predicate the predicate
+     * @return the result of the predicate
+     */
+    bool operator()(
+        std::string_view value, std::predicate<std::string_view> auto predicate
+    );
+
+    /**
+     * Get the number of distinct values that are remembered.
+     *
+     * @return number of values
+     */
+    [[nodiscard]] std::size_t size() const;
+
+private:
+    std::unordered_map<std::string, bool, StringHash, std::equal_to<>>
+        results_;
+};
+
+bool PredicateMemo::operator()(
+    std::string_view value, std::predicate<std::string_view> auto predicate
+) {
+    if (auto result = results_.find(value); result != results_.end()) {
+        return result->second;
+    }
+
+    auto result = predicate(value);
+    if (results_.size() < CAPACITY) {
+        results_.emplace(value, result);
+    }
+    return result;
+}
+
+inline std::size_t PredicateMemo::size() const { return results_.size(); }
+
+/**
+ * Check whether the values of a column commonly repeat across devices, so
+ * that memoising a predicate on the column is worthwhile. Paths and
+ * identifiers which are unique to each device would only fill the memo.
+ *
+ * @param column the column
+ * @return whether values of the column repeat
+ */
+constexpr bool repeats(Filter column) {
+    switch (column) {
+        case Filter::NAME:
+        case Filter::CAPABILITIES:
+        case Filter::PARENT:
+        case Filter::VENDOR:
+        case Filter::PRODUCT:
+        case Filter::BUS:
+            return true;
+        case Filter::DEVICE_PATH:
+        case Filter::BY_ID:
+        case Filter::BY_PATH:
+        case Filter::PHYS:
+        case Filter::UNIQ:
+            return false;
+    }
+
+    return false;
+}
+
+} // namespace evlist
+
+#endif // EVLIST_MEMO_H
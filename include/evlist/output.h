@@ -0,0 +1,48 @@
+/**
+ * @file output.h
+ *
+ * Contains definitions for writing formatted input devices to a file
+ * descriptor, formatting large listings on several threads.
+ */
+
+#ifndef EVLIST_OUTPUT_H
+#define EVLIST_OUTPUT_H
+
+#include <cstddef>
+#include <expected>
+#include <system_error>
+
+#include "evlist/device.h"
+
+/**
+ * The namespace for this project.
+ */
+namespace evlist {
+
+/**
+ * The minimum number of rows formatted by each thread in `write_devices`,
+ * below which starting a thread costs more than it saves.
+ */
+constexpr std::size_t MIN_CHUNK_ROWS{512};
+
+/**
+ * Write input devices to a file descriptor in their output format. Rows are
+ * split into chunks of at least `MIN_CHUNK_ROWS` which are formatted on up to
+ * `threads` threads into separate buffers, and the buffers are then written in
+ * order using `writev`. Table widths are computed once before any rows are
+ * formatted, so the output is identical to formatting the devices with
+ * `std::format`.
+ *
+ * @param descriptor the file descriptor to write to
+ * @param devices the input devices
+ * @param threads the maximum number of threads to format with, including the
+ *        calling thread, where zero formats on the calling thread only
+ * @return an error if writing failed
+ */
+std::expected<void, std::system_error> write_devices(
+    int descriptor, const InputDevices& devices, std::size_t threads
+);
+
+} // namespace evlist
+
+#endif // EVLIST_OUTPUT_H
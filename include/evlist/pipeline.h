@@ -0,0 +1,293 @@
+/**
+ * @file pipeline.h
+ *
+ * Contains definitions for passing results between the stages of a
+ * pipeline running on different threads.
+ */
+
+#ifndef EVLIST_PIPELINE_H
+#define EVLIST_PIPELINE_H
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <optional>
+#include <semaphore>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/**
+ * The namespace for this project.
+ */
+namespace evlist {
+
+/**
+ * A bounded lock-free queue with many producers and a single consumer. Each
+ * cell has a sequence number which producers claim using a compare and swap
+ * on the tail, so producers never wait on each other while the queue has
+ * space. The consumer blocks on a semaphore which is released once for each
+ * value pushed, so it sleeps rather than spins while waiting. Producers can
+ * publish out of order, in which case the consumer yields until the head
+ * cell is published.
+ *
+ * @tparam T the type of values
+ */
+template <typename T>
+class MpscQueue {
+public:
+    /**
+     * Create a queue which holds at least `capacity` values.
+     *
+     * @param capacity the minimum capacity
+     */
+    explicit MpscQueue(std::size_t capacity);
+
+    /**
+     * Push a value from any thread without waiting.
+     *
+     * @param value the value
+     * @return whether the value was pushed, or false if the queue is full
+     */
+    bool push(T value);
+
+    /**
+     * Pop a value from the consumer thread, waiting for up to the deadline.
+     *
+     * @param deadline when to stop waiting
+     * @return the value, or nothing if the deadline passed or the consumer
+     *         was woken by `wake`
+     */
+    std::optional<T> pop_until(std::chrono::steady_clock::time_point deadline);
+
+    /**
+     * Wake the consumer if it is waiting, without pushing a value.
+     */
+    void wake();
+
+private:
+    struct Cell {
+        std::atomic<std::size_t> sequence;
+        std::optional<T> value;
+    };
+
+    std::vector<Cell> cells_;
+    std::size_t mask_;
+    std::atomic<std::size_t> tail_{0};
+    std::size_t head_{0};
+    std::counting_semaphore<> available_{0};
+};
+
+/**
+ * A bounded lock-free queue with a single producer and a single consumer,
+ * where the consumer blocks on a semaphore while the queue is empty.
+ *
+ * @tparam T the type of values
+ */
+template <typename T>
+class SpscQueue {
+public:
+    /**
+     * Create a queue which holds at least `capacity` values.
+     *
+     * @param capacity the minimum capacity
+     */
+    explicit SpscQueue(std::size_t capacity);
+
+    /**
+     * Push a value from the producer thread without waiting.
+     *
+     * @param value the value
+     * @return whether the value was pushed, or false if the queue is full
+     */
+    bool push(T value);
+
+    /**
+     * Pop a value from the consumer thread, waiting until one is pushed.
+     *
+     * @return the value
+     */
+    T pop();
+
+private:
+    std::vector<std::optional<T>> values_;
+    std::size_t mask_;
+    std::atomic<std::size_t> head_{0};
+    std::atomic<std::size_t> tail_{0};
+    std::counting_semaphore<> available_{0};
+};
+
+/**
+ * Restores the order of values which arrive out of order, where each value
+ * is keyed by its position. Values are released as soon as every value
+ * before them has arrived.
+ *
+ * @tparam T the type of values
+ */
+template <typename T>
+class ReorderBuffer {
+public:
+    /**
+     * Create a buffer for values at positions `0` to `size - 1`.
+     *
+     * @param size the number of values
+     */
+    explicit ReorderBuffer(std::size_t size);
+
+    /**
+     * Insert the value at a position.
+     *
+     * @param position the position
+     * @param value the value
+     */
+    void insert(std::size_t position, T value);
+
+    /**
+     * Take the value at the next position if it has arrived.
+     *
+     * @return the value, or nothing if it has not arrived
+     */
+    std::optional<T> pop();
+
+    /**
+     * Get the position of the next value to take.
+     *
+     * @return the next position
+     */
+    [[nodiscard]] std::size_t next() const;
+
+private:
+    std::vector<std::optional<T>> values_;
+    std::size_t next_{0};
+};
+
+template <typename T>
+MpscQueue<T>::MpscQueue(std::size_t capacity)
+    : cells_(std::bit_ceil(std::max(capacity, std::size_t{1}))),
+      mask_{cells_.size() - 1} {
+    for (std::size_t i = 0; i < cells_.size(); i++) {
+        cells_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+template <typename T>
+bool MpscQueue<T>::push(T value) {
+    // A cell is free for the producer at `position` when its sequence equals
+    // the position, and holds a value when it is one past the position.
+    auto position = tail_.load(std::memory_order_relaxed);
+    Cell* cell = nullptr;
+    while (true) {
+        cell = &cells_[position & mask_];
+        auto sequence = cell->sequence.load(std::memory_order_acquire);
+        auto difference = static_cast<std::ptrdiff_t>(sequence - position);
+        if (difference == 0) {
+            if (tail_.compare_exchange_weak(
+                    position, position + 1, std::memory_order_relaxed
+                )) {
+                break;
+            }
+        } else if (difference < 0) {
+            return false;
+        } else {
+            position = tail_.load(std::memory_order_relaxed);
+        }
+    }
+
+    cell->value = std::move(value);
+    cell->sequence.store(position + 1, std::memory_order_release);
+    available_.release();
+    return true;
+}
+
+template <typename T>
+std::optional<T> MpscQueue<T>::pop_until(
+    std::chrono::steady_clock::time_point deadline
+) {
+    if (!available_.try_acquire_until(deadline)) {
+        return {};
+    }
+
+    auto& cell = cells_[head_ & mask_];
+    while (cell.sequence.load(std::memory_order_acquire) != head_ + 1) {
+        // Without a claimed cell, the consumer was woken by `wake`.
+        if (tail_.load(std::memory_order_relaxed) == head_) {
+            return {};
+        }
+        // Otherwise, a later producer published first and its permit was
+        // taken, so wait for the producer of the head to publish rather
+        // than lose the permit.
+        std::this_thread::yield();
+    }
+
+    auto value = std::move(cell.value);
+    cell.value.reset();
+    cell.sequence.store(head_ + mask_ + 1, std::memory_order_release);
+    head_++;
+    return value;
+}
+
+template <typename T>
+void MpscQueue<T>::wake() {
+    available_.release();
+}
+
+template <typename T>
+SpscQueue<T>::SpscQueue(std::size_t capacity)
+    : values_(std::bit_ceil(std::max(capacity, std::size_t{1}))),
+      mask_{values_.size() - 1} {}
+
+template <typename T>
+bool SpscQueue<T>::push(T value) {
+    auto tail = tail_.load(std::memory_order_relaxed);
+    if (tail - head_.load(std::memory_order_acquire) == values_.size()) {
+        return false;
+    }
+
+    values_[tail & mask_] = std::move(value);
+    tail_.store(tail + 1, std::memory_order_release);
+    available_.release();
+    return true;
+}
+
+template <typename T>
+T SpscQueue<T>::pop() {
+    available_.acquire();
+
+    auto head = head_.load(std::memory_order_relaxed);
+    auto& slot = values_[head & mask_];
+    T value = std::move(*slot);
+    slot.reset();
+    head_.store(head + 1, std::memory_order_release);
+    return value;
+}
+
+template <typename T>
+ReorderBuffer<T>::ReorderBuffer(std::size_t size) : values_(size) {}
+
+template <typename T>
+void ReorderBuffer<T>::insert(std::size_t position, T value) {
+    values_.at(position) = std::move(value);
+}
+
+template <typename T>
+std::optional<T> ReorderBuffer<T>::pop() {
+    if (next_ == values_.size() || !values_[next_].has_value()) {
+        return {};
+    }
+
+    auto value = std::move(values_[next_]);
+    values_[next_].reset();
+    next_++;
+    return value;
+}
+
+template <typename T>
+std::size_t ReorderBuffer<T>::next() const {
+    return next_;
+}
+
+} // namespace evlist
+
+#endif // EVLIST_PIPELINE_H
@@ -0,0 +1,119 @@
+/**
+ * @file plan.h
+ *
+ * Contains definitions for ordering the evaluation of filters by their cost.
+ */
+
+#ifndef EVLIST_PLAN_H
+#define EVLIST_PLAN_H
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <regex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "evlist/cli.h"
+#include "evlist/device.h"
+#include "evlist/glob.h"
+#include "evlist/memo.h"
+
+/**
+ * The namespace for this project.
+ */
+namespace evlist {
+
+/**
+ * A plan for evaluating a conjunction of filters, such as from `--filter`.
+ * Since a device must match every filter, the order of evaluation does not
+ * change the result, so cheap and selective filters are evaluated first.
+ *
+ * Filters are initially ordered by an estimated cost, where equality or a
+ * prefix is cheaper than a glob or substring, these are cheaper than a regex,
+ * and a single value is cheaper than the list of capabilities. The order is
+ * then refined using the observed rate at which each filter rejects devices,
+ * so that a filter is ranked by its cost divided by its rejection rate.
+ *
+ * Regex results on columns whose values repeat are memoised per distinct
+ * value, so a value shared by many devices, such as a capability, is only
+ * searched once per filter.
+ */
+class FilterPlan {
+public:
+    /**
+     * The number of devices which are evaluated between reordering filters.
+     */
+    static constexpr std::size_t REPLAN_INTERVAL{16};
+
+    /**
+     * Create a plan, compiling each regex or glob once.
+     *
+     * @param filter the filters which a device must all match
+     * @param use_regex whether to compare `FilterOperator::EQUAL` filters
+     *        using a regex instead of equality
+     * @param use_glob whether to compare `FilterOperator::EQUAL` filters
+     *        using a glob instead of equality, which is ignored if
+     *        `use_regex` is set
+     * @throws std::regex_error if a filter is an invalid regex
+     */
+    FilterPlan(
+        const std::vector<FilterTerm>& filter,
+        bool use_regex,
+        bool use_glob = false
+    );
+
+    /**
+     * Check whether a device matches every filter, recording how often each
+     * evaluated filter rejects devices.
+     *
+     * @param device the device
+     * @return whether the device matches
+     */
+    [[nodiscard]] bool matches(const InputDevice& device);
+
+    /**
+     * Get the current order of evaluation.
+     *
+     * @return the indices of the filters in the order they are evaluated
+     */
+    [[nodiscard]] std::vector<std::size_t> order() const;
+
+    /**
+     * Get the estimated relative cost of evaluating a filter on a device.
+     *
+     * @param column the filtered column
+     * @param regex whether the filter is a regex
+     * @param glob whether the filter is a glob
+     * @return estimated cost
+     */
+    [[nodiscard]] static double cost(
+        Filter column, bool regex, bool glob = false
+    );
+
+private:
+    struct Step {
+        std::size_t index;
+        Filter column;
+        std::string value;
+        FilterOperator op;
+        std::optional<std::regex> regex;
+        std::optional<Glob> glob;
+        double cost;
+        uint64_t evaluated{0};
+        uint64_t rejected{0};
+        PredicateMemo memo{};
+    };
+
+    std::vector<Step> steps_;
+    std::size_t until_replan_{REPLAN_INTERVAL};
+
+    [[nodiscard]] static bool evaluate(const InputDevice& device, Step& step);
+    [[nodiscard]] static double rank(const Step& step);
+    void replan();
+};
+
+} // namespace evlist
+
+#endif // EVLIST_PLAN_H
@@ -0,0 +1,202 @@
+/**
+ * @file queries.h
+ *
+ * Contains definitions for evaluating several named queries over devices in a
+ * single pass.
+ */
+
+#ifndef EVLIST_QUERIES_H
+#define EVLIST_QUERIES_H
+
+#include <array>
+#include <cstddef>
+#include <format>
+#include <optional>
+#include <regex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "evlist/cli.h"
+#include "evlist/device.h"
+#include "evlist/glob.h"
+#include "evlist/memo.h"
+#include "evlist/format.h"
+
+/**
+ * The namespace for this project.
+ */
+namespace evlist {
+
+/**
+ * The devices matched by each query of `evlist::DeviceQueries`. The results
+ * point into the evaluated devices, so they are valid until the devices are
+ * modified.
+ */
+class DeviceQueryResults {
+public:
+    /**
+     * The name of the header for the query name.
+     */
+    static constexpr std::string_view HEADER_QUERY = "QUERY";
+
+    /**
+     * Create the query results.
+     *
+     * @param output_format the output format
+     * @param names the query names
+     * @param matches the devices matched by each query
+     */
+    DeviceQueryResults(
+        Format output_format,
+        std::vector<std::string> names,
+        std::vector<std::vector<const InputDevice*>> matches
+    );
+
+    /**
+     * Get the query names, in the order that queries were given.
+     *
+     * @return query names
+     */
+    [[nodiscard]] const std::vector<std::string>& names() const;
+
+    /**
+     * Get the devices matched by a query, in the order of the devices.
+     *
+     * @param query the query index
+     * @return matched devices
+     */
+    [[nodiscard]] const std::vector<const InputDevice*>& matches(
+        std::size_t query
+    ) const;
+
+    /**
+     * Get the output format.
+     *
+     * @return output format
+     */
+    [[nodiscard]] Format output_format() const;
+
+private:
+    Format output_format_{Format::TABLE};
+    std::vector<std::string> names_;
+    std::vector<std::vector<const InputDevice*>> matches_;
+};
+
+/**
+ * A set of named queries which are evaluated together. Filters which are
+ * shared between queries are deduplicated into a single predicate, which is
+ * evaluated at most once per device. Regex predicates on columns whose
+ * values repeat are also memoised per distinct value across devices.
+ */
+class DeviceQueries {
+public:
+    /**
+     * Create the queries, compiling each distinct regex or glob once.
+     *
+     * @param queries the queries
+     * @param use_regex whether to compare filters using regex
+     * @param use_glob whether to compare filters using a glob, which is
+     *        ignored if `use_regex` is set
+     * @throws std::regex_error if a filter is an invalid regex
+     */
+    DeviceQueries(
+        const std::vector<DeviceQuery>& queries,
+        bool use_regex,
+        bool use_glob = false
+    );
+
+    /**
+     * Evaluate every query in a single pass over the devices.
+     *
+     * @param devices the devices
+     * @return the devices matched by each query
+     */
+    [[nodiscard]] DeviceQueryResults evaluate(const InputDevices& devices
+    ) const;
+
+    /**
+     * Get the number of distinct predicates across all queries.
+     *
+     * @return number of predicates
+     */
+    [[nodiscard]] std::size_t predicates() const;
+
+private:
+    struct Predicate {
+        Filter column;
+        std::string value;
+        FilterOperator op;
+        std::optional<std::regex> regex;
+        std::optional<Glob> glob;
+    };
+
+    std::vector<std::string> names_;
+    std::vector<Predicate> predicates_;
+    std::vector<std::vector<std::size_t>> queries_;
+
+    [[nodiscard]] bool matches(
+        const InputDevice& device,
+        const Predicate& predicate,
+        PredicateMemo& memo
+    ) const;
+};
+
+} // namespace evlist
+
+/**
+ * Defines the
+ * [`std:formatter`](https://en.cppreference.com/w/cpp/utility/format/formatter)
+ * for formatting `evlist::DeviceQueryResults`. Each matched device is output
+ * as a row labelled by its query.
+ */
+template <>
+struct std::formatter<evlist::DeviceQueryResults> {
+    /**
+     * Parse the results by beginning a new iterator from the context.
+     *
+     * @param ctx formatting context
+     * @return output iterator
+     */
+    static constexpr auto parse(const std::format_parse_context& ctx) {
+        return ctx.begin();
+    }
+
+    /**
+     * Format the results based on the output `Format`.
+     *
+     * @tparam Context context type
+     * @param results query results
+     * @param ctx context parameter
+     * @return iterator after formatting
+     */
+    template <typename Context>
+    // NOLINTNEXTLINE(runtime/references)
+    constexpr auto format(
+        const evlist::DeviceQueryResults& results, Context& ctx
+    ) const {
+        constexpr auto& COLUMNS = evlist::InputDevices::COLUMNS;
+        using Row = std::array<std::string, COLUMNS.size() + 1>;
+
+        std::vector<Row> rows{};
+        auto& header = rows.emplace_back();
+        header[0] = evlist::DeviceQueryResults::HEADER_QUERY;
+        for (std::size_t i = 0; i < COLUMNS.size(); i++) {
+            header.at(i + 1) = evlist::InputDevices::header(COLUMNS.at(i));
+        }
+
+        for (std::size_t query = 0; query < results.names().size(); query++) {
+            for (const auto* device : results.matches(query)) {
+                auto& row = rows.emplace_back();
+                row[0] = results.names()[query];
+                for (std::size_t i = 0; i < COLUMNS.size(); i++) {
+                    row.at(i + 1) = device->value(COLUMNS.at(i));
+                }
+            }
+        }
+
+        return evlist::format_rows(ctx, results.output_format(), rows);
+    }
+};
+
+#endif // EVLIST_QUERIES_H
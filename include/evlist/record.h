@@ -0,0 +1,308 @@
+/**
+ * @file record.h
+ *
+ * Contains definitions for recording input events into a memory-mapped
+ * ring buffer file.
+ */
+
+#ifndef EVLIST_RECORD_H
+#define EVLIST_RECORD_H
+
+#include <linux/input.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <filesystem>
+#include <span>
+#include <system_error>
+#include <vector>
+
+#include "evlist/device.h"
+
+/**
+ * The namespace for this project.
+ */
+namespace evlist {
+
+/**
+ * An input event tagged with the index of the device that it was read from.
+ * This has a fixed layout so that recordings do not depend on the layout of
+ * `input_event` on the recording machine.
+ */
+struct EventRecord {
+    /**
+     * The seconds of the kernel timestamp.
+     */
+    int64_t seconds;
+    /**
+     * The microseconds of the kernel timestamp.
+     */
+    int64_t microseconds;
+    /**
+     * The index of the device in the recording.
+     */
+    uint32_t device;
+    /**
+     * The event type.
+     */
+    uint16_t type;
+    /**
+     * The event code.
+     */
+    uint16_t code;
+    /**
+     * The event value.
+     */
+    int32_t value;
+    /**
+     * Reserved for future use.
+     */
+    uint32_t reserved;
+
+    /**
+     * Compare equality by each field.
+     *
+     * @param other compare to
+     * @return whether records are equal
+     */
+    bool operator==(const EventRecord& other) const = default;
+};
+
+static_assert(sizeof(EventRecord) == 32);
+
+/**
+ * The header at the start of a recording file.
+ */
+struct RecordingHeader {
+    /**
+     * The magic bytes identifying a recording.
+     */
+    static constexpr std::array<char, 8> MAGIC{
+        'E', 'V', 'L', 'I', 'S', 'T', 'R', 'B'
+    };
+
+    /**
+     * The current version of the recording format.
+     */
+    static constexpr uint32_t VERSION{1};
+
+    /**
+     * The magic bytes.
+     */
+    std::array<char, 8> magic;
+    /**
+     * The version of the recording format.
+     */
+    uint32_t version;
+    /**
+     * The number of devices in the recording.
+     */
+    uint32_t devices;
+    /**
+     * The offset of the device metadata, which is the CSV output of the
+     * recorded devices in the order of their device index.
+     */
+    uint64_t metadata_offset;
+    /**
+     * The size of the device metadata.
+     */
+    uint64_t metadata_size;
+    /**
+     * The offset of the ring buffer of `evlist::EventRecord`.
+     */
+    uint64_t records_offset;
+    /**
+     * The number of records that fit in the ring buffer.
+     */
+    uint64_t capacity;
+    /**
+     * The total number of records written, which is updated atomically after
+     * each batch. The next record is written at `head % capacity`.
+     */
+    uint64_t head;
+};
+
+/**
+ * A memory mapping which is unmapped when destroyed.
+ */
+class MemoryMap {
+public:
+    /**
+     * Create an empty mapping.
+     */
+    MemoryMap() = default;
+
+    /**
+     * Map a file.
+     *
+     * @param descriptor the file descriptor to map
+     * @param size the size of the mapping
+     * @param writable whether to map the file for writing
+     * @return the mapping or an error if `mmap` failed
+     */
+    [[nodiscard]] static std::expected<MemoryMap, std::system_error> map(
+        int descriptor, std::size_t size, bool writable
+    );
+
+    /**
+     * Unmap the file.
+     */
+    ~MemoryMap();
+
+    MemoryMap(const MemoryMap&) = delete;
+    MemoryMap& operator=(const MemoryMap&) = delete;
+
+    /**
+     * Move the mapping.
+     *
+     * @param other move from
+     */
+    MemoryMap(MemoryMap&& other) noexcept;
+
+    /**
+     * Move the mapping, unmapping the current one.
+     *
+     * @param other move from
+     * @return this instance of `MemoryMap`
+     */
+    MemoryMap& operator=(MemoryMap&& other) noexcept;
+
+    /**
+     * Get the mapped bytes.
+     *
+     * @return mapped bytes
+     */
+    [[nodiscard]] std::span<std::byte> data() const;
+
+private:
+    MemoryMap(std::byte* data, std::size_t size);
+
+    std::byte* data_{nullptr};
+    std::size_t size_{0};
+};
+
+/**
+ * Records input events from multiple devices into a memory-mapped ring
+ * buffer file. When the ring buffer is full, the oldest events are
+ * overwritten.
+ */
+class EventRecorder {
+public:
+    /**
+     * The default number of events that fit in the ring buffer.
+     */
+    static constexpr std::size_t DEFAULT_CAPACITY{1UL << 20U};
+
+    /**
+     * Create a recording file, replacing any existing file.
+     *
+     * @param path the path of the recording
+     * @param devices the devices being recorded, in the order of their
+     *        device index
+     * @param capacity the number of events that fit in the ring buffer
+     * @return the recorder or an error if the file could not be created
+     */
+    [[nodiscard]] static std::expected<EventRecorder, std::system_error>
+    create(
+        const fs::path& path,
+        const std::vector<InputDevice>& devices,
+        std::size_t capacity = DEFAULT_CAPACITY
+    );
+
+    /**
+     * Append a batch of events to the ring buffer. This does not allocate or
+     * make any system calls.
+     *
+     * @param device the device index
+     * @param events the events read from the device
+     */
+    void append(std::size_t device, std::span<const input_event> events
+    ) noexcept;
+
+    /**
+     * Flush the recording to the file.
+     *
+     * @return an error if flushing failed
+     */
+    std::expected<void, std::system_error> sync();
+
+    /**
+     * Get the total number of events written, including those which have
+     * been overwritten.
+     *
+     * @return number of events written
+     */
+    [[nodiscard]] uint64_t written() const;
+
+private:
+    explicit EventRecorder(MemoryMap map);
+
+    MemoryMap map_;
+    RecordingHeader* header_{nullptr};
+    std::span<EventRecord> records_;
+};
+
+/**
+ * Reads a recording created by `evlist::EventRecorder`.
+ */
+class EventRecording {
+public:
+    /**
+     * Open a recording.
+     *
+     * @param path the path of the recording
+     * @return the recording or an error if the file could not be read or is
+     *         not a valid recording
+     */
+    [[nodiscard]] static std::expected<EventRecording, std::system_error> open(
+        const fs::path& path
+    );
+
+    /**
+     * Get the recorded devices, in the order of their device index.
+     *
+     * @return recorded devices
+     */
+    [[nodiscard]] const std::vector<InputDevice>& devices() const;
+
+    /**
+     * Get the total number of events written, including those which have
+     * been overwritten.
+     *
+     * @return number of events written
+     */
+    [[nodiscard]] uint64_t written() const;
+
+    /**
+     * Get the number of events which were overwritten because the ring
+     * buffer was full.
+     *
+     * @return number of overwritten events
+     */
+    [[nodiscard]] uint64_t overwritten() const;
+
+    /**
+     * Get the events in the ring buffer, from oldest to newest.
+     *
+     * @return recorded events
+     */
+    [[nodiscard]] std::vector<EventRecord> records() const;
+
+private:
+    EventRecording(
+        MemoryMap map,
+        const RecordingHeader* header,
+        std::vector<InputDevice> devices
+    );
+
+    MemoryMap map_;
+    const RecordingHeader* header_{nullptr};
+    std::span<const EventRecord> records_;
+    std::vector<InputDevice> devices_;
+};
+
+} // namespace evlist
+
+#endif // EVLIST_RECORD_H
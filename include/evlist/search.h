@@ -0,0 +1,60 @@
+/**
+ * @file search.h
+ *
+ * Contains definitions for vectorised string comparisons used by filter
+ * operators.
+ */
+
+#ifndef EVLIST_SEARCH_H
+#define EVLIST_SEARCH_H
+
+#include <string_view>
+
+#include "evlist/cli.h"
+
+/**
+ * The namespace for this project.
+ */
+namespace evlist {
+
+/**
+ * Check whether a value contains a substring. On x86, blocks of the value are
+ * compared against the first and last characters of the substring using AVX2
+ * if the CPU supports it and SSE2 otherwise, and only candidate positions are
+ * compared in full. Other architectures use `std::string_view::find`.
+ *
+ * @param value the value to search
+ * @param substring the substring to search for
+ * @return whether the value contains the substring
+ */
+[[nodiscard]] bool contains(std::string_view value, std::string_view substring);
+
+/**
+ * Check whether two values are equal ignoring ASCII case. On x86, blocks of
+ * both values are case folded and compared using AVX2 if the CPU supports it
+ * and SSE2 otherwise.
+ *
+ * @param lhs the first value
+ * @param rhs the second value
+ * @return whether the values are equal ignoring case
+ */
+[[nodiscard]] bool equals_ignore_case(
+    std::string_view lhs, std::string_view rhs
+);
+
+/**
+ * Compare a column value against a filter value using a filter operator,
+ * where `FilterOperator::EQUAL` compares for exact equality.
+ *
+ * @param op the filter operator
+ * @param column the column value
+ * @param value the filter value
+ * @return whether the column value matches
+ */
+[[nodiscard]] bool compare(
+    FilterOperator op, std::string_view column, std::string_view value
+);
+
+} // namespace evlist
+
+#endif // EVLIST_SEARCH_H
@@ -0,0 +1,141 @@
+/**
+ * @file snapshot.h
+ *
+ * Contains definitions for sharing immutable snapshots of input devices
+ * between threads.
+ */
+
+#ifndef EVLIST_SNAPSHOT_H
+#define EVLIST_SNAPSHOT_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <expected>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string_view>
+
+#include "evlist/device.h"
+#include "evlist/list.h"
+
+/**
+ * The namespace for this project.
+ */
+namespace evlist {
+
+/**
+ * Shares immutable snapshots of input devices between a thread which
+ * refreshes them and any number of threads which read them, similar to
+ * read-copy-update.
+ *
+ * Reading a snapshot is wait-free: it copies a `std::shared_ptr` using a
+ * fixed number of atomic operations, and never waits on a refresh or on other
+ * readers. Snapshots are protected using the left-right technique, where the
+ * latest snapshot is published in one of two slots while readers announce
+ * themselves on one of two sets of counters. Publishing waits until no reader
+ * can still be copying the previous slot before releasing it, so publishing
+ * blocks but reading does not. A reader keeps its snapshot alive for as long
+ * as it holds the pointer, even after newer snapshots are published.
+ */
+class InputDevicesSnapshot {
+public:
+    /**
+     * The number of counters that readers announce themselves on for each
+     * set, so that readers on different threads rarely share a cache line.
+     */
+    static constexpr std::size_t STRIPES{16};
+
+    /**
+     * Create a snapshot holder which initially holds no devices.
+     */
+    InputDevicesSnapshot();
+
+    /**
+     * Create a snapshot holder which initially holds the devices.
+     *
+     * @param devices the initial devices
+     */
+    explicit InputDevicesSnapshot(InputDevices devices);
+
+    InputDevicesSnapshot(const InputDevicesSnapshot&) = delete;
+    InputDevicesSnapshot(InputDevicesSnapshot&&) = delete;
+    InputDevicesSnapshot& operator=(const InputDevicesSnapshot&) = delete;
+    InputDevicesSnapshot& operator=(InputDevicesSnapshot&&) = delete;
+    ~InputDevicesSnapshot() = default;
+
+    /**
+     * Get the latest snapshot without waiting.
+     *
+     * @return the latest snapshot
+     */
+    [[nodiscard]] std::shared_ptr<const InputDevices> load() const;
+
+    /**
+     * Publish a new snapshot, which readers get from `load` once this
+     * returns. This waits for readers which may still be copying the previous
+     * snapshot, and concurrent calls are serialised.
+     *
+     * @param devices the devices to publish
+     */
+    void publish(InputDevices devices);
+
+    /**
+     * List devices and publish them as a new snapshot. The previous snapshot
+     * remains if listing fails.
+     *
+     * @param lister the lister to list devices with
+     * @return nothing or an error listing devices
+     */
+    std::expected<void, std::filesystem::filesystem_error> refresh(
+        const InputDeviceLister& lister
+    );
+
+    /**
+     * Publish a new snapshot with a single device added, replaced or removed,
+     * so that a hotplugged device does not need every device to be listed
+     * again. The other devices are copied from the latest snapshot, and the
+     * device is kept in natural sort order.
+     *
+     * @param name the file name of the device, such as `event5`
+     * @param device the device to add or replace, or nothing to remove it
+     */
+    void update(std::string_view name, std::optional<InputDevice> device);
+
+    /**
+     * Get the number of snapshots that have been published, which readers can
+     * use to check whether their snapshot is out of date.
+     *
+     * @return number of published snapshots
+     */
+    [[nodiscard]] std::size_t generation() const;
+
+private:
+    // A fixed cache line size, since `hardware_destructive_interference_size`
+    // is not stable across compiler flags and so warns in public headers.
+    static constexpr std::size_t CACHE_LINE{64};
+
+    struct alignas(CACHE_LINE) Counter {
+        std::atomic<std::size_t> readers{0};
+    };
+    using Counters = std::array<Counter, STRIPES>;
+
+    std::array<std::shared_ptr<const InputDevices>, 2> slots_;
+    std::atomic<std::size_t> slot_{0};
+
+    mutable std::array<Counters, 2> counters_{};
+    std::atomic<std::size_t> counters_index_{0};
+
+    std::atomic<std::size_t> generation_{0};
+    std::mutex publish_mutex_;
+
+    static std::size_t stripe();
+    void wait_for_readers(std::size_t index) const;
+    void replace(std::shared_ptr<const InputDevices> snapshot);
+};
+
+} // namespace evlist
+
+#endif // EVLIST_SNAPSHOT_H
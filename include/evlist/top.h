@@ -0,0 +1,258 @@
+/**
+ * @file top.h
+ *
+ * Contains definitions for monitoring the rate of input events per device.
+ */
+
+#ifndef EVLIST_TOP_H
+#define EVLIST_TOP_H
+
+#include <linux/input.h>
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "evlist/cli.h"
+#include "evlist/codes.h"
+#include "evlist/device.h"
+#include "evlist/format.h"
+
+/**
+ * The namespace for this project.
+ */
+namespace evlist {
+
+/**
+ * Counts of input events read from a single device.
+ */
+class EventCounts {
+public:
+    /**
+     * Count a batch of events. This does not allocate.
+     *
+     * @param events the events read from the device
+     */
+    void record(std::span<const input_event> events) noexcept;
+
+    /**
+     * Reset all counts to zero.
+     */
+    void reset() noexcept;
+
+    /**
+     * Get the total number of events.
+     *
+     * @return number of events
+     */
+    [[nodiscard]] uint64_t events() const;
+
+    /**
+     * Get the number of `SYN_DROPPED` events, which indicate that the kernel
+     * buffer overflowed and events were lost.
+     *
+     * @return number of dropped syncs
+     */
+    [[nodiscard]] uint64_t syn_dropped() const;
+
+    /**
+     * Get the number of events of each type, indexed by the event type.
+     *
+     * @return number of events by type
+     */
+    [[nodiscard]] const std::array<uint64_t, EV_CNT>& types() const;
+
+private:
+    uint64_t events_{0};
+    uint64_t syn_dropped_{0};
+    std::array<uint64_t, EV_CNT> types_{};
+};
+
+/**
+ * Tracks the rate of input events for a set of devices over fixed intervals,
+ * such as for `--top`.
+ */
+class EventRates {
+public:
+    /**
+     * The name of the header for the device path.
+     */
+    static constexpr std::string_view HEADER_DEVICE_PATH =
+        InputDevices::HEADER_DEVICE_PATH;
+
+    /**
+     * The name of the header for the device name.
+     */
+    static constexpr std::string_view HEADER_NAME = InputDevices::HEADER_NAME;
+
+    /**
+     * The name of the header for the rate of events.
+     */
+    static constexpr std::string_view HEADER_RATE = "EVENTS_PER_SEC";
+
+    /**
+     * The name of the header for the number of dropped syncs.
+     */
+    static constexpr std::string_view HEADER_SYN_DROPPED = "SYN_DROPPED";
+
+    /**
+     * The name of the header for the breakdown of event types.
+     */
+    static constexpr std::string_view HEADER_TYPES = "TYPES";
+
+    /**
+     * Create the event rates.
+     *
+     * @param output_format the output format
+     * @param devices the devices being monitored, in the order of their
+     *        device index
+     */
+    EventRates(Format output_format, std::vector<InputDevice> devices);
+
+    /**
+     * Count a batch of events for the current interval. This does not
+     * allocate.
+     *
+     * @param device the device index
+     * @param events the events read from the device
+     */
+    void record(std::size_t device, std::span<const input_event> events);
+
+    /**
+     * Finish the current interval, computing the rates of each device and
+     * starting a new interval.
+     *
+     * @param elapsed the length of the interval
+     */
+    void finish_interval(std::chrono::duration<double> elapsed);
+
+    /**
+     * Get the devices being monitored.
+     *
+     * @return devices
+     */
+    [[nodiscard]] const std::vector<InputDevice>& devices() const;
+
+    /**
+     * Get the device indices of the last finished interval sorted by their
+     * rate, from highest to lowest.
+     *
+     * @return sorted device indices
+     */
+    [[nodiscard]] const std::vector<std::size_t>& order() const;
+
+    /**
+     * Get the counts of a device in the last finished interval.
+     *
+     * @param device the device index
+     * @return the event counts
+     */
+    [[nodiscard]] const EventCounts& counts(std::size_t device) const;
+
+    /**
+     * Get the rate of events per second of a device in the last finished
+     * interval.
+     *
+     * @param device the device index
+     * @return events per second
+     */
+    [[nodiscard]] double rate(std::size_t device) const;
+
+    /**
+     * Get the output format.
+     *
+     * @return output format
+     */
+    [[nodiscard]] Format output_format() const;
+
+private:
+    Format output_format_{Format::TABLE};
+    std::vector<InputDevice> devices_;
+    std::vector<EventCounts> current_;
+    std::vector<EventCounts> finished_;
+    std::vector<std::size_t> order_;
+    std::chrono::duration<double> elapsed_{};
+};
+
+} // namespace evlist
+
+/**
+ * Defines the
+ * [`std:formatter`](https://en.cppreference.com/w/cpp/utility/format/formatter)
+ * for formatting the last finished interval of `evlist::EventRates`.
+ */
+template <>
+struct std::formatter<evlist::EventRates> {
+    /**
+     * Parse the event rates by beginning a new iterator from the context.
+     *
+     * @param ctx formatting context
+     * @return output iterator
+     */
+    static constexpr auto parse(const std::format_parse_context& ctx) {
+        return ctx.begin();
+    }
+
+    /**
+     * Format the event rates based on the output `Format`.
+     *
+     * @tparam Context context type
+     * @param rates event rates
+     * @param ctx context parameter
+     * @return iterator after formatting
+     */
+    template <typename Context>
+    // NOLINTNEXTLINE(runtime/references)
+    constexpr auto format(const evlist::EventRates& rates, Context& ctx) const {
+        using Row = std::array<std::string, 5>;
+
+        std::vector<Row> rows{};
+        rows.emplace_back(Row{
+            std::string{evlist::EventRates::HEADER_DEVICE_PATH},
+            std::string{evlist::EventRates::HEADER_NAME},
+            std::string{evlist::EventRates::HEADER_RATE},
+            std::string{evlist::EventRates::HEADER_SYN_DROPPED},
+            std::string{evlist::EventRates::HEADER_TYPES}
+        });
+        for (const auto device : rates.order()) {
+            const auto& counts = rates.counts(device);
+
+            std::string types{};
+            for (uint16_t type = 0; type < counts.types().size(); type++) {
+                auto count = counts.types().at(type);
+                if (count == 0) {
+                    continue;
+                }
+
+                auto name =
+                    evlist::EventCodes::name(evlist::CodeType::EV, type);
+                if (!types.empty()) {
+                    types += ", ";
+                }
+                if (name.has_value()) {
+                    types += std::format("{}={}", *name, count);
+                } else {
+                    types += std::format("{}={}", type, count);
+                }
+            }
+
+            rows.emplace_back(Row{
+                rates.devices().at(device).device_path().string(),
+                rates.devices().at(device).name(),
+                std::format("{:.1f}", rates.rate(device)),
+                std::format("{}", counts.syn_dropped()),
+                std::move(types)
+            });
+        }
+
+        return evlist::format_rows(ctx, rates.output_format(), rows);
+    }
+};
+
+#endif // EVLIST_TOP_H
@@ -0,0 +1,616 @@
+#include "evlist/archive.h"
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <charconv>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <expected>
+#include <format>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include "evlist/cli.h"
+#include "evlist/codes.h"
+#include "evlist/device.h"
+#include "evlist/record.h"
+
+namespace {
+
+constexpr int64_t MICROSECONDS{1'000'000};
+constexpr uint64_t CONTINUATION_BITS{0x8080808080808080ULL};
+constexpr std::size_t WORD_SIZE{sizeof(uint64_t)};
+constexpr uint8_t VARINT_BITS{7};
+constexpr uint8_t VARINT_MASK{0x7F};
+constexpr uint8_t VARINT_CONTINUATION{0x80};
+
+/**
+ * The fixed size header at the start of an archive, followed by the device
+ * metadata and then each block index entry and its columns.
+ */
+struct Header {
+    std::array<char, 8> magic;
+    uint32_t version;
+    uint32_t devices;
+    uint64_t metadata_size;
+    uint64_t blocks;
+};
+
+std::system_error invalid_archive() {
+    return std::system_error{
+        std::make_error_code(std::errc::invalid_argument),
+        "not a valid archive"
+    };
+}
+
+template <typename T>
+void put(std::string& out, const T& value) {
+    std::array<char, sizeof(T)> bytes{};
+    std::memcpy(bytes.data(), &value, sizeof(T));
+    out.append(bytes.data(), bytes.size());
+}
+
+template <typename T>
+bool get(std::string_view bytes, std::size_t& offset, T& value) {
+    if (bytes.size() - offset < sizeof(T)) {
+        return false;
+    }
+    std::memcpy(&value, bytes.substr(offset).data(), sizeof(T));
+    offset += sizeof(T);
+    return true;
+}
+
+void put_varint(std::string& out, uint64_t value) {
+    while (value >= VARINT_CONTINUATION) {
+        out.push_back(
+            static_cast<char>((value & VARINT_MASK) | VARINT_CONTINUATION)
+        );
+        value >>= VARINT_BITS;
+    }
+    out.push_back(static_cast<char>(value));
+}
+
+uint64_t zigzag(int64_t value) {
+    constexpr auto SIGN = std::numeric_limits<int64_t>::digits;
+    return (static_cast<uint64_t>(value) << 1U) ^
+           static_cast<uint64_t>(value >> SIGN);
+}
+
+int64_t unzigzag(uint64_t value) {
+    return static_cast<int64_t>(value >> 1U) ^
+           -static_cast<int64_t>(value & 1U);
+}
+
+/**
+ * Decode `out.size()` varints. Runs of single byte varints, which are common
+ * for types, codes and small deltas, are decoded a word at a time. Missing
+ * bytes at the end of a truncated column decode as zero.
+ */
+void decode_varints(std::string_view bytes, std::vector<uint64_t>& out) {
+    std::size_t position = 0;
+    std::size_t i = 0;
+    while (i < out.size()) {
+        if (out.size() - i >= WORD_SIZE &&
+            bytes.size() - position >= WORD_SIZE) {
+            uint64_t word{};
+            std::memcpy(&word, bytes.substr(position).data(), WORD_SIZE);
+            if ((word & CONTINUATION_BITS) == 0) {
+                for (std::size_t j = 0; j < WORD_SIZE; j++) {
+                    out[i + j] = static_cast<uint8_t>(bytes[position + j]);
+                }
+                i += WORD_SIZE;
+                position += WORD_SIZE;
+                continue;
+            }
+        }
+
+        uint64_t value = 0;
+        unsigned shift = 0;
+        while (position < bytes.size()) {
+            auto byte = static_cast<uint8_t>(bytes[position++]);
+            if (shift < std::numeric_limits<uint64_t>::digits) {
+                value |= static_cast<uint64_t>(byte & VARINT_MASK) << shift;
+            }
+            shift += VARINT_BITS;
+            if ((byte & VARINT_CONTINUATION) == 0) {
+                break;
+            }
+        }
+        out[i++] = value;
+    }
+}
+
+int64_t timestamp(const evlist::EventRecord& record) {
+    return record.seconds * MICROSECONDS + record.microseconds;
+}
+
+std::optional<double> parse_number(std::string_view value) {
+    double number{};
+    auto [end, err] =
+        std::from_chars(value.data(), value.data() + value.size(), number);
+    if (err != std::errc{} || end != value.data() + value.size()) {
+        return {};
+    }
+    return number;
+}
+
+std::optional<uint16_t> parse_code(
+    std::string_view value, evlist::CodeType type
+) {
+    if (auto code = evlist::EventCodes::code(value);
+        code.has_value() && (code->type == evlist::CodeType::EV) ==
+                                (type == evlist::CodeType::EV)) {
+        return code->code;
+    }
+
+    uint16_t number{};
+    auto [end, err] =
+        std::from_chars(value.data(), value.data() + value.size(), number);
+    if (err != std::errc{} || end != value.data() + value.size()) {
+        return {};
+    }
+    return number;
+}
+
+} // namespace
+
+std::expected<evlist::ArchiveQuery, std::string> evlist::ArchiveQuery::parse(
+    const std::vector<std::string>& filters,
+    const std::vector<InputDevice>& devices
+) {
+    ArchiveQuery query{};
+    std::optional<CodeType> code_type{};
+    for (const auto& filter : filters) {
+        auto separator = filter.find('=');
+        if (separator == std::string::npos) {
+            return std::unexpected{
+                std::format("expected KEY=VALUE filter: {}", filter)
+            };
+        }
+
+        const std::string_view key{filter.data(), separator};
+        auto value = std::string_view{filter}.substr(separator + 1);
+        if (key == "device") {
+            auto found = std::ranges::find_if(devices, [&value](auto& device) {
+                return device.device_path() == value;
+            });
+            uint32_t index{};
+            auto [end, err] = std::from_chars(
+                value.data(), value.data() + value.size(), index
+            );
+            if (found != devices.end()) {
+                query.device = static_cast<uint32_t>(found - devices.begin());
+            } else if (err == std::errc{} &&
+                       end == value.data() + value.size() &&
+                       index < devices.size()) {
+                query.device = index;
+            } else {
+                return std::unexpected{
+                    std::format("unknown device: {}", value)
+                };
+            }
+        } else if (key == "from" || key == "to") {
+            auto seconds = parse_number(value);
+            if (!seconds.has_value()) {
+                return std::unexpected{std::format("invalid time: {}", value)};
+            }
+            auto time = std::llround(*seconds * MICROSECONDS);
+            (key == "from" ? query.from : query.to) = time;
+        } else if (key == "type") {
+            auto type = parse_code(value, CodeType::EV);
+            if (!type.has_value()) {
+                return std::unexpected{std::format("unknown type: {}", value)};
+            }
+            query.type = type;
+        } else if (key == "code") {
+            auto code = EventCodes::code(value);
+            if (code.has_value() && code->type != CodeType::EV) {
+                code_type = code->type;
+            }
+
+            auto parsed = parse_code(value, CodeType::KEY);
+            if (!parsed.has_value()) {
+                return std::unexpected{std::format("unknown code: {}", value)};
+            }
+            query.code = parsed;
+        } else {
+            return std::unexpected{std::format("unknown filter key: {}", key)};
+        }
+    }
+
+    // A named code implies its type, and must agree with an explicit type.
+    if (code_type.has_value()) {
+        auto type = EventCodes::event_type(*code_type);
+        if (query.type.has_value() && query.type != type) {
+            return std::unexpected{"code does not match the type"};
+        }
+        query.type = type;
+    }
+
+    return query;
+}
+
+bool evlist::ArchiveQuery::skip(const ArchiveBlock& block) const {
+    return (device.has_value() && block.device != *device) ||
+           (from.has_value() && block.max_time < *from) ||
+           (to.has_value() && block.min_time >= *to) ||
+           (type.has_value() &&
+            (*type < block.min_type || *type > block.max_type)) ||
+           (code.has_value() &&
+            (*code < block.min_code || *code > block.max_code));
+}
+
+evlist::EventArchive::EventArchive(
+    std::string bytes,
+    std::vector<InputDevice> devices,
+    std::vector<ArchiveBlock> blocks,
+    std::vector<std::size_t> offsets
+)
+    : bytes_{std::move(bytes)},
+      devices_{std::move(devices)},
+      blocks_{std::move(blocks)},
+      offsets_{std::move(offsets)} {}
+
+std::string evlist::EventArchive::encode(
+    const std::vector<InputDevice>& devices,
+    std::span<const EventRecord> records,
+    std::size_t block_size
+) {
+    // Group events by device, keeping them in time order within a device.
+    std::vector<const EventRecord*> sorted{};
+    sorted.reserve(records.size());
+    std::ranges::transform(
+        records, std::back_inserter(sorted), [](auto& record) {
+            return &record;
+        }
+    );
+    std::ranges::stable_sort(sorted, {}, &EventRecord::device);
+
+    std::vector<std::span<const EventRecord* const>> chunks{};
+    for (auto begin = sorted.begin(); begin != sorted.end();) {
+        auto device = (*begin)->device;
+        auto device_end =
+            std::ranges::find_if(begin, sorted.end(), [device](auto* record) {
+                return record->device != device;
+            });
+        while (begin != device_end) {
+            auto size = std::min(
+                block_size, static_cast<std::size_t>(device_end - begin)
+            );
+            chunks.emplace_back(begin, size);
+            begin += static_cast<long>(size);
+        }
+    }
+
+    auto metadata = std::format("{}", InputDevices{Format::CSV, devices});
+
+    std::string out{};
+    put(out,
+        Header{
+            .magic = MAGIC,
+            .version = VERSION,
+            .devices = static_cast<uint32_t>(devices.size()),
+            .metadata_size = metadata.size(),
+            .blocks = chunks.size()
+        });
+    out += metadata;
+
+    std::array<std::string, 4> columns{};
+    for (const auto& chunk : chunks) {
+        ArchiveBlock block{
+            .device = chunk.front()->device,
+            .events = static_cast<uint32_t>(chunk.size()),
+            .min_time = std::numeric_limits<int64_t>::max(),
+            .max_time = std::numeric_limits<int64_t>::min(),
+            .min_type = std::numeric_limits<uint16_t>::max(),
+            .max_type = 0,
+            .min_code = std::numeric_limits<uint16_t>::max(),
+            .max_code = 0,
+            .sizes = {}
+        };
+        for (const auto* record : chunk) {
+            block.min_time = std::min(block.min_time, timestamp(*record));
+            block.max_time = std::max(block.max_time, timestamp(*record));
+            block.min_type = std::min(block.min_type, record->type);
+            block.max_type = std::max(block.max_type, record->type);
+            block.min_code = std::min(block.min_code, record->code);
+            block.max_code = std::max(block.max_code, record->code);
+        }
+
+        for (auto& column : columns) {
+            column.clear();
+        }
+        auto previous = block.min_time;
+        for (const auto* record : chunk) {
+            put_varint(columns[0], zigzag(timestamp(*record) - previous));
+            put_varint(columns[1], record->type);
+            put_varint(columns[2], record->code);
+            put_varint(columns[3], zigzag(record->value));
+            previous = timestamp(*record);
+        }
+
+        for (std::size_t i = 0; i < columns.size(); i++) {
+            block.sizes.at(i) = static_cast<uint32_t>(columns.at(i).size());
+        }
+        put(out, block);
+        for (const auto& column : columns) {
+            out += column;
+        }
+    }
+
+    return out;
+}
+
+std::expected<evlist::EventArchive, std::system_error>
+evlist::EventArchive::decode(std::string bytes) {
+    const std::string_view view{bytes};
+    std::size_t offset = 0;
+
+    Header header{};
+    if (!get(view, offset, header) || header.magic != MAGIC ||
+        header.version != VERSION ||
+        view.size() - offset < header.metadata_size) {
+        return std::unexpected{invalid_archive()};
+    }
+
+    auto devices =
+        InputDevices::from_csv(view.substr(offset, header.metadata_size));
+    if (!devices.has_value() || devices->devices().size() != header.devices) {
+        return std::unexpected{invalid_archive()};
+    }
+    offset += header.metadata_size;
+
+    // Each event takes at least one byte in every column, which bounds the
+    // number of blocks and events by the size of the archive.
+    std::vector<ArchiveBlock> blocks{};
+    std::vector<std::size_t> offsets{};
+    for (uint64_t i = 0; i < header.blocks; i++) {
+        ArchiveBlock block{};
+        if (!get(view, offset, block) || block.device >= header.devices ||
+            block.events == 0) {
+            return std::unexpected{invalid_archive()};
+        }
+
+        uint64_t size = 0;
+        for (const auto column : block.sizes) {
+            if (column < block.events) {
+                return std::unexpected{invalid_archive()};
+            }
+            size += column;
+        }
+        if (view.size() - offset < size) {
+            return std::unexpected{invalid_archive()};
+        }
+
+        blocks.emplace_back(block);
+        offsets.emplace_back(offset);
+        offset += size;
+    }
+    if (offset != view.size()) {
+        return std::unexpected{invalid_archive()};
+    }
+
+    return EventArchive{
+        std::move(bytes),
+        devices->devices(),
+        std::move(blocks),
+        std::move(offsets)
+    };
+}
+
+std::expected<void, std::system_error> evlist::EventArchive::write(
+    const fs::path& path,
+    const std::vector<InputDevice>& devices,
+    std::span<const EventRecord> records
+) {
+    auto bytes = encode(devices, records);
+
+    std::ofstream file{path, std::ios::binary | std::ios::trunc};
+    file.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    file.close();
+    if (file.fail()) {
+        return std::unexpected{
+            std::system_error{errno, std::generic_category(), path.string()}
+        };
+    }
+    return {};
+}
+
+std::expected<evlist::EventArchive, std::system_error>
+evlist::EventArchive::open(const fs::path& path) {
+    std::ifstream file{path, std::ios::binary};
+    if (!file.is_open()) {
+        return std::unexpected{
+            std::system_error{errno, std::generic_category(), path.string()}
+        };
+    }
+
+    std::string bytes{
+        (std::istreambuf_iterator(file)), std::istreambuf_iterator<char>()
+    };
+    return decode(std::move(bytes));
+}
+
+const std::vector<evlist::InputDevice>& evlist::EventArchive::devices() const {
+    return devices_;
+}
+
+const std::vector<evlist::ArchiveBlock>& evlist::EventArchive::blocks() const {
+    return blocks_;
+}
+
+void evlist::EventArchive::columns(std::size_t block, ArchiveColumns& columns)
+    const {
+    const auto& entry = blocks_.at(block);
+    const auto events = entry.events;
+
+    std::string_view bytes{bytes_};
+    auto offset = offsets_.at(block);
+    auto column = [&](std::size_t index) {
+        auto out = bytes.substr(offset, entry.sizes.at(index));
+        offset += entry.sizes.at(index);
+        return out;
+    };
+
+    // Decode each column into varints first so that the transforms below
+    // are simple loops over contiguous arrays.
+    auto& varints = columns.varints;
+    varints.resize(events);
+
+    decode_varints(column(0), varints);
+    columns.times.resize(events);
+    auto time = entry.min_time;
+    for (std::size_t i = 0; i < events; i++) {
+        time += unzigzag(varints[i]);
+        columns.times[i] = time;
+    }
+
+    decode_varints(column(1), varints);
+    columns.types.resize(events);
+    std::ranges::transform(
+        varints.begin(), varints.begin() + events, columns.types.begin(),
+        [](auto value) { return static_cast<uint16_t>(value); }
+    );
+
+    decode_varints(column(2), varints);
+    columns.codes.resize(events);
+    std::ranges::transform(
+        varints.begin(), varints.begin() + events, columns.codes.begin(),
+        [](auto value) { return static_cast<uint16_t>(value); }
+    );
+
+    decode_varints(column(3), varints);
+    columns.values.resize(events);
+    std::ranges::transform(
+        varints.begin(), varints.begin() + events, columns.values.begin(),
+        [](auto value) { return static_cast<int32_t>(unzigzag(value)); }
+    );
+}
+
+std::vector<evlist::EventRecord> evlist::EventArchive::query(
+    const ArchiveQuery& query
+) const {
+    std::vector<EventRecord> out{};
+    scan(query, [&out](auto records) {
+        out.insert(out.end(), records.begin(), records.end());
+    });
+    return out;
+}
+
+std::size_t evlist::EventArchive::select(
+    const ArchiveQuery& query,
+    const ArchiveColumns& columns,
+    std::vector<uint8_t>& selected
+) {
+    // Apply each filter as a separate branch-free pass over a single column,
+    // which the compiler can vectorise.
+    selected.assign(columns.times.size(), 1);
+    auto apply = [&selected](const auto& column, auto matches) {
+        for (std::size_t i = 0; i < selected.size(); i++) {
+            selected[i] &= static_cast<uint8_t>(matches(column[i]));
+        }
+    };
+
+    if (query.from.has_value()) {
+        apply(columns.times, [from = *query.from](auto time) {
+            return time >= from;
+        });
+    }
+    if (query.to.has_value()) {
+        apply(columns.times, [to = *query.to](auto time) { return time < to; });
+    }
+    if (query.type.has_value()) {
+        apply(columns.types, [type = *query.type](auto value) {
+            return value == type;
+        });
+    }
+    if (query.code.has_value()) {
+        apply(columns.codes, [code = *query.code](auto value) {
+            return value == code;
+        });
+    }
+
+    return static_cast<std::size_t>(std::ranges::count(selected, 1));
+}
+
+evlist::ArchiveEvents::ArchiveEvents(
+    Format output_format,
+    std::vector<InputDevice> devices,
+    std::vector<EventRecord> records
+)
+    : output_format_{output_format},
+      devices_{std::move(devices)},
+      records_{std::move(records)} {}
+
+const std::vector<evlist::InputDevice>& evlist::ArchiveEvents::devices(
+) const {
+    return devices_;
+}
+
+const std::vector<evlist::EventRecord>& evlist::ArchiveEvents::records(
+) const {
+    return records_;
+}
+
+evlist::Format evlist::ArchiveEvents::output_format() const {
+    return output_format_;
+}
+
+evlist::ArchiveSummary::ArchiveSummary(
+    Format output_format, const EventArchive& archive, const ArchiveQuery& query
+)
+    : output_format_{output_format},
+      devices_{archive.devices()},
+      events_(devices_.size()),
+      first_(devices_.size(), std::numeric_limits<int64_t>::max()),
+      last_(devices_.size(), std::numeric_limits<int64_t>::min()) {
+    archive.scan(query, [this](auto records) {
+        for (const auto& record : records) {
+            events_[record.device]++;
+            first_[record.device] =
+                std::min(first_[record.device], timestamp(record));
+            last_[record.device] =
+                std::max(last_[record.device], timestamp(record));
+        }
+    });
+}
+
+const std::vector<evlist::InputDevice>& evlist::ArchiveSummary::devices(
+) const {
+    return devices_;
+}
+
+uint64_t evlist::ArchiveSummary::events(std::size_t device) const {
+    return events_.at(device);
+}
+
+double evlist::ArchiveSummary::seconds(std::size_t device) const {
+    if (events(device) == 0) {
+        return 0;
+    }
+    return static_cast<double>(last_.at(device) - first_.at(device)) /
+           MICROSECONDS;
+}
+
+double evlist::ArchiveSummary::rate(std::size_t device) const {
+    auto elapsed = seconds(device);
+    if (elapsed <= 0) {
+        return 0;
+    }
+    return static_cast<double>(events(device)) / elapsed;
+}
+
+evlist::Format evlist::ArchiveSummary::output_format() const {
+    return output_format_;
+}
@@ -1,18 +1,155 @@
 #include "evlist/cli.h"
 
 #include <CLI/CLI.hpp>
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
 #include <expected>
 #include <format>
 #include <iostream>
-#include <map>
+#include <optional>
+#include <ranges>
+#include <span>
 #include <string>
+#include <string_view>
 #include <utility>
 #include <vector>
 
+namespace {
+
+constexpr std::array<std::string_view, 5> FORMAT_DESCRIPTIONS{
+    "- table: format the output as a table",
+    "- csv: format the output as CSV",
+    "- tsv: format the output as tab separated values",
+    "- json: format the output as a JSON array",
+    "- ndjson: format the output as one JSON object per line",
+};
+
+constexpr std::array<std::string_view, 11> FILTER_DESCRIPTIONS{
+    "- device_path: filter outputs that contain the device path",
+    "- name: filter outputs that contain the name of the device",
+    "- by_id: filter outputs that contain the by_id path of the device",
+    "- by_path: filter outputs that contain the by_path path of the device",
+    "- capabilities: filter outputs that have the capabilities listed",
+    "- parent: filter outputs that contain the parent input device",
+    "- vendor: filter outputs that contain the vendor id of the device",
+    "- product: filter outputs that contain the product id of the device",
+    "- bus: filter outputs that contain the bus type of the device",
+    "- phys: filter outputs that contain the physical path of the device",
+    "- uniq: filter outputs that contain the unique id of the device",
+};
+
+bool is_help(std::string_view arg) {
+    return arg == "-h" || arg == "--help" || arg == "--help-all";
+}
+
+} // namespace
+
 std::expected<bool, int> evlist::Cli::parse(int argc, char** argv) {
+    const std::span<const char* const> args{
+        argv + 1, static_cast<std::size_t>(std::max(argc - 1, 0))
+    };
+    if (auto common = parse_common(args); common.has_value()) {
+        *this = std::move(*common);
+        return false;
+    }
+
+    return parse_full(argc, argv);
+}
+
+std::optional<evlist::Cli> evlist::Cli::parse_common(
+    std::span<const char* const> args
+) {
+    Cli cli{};
+    auto has_format = false;
+    for (std::size_t i = 0; i < args.size(); i++) {
+        const std::string_view arg{args[i]};
+
+        // Options take their value from `--option=VALUE` or the next
+        // argument.
+        auto value = [&arg, &args, &i](
+                         std::string_view short_name, std::string_view name
+                     ) -> std::optional<std::string_view> {
+            if (arg == short_name || arg == name) {
+                if (i + 1 == args.size()) {
+                    return {};
+                }
+                return args[++i];
+            }
+            if (arg.length() > name.length() && arg.starts_with(name) &&
+                arg[name.length()] == '=') {
+                return arg.substr(name.length() + 1);
+            }
+            return {};
+        };
+
+        auto flag = [&arg](
+                        bool& target,
+                        std::string_view short_name,
+                        std::string_view name
+                    ) {
+            if (arg != short_name && arg != name) {
+                return false;
+            }
+            if (target) {
+                // Repeated flags are left to the full parser.
+                return false;
+            }
+            target = true;
+            return true;
+        };
+
+        if (auto name = value("-o", "--format"); name.has_value()) {
+            auto parsed = format_from_name(*name);
+            if (has_format || !parsed.has_value()) {
+                return {};
+            }
+            cli.format_ = *parsed;
+            has_format = true;
+        } else if (auto filter = value("-f", "--filter"); filter.has_value()) {
+            auto parsed = parse_filter(*filter);
+            if (!parsed.has_value()) {
+                return {};
+            }
+            cli.filter_.emplace_back(std::move(*parsed));
+        } else if (!flag(cli.use_regex_, "-r", "--use-regex") &&
+                   !flag(cli.use_glob_, "-g", "--glob") &&
+                   !flag(cli.parent_, "-p", "--parent") &&
+                   !flag(cli.first_, "--first", "--first")) {
+            return {};
+        }
+    }
+
+    if (cli.use_regex_ && cli.use_glob_) {
+        return {};
+    }
+    return cli;
+}
+
+std::expected<bool, int> evlist::Cli::parse_full(int argc, char** argv) {
     CLI::App app{"lists and formats devices under /dev/input.", "evlist"};
     argv = app.ensure_utf8(argv);
 
+    // The descriptions of enum values are only formatted for `--help`.
+    const auto help = std::ranges::any_of(
+        std::span{argv, static_cast<std::size_t>(argc)} | std::views::drop(1),
+        is_help
+    );
+    auto option_text = [help](
+                           std::string_view value_descriptor,
+                           std::string_view enum_description,
+                           uint8_t first_indent,
+                           std::span<const std::string_view> descriptions
+                       ) {
+        if (!help) {
+            return std::format("<{}>", value_descriptor);
+        }
+        return format_enum(
+            value_descriptor, enum_description, first_indent, descriptions
+        );
+    };
+
     auto should_exit = false;
     app.add_flag_callback(
         "-v,--version",
@@ -28,90 +165,440 @@ std::expected<bool, int> evlist::Cli::parse(int argc, char** argv) {
         "Print version"
     );
 
-    app.add_option("-o,--format", format_)
-        ->transform(CLI::Transformer{format_mappings(), CLI::ignore_case})
-        ->option_text(format_enum(
+    std::optional<std::string> format{};
+    app.add_option("-o,--format", format)
+        ->check(
+            [](const std::string& name) {
+                return format_from_name(name).has_value()
+                           ? std::string{}
+                           : std::format("unknown format `{}`", name);
+            },
+            "FORMAT"
+        )
+        ->option_text(option_text(
             "FORMAT",
             "Format to output devices in",
             FORMAT_INDENT_BY,
-            format_descriptions_
+            FORMAT_DESCRIPTIONS
         ));
 
-    app.add_option("-f,--filter", filter_)
-        ->transform(CLI::Transformer{filter_mappings(), CLI::ignore_case})
-        ->delimiter('=')
-        ->option_text(format_enum(
+    std::vector<std::string> filters{};
+    app.add_option("-f,--filter", filters)
+        ->check(
+            [](const std::string& filter) {
+                auto parsed = parse_filter(filter);
+                return parsed.has_value() ? std::string{} : parsed.error();
+            },
+            "FILTER"
+        )
+        ->option_text(option_text(
             "KEY=VALUE",
             "Filter output rows by the column value. This "
             "option can be specified multiple times, and takes a key=value "
-            "format where each key is one of the following",
+            "format where `*=` matches values containing the value, `^=` "
+            "matches values starting with the value, `~=` matches values "
+            "ignoring case, and each key is one of the following",
             FILTER_INDENT_BY,
-            filter_descriptions_
+            FILTER_DESCRIPTIONS
         ));
 
-    app.add_flag(
+    auto* use_regex = app.add_flag(
         "-r,--use-regex",
         use_regex_,
         "Pass this to use a regex when filtering values in `--filter` options"
     );
 
+    app.add_flag(
+        "-g,--glob",
+        use_glob_,
+        "Pass this to use a glob when filtering values in `--filter` options, "
+        "where `*` matches any characters, `?` matches one character and "
+        "`[...]` matches one character in a set"
+    )
+        ->excludes(use_regex);
+
+    auto* where = app.add_option(
+        "-w,--where",
+        where_,
+        "Filter devices using a boolean expression of `KEY=VALUE` equality "
+        "and `KEY~VALUE` regex comparisons combined with `not`, `and`, `or` "
+        "and parentheses, where keys and the `*=`, `^=` and `~=` operators "
+        "are the same as `--filter`. For example: "
+        "`(name~Logitech or by_id^=usb-) and not capabilities=EV_ABS`"
+    )
+        ->option_text("<EXPRESSION>");
+
+    auto* diff_against = app.add_option(
+        "-d,--diff-against",
+        diff_against_,
+        "Output only the devices which were added, removed or changed "
+        "compared to a previous listing created using `--format csv`"
+    )
+        ->check(CLI::ExistingFile)
+        ->option_text("<FILE>");
+
+    auto* top = app.add_flag(
+        "-t,--top",
+        top_,
+        "Monitor the devices and periodically output the rate of events, "
+        "dropped events and event types of each device, sorted by rate"
+    )
+        ->excludes(diff_against);
+
+    app.add_option(
+        "-i,--interval",
+        interval_,
+        "The interval in seconds between outputs when monitoring devices"
+    )
+        ->check(CLI::PositiveNumber)
+        ->option_text("<SECONDS>");
+
+    auto* limit = app.add_option(
+        "-n,--limit",
+        limit_,
+        "Only list the first number of matching devices in device path "
+        "order, stopping once they are found"
+    )
+        ->check(CLI::PositiveNumber)
+        ->option_text("<N>");
+    app.add_flag("--first", first_, "Only list the first matching device")
+        ->excludes(limit);
+
+    std::vector<std::string> queries{};
+    auto* query_option = app.add_option(
+        "-q,--query",
+        queries,
+        "Evaluate a named set of filters, which can be repeated to evaluate "
+        "several queries in a single pass over the devices. Each query has "
+        "the form `NAME:KEY=VALUE,...`, where keys are the same as `--filter`"
+    )
+        ->check(
+            [](const std::string& query) {
+                auto parsed = parse_query(query);
+                return parsed.has_value() ? std::string{} : parsed.error();
+            },
+            "QUERY"
+        )
+        ->option_text("<NAME:KEY=VALUE,...>")
+        ->excludes(diff_against)
+        ->excludes(top);
+
+    app.add_flag(
+        "-p,--parent",
+        parent_,
+        "Output the sysfs name, vendor, product, bus type, physical path and "
+        "unique identifier of the parent input device of each device"
+    );
+
+    auto* record = app.add_option(
+        "-R,--record",
+        record_,
+        "Record events from the devices into a memory-mapped ring buffer "
+        "file until interrupted or all devices are removed"
+    )
+        ->excludes(diff_against)
+        ->excludes(top)
+        ->excludes(query_option)
+        ->option_text("<FILE>");
+
+    app.add_option(
+        "--capacity",
+        capacity_,
+        "The number of events that fit in the recording before the oldest "
+        "events are overwritten"
+    )
+        ->check(CLI::PositiveNumber)
+        ->option_text("<EVENTS>");
+
+    auto* latency = app.add_flag(
+        "-l,--latency",
+        latency_,
+        "Measure the latency between the kernel timestamp of events and when "
+        "they are read, periodically outputting percentiles in microseconds "
+        "for each device"
+    )
+        ->excludes(diff_against)
+        ->excludes(top)
+        ->excludes(record)
+        ->excludes(query_option);
+
+    std::optional<std::string> group_by{};
+    auto* group_by_option = app.add_option(
+        "-G,--group-by",
+        group_by,
+        "Output the number of devices with each value of a column instead of "
+        "the devices, where the column is the same as the keys of `--filter`. "
+        "Devices are counted once for each capability when grouped by "
+        "`capabilities`, and by their bus when grouped by `by_path`"
+    )
+        ->check(
+            [](const std::string& name) {
+                return filter_from_name(name).has_value()
+                           ? std::string{}
+                           : std::format("unknown column `{}`", name);
+            },
+            "COLUMN"
+        )
+        ->option_text("<COLUMN>")
+        ->excludes(diff_against)
+        ->excludes(top)
+        ->excludes(record)
+        ->excludes(latency)
+        ->excludes(query_option);
+
+    auto* serve = app.add_option(
+        "--serve",
+        serve_,
+        "Serve queries from `--connect` over a Unix domain socket at the "
+        "path until interrupted, answering them from devices kept in memory "
+        "and refreshed when devices are added or removed"
+    )
+        ->option_text("<SOCKET>")
+        ->excludes(diff_against)
+        ->excludes(top)
+        ->excludes(record)
+        ->excludes(latency)
+        ->excludes(query_option)
+        ->excludes(group_by_option);
+
+    app.add_option(
+        "--connect",
+        connect_,
+        "List devices by querying a server started with `--serve` at the "
+        "socket path, rather than reading them directly"
+    )
+        ->option_text("<SOCKET>")
+        ->excludes(where)
+        ->excludes(limit)
+        ->excludes(diff_against)
+        ->excludes(top)
+        ->excludes(record)
+        ->excludes(latency)
+        ->excludes(query_option)
+        ->excludes(group_by_option)
+        ->excludes(serve);
+
+    app.add_option(
+        "--deadline",
+        deadline_,
+        "The total time in seconds to spend probing devices. Devices which "
+        "are not probed in time are listed without capabilities, and with a "
+        "name of `<timed out>` if their name was not read in time"
+    )
+        ->check(CLI::PositiveNumber)
+        ->option_text("<SECONDS>");
+
+    auto* archive = app.add_subcommand(
+        "archive", "Convert a recording into a compressed columnar archive"
+    );
+    archive->add_option("recording", recording_, "The recording to convert")
+        ->required()
+        ->check(CLI::ExistingFile);
+    archive->add_option("archive", archive_, "The archive to create")
+        ->required();
+
+    auto* query = app.add_subcommand("query", "Query the events of an archive");
+    query->fallthrough();
+    query->add_option("archive", archive_, "The archive to query")
+        ->required()
+        ->check(CLI::ExistingFile);
+    query->add_option(
+        "filters",
+        query_,
+        "Filter events using KEY=VALUE, where each key is one of device, "
+        "from, to, type or code. For example: `type=EV_KEY code=KEY_A`"
+    );
+    query->add_flag(
+        "-s,--summary",
+        summary_,
+        "Output the number and rate of events of each device instead of the "
+        "events"
+    );
+
     try {
         app.parse(argc, argv);
     } catch (const CLI::ParseError& e) {
         return std::unexpected{app.exit(e)};
     }
 
+    if (format.has_value()) {
+        format_ = *format_from_name(*format);
+    }
+    for (const auto& filter : filters) {
+        filter_.emplace_back(*parse_filter(filter));
+    }
+    if (group_by.has_value()) {
+        group_by_ = filter_from_name(*group_by);
+    }
+    for (const auto& query : queries) {
+        queries_.emplace_back(*parse_query(query));
+    }
+
+    if (archive->parsed()) {
+        command_ = Command::ARCHIVE;
+    } else if (query->parsed()) {
+        command_ = Command::QUERY;
+    }
+
     return should_exit;
 }
 
+std::expected<evlist::FilterTerm, std::string> evlist::Cli::parse_filter(
+    std::string_view filter
+) {
+    auto equals = filter.find('=');
+    if (equals == std::string_view::npos) {
+        return std::unexpected{
+            std::format("filter `{}` is missing `=`", filter)
+        };
+    }
+
+    auto key = filter.substr(0, equals);
+    auto op = FilterOperator::EQUAL;
+    if (!key.empty()) {
+        auto found = std::ranges::find_if(
+            FILTER_OPERATORS,
+            [&key](const auto& op) { return op.first == key.back(); }
+        );
+        if (found != FILTER_OPERATORS.end()) {
+            op = found->second;
+            key.remove_suffix(1);
+        }
+    }
+
+    auto column = filter_from_name(key);
+    if (!column.has_value()) {
+        return std::unexpected{std::format("unknown filter key `{}`", key)};
+    }
+    return FilterTerm{*column, std::string{filter.substr(equals + 1)}, op};
+}
+
+std::expected<evlist::DeviceQuery, std::string> evlist::Cli::parse_query(
+    std::string_view query
+) {
+    auto separator = query.find(':');
+    if (separator == std::string_view::npos || separator == 0) {
+        return std::unexpected{
+            std::format("query `{}` is missing a `NAME:` prefix", query)
+        };
+    }
+
+    DeviceQuery out{std::string{query.substr(0, separator)}, {}};
+    auto filters = query.substr(separator + 1);
+    if (filters.empty()) {
+        return out;
+    }
+    for (const auto filter : std::views::split(filters, ',')) {
+        auto term = parse_filter(std::string_view{filter});
+        if (!term.has_value()) {
+            return std::unexpected{
+                std::format("invalid query `{}`: {}", query, term.error())
+            };
+        }
+        out.filter.emplace_back(std::move(*term));
+    }
+
+    return out;
+}
+
 evlist::Format evlist::Cli::format() const { return format_; }
 
 bool evlist::Cli::use_regex() const { return use_regex_; }
 
-const std::vector<std::pair<evlist::Filter, std::string>>&
-evlist::Cli::filter() const {
+bool evlist::Cli::use_glob() const { return use_glob_; }
+
+const std::vector<evlist::FilterTerm>& evlist::Cli::filter() const {
     return filter_;
 }
 
-std::vector<std::pair<evlist::Filter, std::string>>
-evlist::Cli::into_filter() && {
+std::vector<evlist::FilterTerm> evlist::Cli::into_filter() && {
     return std::move(filter_);
 }
 
-std::map<std::string, evlist::Format> evlist::Cli::format_mappings() {
-    return {
-        {"table", Format::TABLE},
-        {"csv", Format::CSV},
-    };
+const std::optional<std::string>& evlist::Cli::diff_against() const {
+    return diff_against_;
 }
 
-std::map<evlist::Format, std::string> evlist::Cli::format_descriptions() {
-    return {
-        {Format::TABLE, "- table: format the output as a table"},
-        {Format::CSV, "- csv: format the output as CSV"},
-    };
+bool evlist::Cli::top() const { return top_; }
+
+std::chrono::duration<double> evlist::Cli::interval() const {
+    return std::chrono::duration<double>{interval_};
 }
-std::map<evlist::Filter, std::string> evlist::Cli::filter_descriptions() {
-    return {
-        {Filter::DEVICE_PATH,
-         "- device_path: filter outputs that contain the device path"},
-        {Filter::NAME,
-         "- name: filter outputs that contain the name of the device"},
-        {Filter::BY_ID,
-         "- by_id: filter outputs that contain the by_id path of the device"},
-        {Filter::BY_PATH,
-         "- by_path: filter outputs that contain the by_path path of the device"},
-        {Filter::CAPABILITIES,
-         "- capabilities: filter outputs that have the capabilities listed"},
-    };
+
+const std::optional<std::string>& evlist::Cli::record() const {
+    return record_;
 }
 
-std::map<std::string, evlist::Filter> evlist::Cli::filter_mappings() {
-    return {
-        {"device_path", Filter::DEVICE_PATH},
-        {"name", Filter::NAME},
-        {"by_id", Filter::BY_ID},
-        {"by_path", Filter::BY_PATH},
-        {"capabilities", Filter::CAPABILITIES},
-    };
+std::size_t evlist::Cli::capacity() const { return capacity_; }
+
+bool evlist::Cli::latency() const { return latency_; }
+
+std::optional<std::chrono::duration<double>> evlist::Cli::deadline() const {
+    if (!deadline_.has_value()) {
+        return {};
+    }
+    return std::chrono::duration<double>{*deadline_};
+}
+
+std::optional<std::size_t> evlist::Cli::limit() const {
+    if (first_) {
+        return 1;
+    }
+    return limit_;
+}
+
+const std::optional<std::string>& evlist::Cli::where() const {
+    return where_;
+}
+
+const std::vector<evlist::DeviceQuery>& evlist::Cli::queries() const {
+    return queries_;
+}
+
+bool evlist::Cli::parent() const { return parent_; }
+
+std::optional<evlist::Filter> evlist::Cli::group_by() const {
+    return group_by_;
+}
+
+const std::optional<std::string>& evlist::Cli::serve() const {
+    return serve_;
+}
+
+const std::optional<std::string>& evlist::Cli::connect() const {
+    return connect_;
+}
+
+evlist::Command evlist::Cli::command() const { return command_; }
+
+const std::string& evlist::Cli::recording() const { return recording_; }
+
+const std::string& evlist::Cli::archive() const { return archive_; }
+
+const std::vector<std::string>& evlist::Cli::query() const { return query_; }
+
+bool evlist::Cli::summary() const { return summary_; }
+
+std::string evlist::Cli::format_enum(
+    std::string_view value_descriptor,
+    std::string_view enum_description,
+    uint8_t first_ident,
+    std::span<const std::string_view> descriptions
+) {
+    auto out_description = std::format(
+        "<{}>{: <{}}{}\n\n{: <{}}Possible values:\n",
+        value_descriptor,
+        "",
+        first_ident,
+        enum_description,
+        "",
+        INDENT_BY
+    );
+    for (const auto description : descriptions) {
+        out_description.append(
+            std::format("{: <{}}{}\n", "", INDENT_BY, description)
+        );
+    }
+
+    return out_description;
 }
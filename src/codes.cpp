@@ -0,0 +1,259 @@
+#include "evlist/codes.h"
+
+#include <linux/input-event-codes.h>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <optional>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+
+namespace {
+
+struct Entry {
+    evlist::CodeType type;
+    uint16_t code;
+    std::string_view name;
+    bool alias;
+};
+
+// NOLINTBEGIN(cppcoreguidelines-macro-usage)
+#define EVLIST_EVENT_CODE(type, code, alias) \
+    Entry{evlist::CodeType::type, code, #code, alias},
+constexpr std::array ENTRIES{
+#include "event_codes.inc"
+};
+#undef EVLIST_EVENT_CODE
+// NOLINTEND(cppcoreguidelines-macro-usage)
+
+constexpr std::array<uint16_t, 9> COUNTS{
+    EV_CNT,
+    KEY_CNT,
+    REL_CNT,
+    ABS_CNT,
+    SW_CNT,
+    LED_CNT,
+    MSC_CNT,
+    SND_CNT,
+    INPUT_PROP_CNT
+};
+
+constexpr std::array<std::size_t, COUNTS.size() + 1> OFFSETS = [] {
+    std::array<std::size_t, COUNTS.size() + 1> offsets{};
+    std::partial_sum(COUNTS.begin(), COUNTS.end(), offsets.begin() + 1);
+    return offsets;
+}();
+
+constexpr std::size_t offset(evlist::CodeType type) {
+    return OFFSETS.at(static_cast<std::size_t>(type));
+}
+
+// The preferred name for a code, where later definitions are preferred over
+// range markers such as `BTN_MOUSE` which precede the specific `BTN_LEFT`.
+// Aliases and `_MAX` values are only used if there is no other name.
+constexpr int priority(const Entry& entry) {
+    if (entry.alias) {
+        return 0;
+    }
+    if (entry.name.ends_with("_MAX")) {
+        return 1;
+    }
+    return 2;
+}
+
+// Code to name lookup, with each type stored contiguously at its offset.
+constexpr std::array<std::string_view, OFFSETS.back()> NAMES = [] {
+    std::array<const Entry*, OFFSETS.back()> preferred{};
+    for (const auto& entry : ENTRIES) {
+        auto& current = preferred.at(offset(entry.type) + entry.code);
+        if (current == nullptr || priority(entry) >= priority(*current)) {
+            current = &entry;
+        }
+    }
+
+    std::array<std::string_view, OFFSETS.back()> names{};
+    std::ranges::transform(preferred, names.begin(), [](const auto* entry) {
+        return entry != nullptr ? entry->name : std::string_view{};
+    });
+    return names;
+}();
+
+// Name to code lookup using a hash and displace perfect hash. Each name is
+// hashed into a bucket, and each bucket stores a displacement which places
+// all of its names into distinct slots.
+constexpr std::size_t SLOTS =
+    std::bit_ceil(ENTRIES.size() + ENTRIES.size() / 4);
+constexpr std::size_t BUCKETS = SLOTS / 4;
+constexpr uint16_t EMPTY = UINT16_MAX;
+constexpr uint64_t SEED = 0x9e3779b97f4a7c15;
+
+static_assert(ENTRIES.size() < EMPTY);
+
+constexpr uint64_t hash(std::string_view str) {
+    // FNV-1a followed by the murmur3 finaliser to mix the high bits.
+    uint64_t hash = 0xcbf29ce484222325 ^ SEED;
+    for (const auto character : str) {
+        hash ^= static_cast<uint8_t>(character);
+        hash *= 0x100000001b3;
+    }
+
+    hash ^= hash >> 33U;
+    hash *= 0xff51afd7ed558ccd;
+    hash ^= hash >> 33U;
+    hash *= 0xc4ceb9fe1a85ec53;
+    hash ^= hash >> 33U;
+    return hash;
+}
+
+constexpr std::size_t bucket(uint64_t hash) { return hash % BUCKETS; }
+
+constexpr std::size_t slot(uint64_t hash, uint16_t displacement) {
+    // The step is odd, so every displacement reaches a different slot.
+    constexpr auto shift_first = 16U;
+    constexpr auto shift_second = 40U;
+    auto first = hash >> shift_first;
+    auto second = (hash >> shift_second) | 1U;
+    return (first + displacement * second) % SLOTS;
+}
+
+struct PerfectHash {
+    std::array<uint16_t, BUCKETS> displacements;
+    std::array<uint16_t, SLOTS> slots;
+};
+
+constexpr PerfectHash PERFECT_HASH = [] {
+    std::array<uint64_t, ENTRIES.size()> hashes{};
+    std::ranges::transform(ENTRIES, hashes.begin(), [](const auto& entry) {
+        return hash(entry.name);
+    });
+
+    // Counting sort the entries by bucket.
+    std::array<uint16_t, BUCKETS + 1> starts{};
+    for (const auto hash : hashes) {
+        starts.at(bucket(hash) + 1)++;
+    }
+    std::partial_sum(starts.begin(), starts.end(), starts.begin());
+
+    std::array<uint16_t, ENTRIES.size()> members{};
+    auto next = starts;
+    for (uint16_t i = 0; i < hashes.size(); i++) {
+        members.at(next.at(bucket(hashes.at(i)))++) = i;
+    }
+
+    // Place the largest buckets first while most slots are free.
+    std::array<uint16_t, BUCKETS> order{};
+    std::iota(order.begin(), order.end(), 0);
+    auto size = [&starts](auto bucket) {
+        return starts.at(bucket + 1) - starts.at(bucket);
+    };
+    std::ranges::sort(order, std::greater{}, size);
+
+    PerfectHash perfect_hash{};
+    std::ranges::fill(perfect_hash.slots, EMPTY);
+    for (const auto current : order) {
+        auto first = members.begin() + starts.at(current);
+        auto last = members.begin() + starts.at(current + 1);
+
+        auto placed = false;
+        for (uint16_t displacement = 0; displacement < EMPTY && !placed;
+             displacement++) {
+            placed = true;
+            for (auto member = first; member != last && placed; member++) {
+                auto index = slot(hashes.at(*member), displacement);
+                placed = perfect_hash.slots.at(index) == EMPTY;
+                // Distinct members of the same bucket must not collide.
+                for (auto other = first; other != member && placed; other++) {
+                    placed = slot(hashes.at(*other), displacement) != index;
+                }
+            }
+
+            if (placed) {
+                perfect_hash.displacements.at(current) = displacement;
+                for (auto member = first; member != last; member++) {
+                    perfect_hash.slots.at(slot(hashes.at(*member), displacement)
+                    ) = *member;
+                }
+            }
+        }
+
+        if (!placed) {
+            throw std::logic_error{"failed to construct perfect hash"};
+        }
+    }
+
+    return perfect_hash;
+}();
+
+constexpr std::array EVENT_TYPES{
+    std::pair{EV_KEY, evlist::CodeType::KEY},
+    std::pair{EV_REL, evlist::CodeType::REL},
+    std::pair{EV_ABS, evlist::CodeType::ABS},
+    std::pair{EV_MSC, evlist::CodeType::MSC},
+    std::pair{EV_SW, evlist::CodeType::SW},
+    std::pair{EV_LED, evlist::CodeType::LED},
+    std::pair{EV_SND, evlist::CodeType::SND},
+};
+
+} // namespace
+
+std::optional<std::string_view> evlist::EventCodes::name(
+    CodeType type, uint16_t code
+) noexcept {
+    if (code >= count(type)) {
+        return {};
+    }
+
+    auto name = NAMES.at(offset(type) + code);
+    if (name.empty()) {
+        return {};
+    }
+    return name;
+}
+
+std::optional<evlist::EventCode> evlist::EventCodes::code(std::string_view name
+) noexcept {
+    auto name_hash = hash(name);
+    auto displacement = PERFECT_HASH.displacements.at(bucket(name_hash));
+    auto index = PERFECT_HASH.slots.at(slot(name_hash, displacement));
+    if (index == EMPTY) {
+        return {};
+    }
+
+    const auto& entry = ENTRIES.at(index);
+    if (entry.name != name) {
+        return {};
+    }
+    return EventCode{entry.type, entry.code};
+}
+
+uint16_t evlist::EventCodes::count(CodeType type) noexcept {
+    return COUNTS.at(static_cast<std::size_t>(type));
+}
+
+std::optional<evlist::CodeType> evlist::EventCodes::code_type(
+    uint16_t event_type
+) noexcept {
+    const auto* found = std::ranges::find(
+        EVENT_TYPES, event_type, &decltype(EVENT_TYPES)::value_type::first
+    );
+    if (found == EVENT_TYPES.end()) {
+        return {};
+    }
+    return found->second;
+}
+
+std::optional<uint16_t> evlist::EventCodes::event_type(CodeType type
+) noexcept {
+    const auto* found = std::ranges::find(
+        EVENT_TYPES, type, &decltype(EVENT_TYPES)::value_type::second
+    );
+    if (found == EVENT_TYPES.end()) {
+        return {};
+    }
+    return static_cast<uint16_t>(found->first);
+}
@@ -0,0 +1,468 @@
+#include "evlist/daemon.h"
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <expected>
+#include <filesystem>
+#include <format>
+#include <optional>
+#include <regex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include "evlist/cli.h"
+#include "evlist/device.h"
+#include "evlist/events.h"
+#include "evlist/plan.h"
+#include "evlist/snapshot.h"
+
+namespace {
+
+constexpr std::size_t LENGTH_SIZE{sizeof(std::uint32_t)};
+
+constexpr char STATUS_OK{0};
+constexpr char STATUS_ERROR{1};
+
+constexpr std::uint8_t FLAG_REGEX{1U << 0U};
+constexpr std::uint8_t FLAG_GLOB{1U << 1U};
+constexpr std::uint8_t FLAG_PARENT{1U << 2U};
+
+std::system_error last_error(const char* what) {
+    return std::system_error{errno, std::generic_category(), what};
+}
+
+void append_length(std::string& out, std::size_t length) {
+    auto value = static_cast<std::uint32_t>(length);
+    std::array<char, LENGTH_SIZE> bytes{};
+    std::memcpy(bytes.data(), &value, LENGTH_SIZE);
+    out.append(bytes.data(), bytes.size());
+}
+
+std::uint32_t read_length(std::string_view bytes) {
+    std::uint32_t value{};
+    std::memcpy(&value, bytes.data(), LENGTH_SIZE);
+    return value;
+}
+
+template <typename T, std::size_t N>
+bool contains_value(
+    const std::array<std::pair<std::string_view, T>, N>& names, T value
+) {
+    return std::ranges::find(
+               names, value, &std::pair<std::string_view, T>::second
+           ) != names.end();
+}
+
+/**
+ * Create a Unix domain socket address, or an error if the path is too long.
+ */
+std::expected<sockaddr_un, std::system_error> address(
+    const std::filesystem::path& path
+) {
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    const auto& native = path.native();
+    if (native.size() >= sizeof(address.sun_path)) {
+        return std::unexpected{std::system_error{
+            std::make_error_code(std::errc::filename_too_long), native
+        }};
+    }
+    std::ranges::copy(native, std::begin(address.sun_path));
+    return address;
+}
+
+/**
+ * Send all bytes to a blocking socket, without raising `SIGPIPE` if the peer
+ * has disconnected. This is only used by clients, since the server must not
+ * block on any one client.
+ */
+std::expected<void, std::system_error> send_all(
+    int socket, std::string_view bytes
+) {
+    while (!bytes.empty()) {
+        auto sent = send(socket, bytes.data(), bytes.size(), MSG_NOSIGNAL);
+        if (sent < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return std::unexpected{last_error("send")};
+        }
+        bytes.remove_prefix(static_cast<std::size_t>(sent));
+    }
+    return {};
+}
+
+/**
+ * Receive exactly the size of the buffer from a blocking socket.
+ */
+std::expected<void, std::system_error> receive_all(
+    int socket, std::span<char> buffer
+) {
+    while (!buffer.empty()) {
+        auto received = recv(socket, buffer.data(), buffer.size(), 0);
+        if (received < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return std::unexpected{last_error("recv")};
+        }
+        if (received == 0) {
+            return std::unexpected{std::system_error{
+                std::make_error_code(std::errc::connection_reset), "recv"
+            }};
+        }
+        buffer = buffer.subspan(static_cast<std::size_t>(received));
+    }
+    return {};
+}
+
+} // namespace
+
+std::string evlist::DeviceRequest::encode() const {
+    std::uint8_t flags{0};
+    flags |= use_regex ? FLAG_REGEX : 0U;
+    flags |= use_glob ? FLAG_GLOB : 0U;
+    flags |= parent_columns ? FLAG_PARENT : 0U;
+
+    std::string message{};
+    message.push_back(static_cast<char>(output_format));
+    message.push_back(static_cast<char>(flags));
+    for (const auto& term : filter) {
+        message.push_back(static_cast<char>(term.column));
+        message.push_back(static_cast<char>(term.op));
+        append_length(message, term.value.size());
+        message.append(term.value);
+    }
+    return message;
+}
+
+std::optional<evlist::DeviceRequest> evlist::DeviceRequest::decode(
+    std::string_view message
+) {
+    if (message.size() < 2) {
+        return {};
+    }
+
+    DeviceRequest request{};
+    request.output_format = static_cast<Format>(message[0]);
+    auto flags = static_cast<std::uint8_t>(message[1]);
+    request.use_regex = (flags & FLAG_REGEX) != 0;
+    request.use_glob = (flags & FLAG_GLOB) != 0;
+    request.parent_columns = (flags & FLAG_PARENT) != 0;
+    if (!contains_value(FORMAT_NAMES, request.output_format)) {
+        return {};
+    }
+
+    message.remove_prefix(2);
+    while (!message.empty()) {
+        if (message.size() < 2 + LENGTH_SIZE) {
+            return {};
+        }
+
+        auto column = static_cast<Filter>(message[0]);
+        auto op = static_cast<FilterOperator>(message[1]);
+        auto length = read_length(message.substr(2));
+        message.remove_prefix(2 + LENGTH_SIZE);
+        if (!contains_value(FILTER_NAMES, column) ||
+            op > FilterOperator::CASE_INSENSITIVE || message.size() < length) {
+            return {};
+        }
+
+        request.filter.emplace_back(
+            FilterTerm{column, std::string{message.substr(0, length)}, op}
+        );
+        message.remove_prefix(length);
+    }
+
+    return request;
+}
+
+evlist::DeviceServer::DeviceServer(
+    FileDescriptor socket, const InputDevicesSnapshot& snapshot
+)
+    : socket_{std::move(socket)}, snapshot_{&snapshot} {}
+
+std::expected<evlist::DeviceServer, std::system_error>
+evlist::DeviceServer::bind(
+    const std::filesystem::path& path, const InputDevicesSnapshot& snapshot
+) {
+    auto socket_address = address(path);
+    if (!socket_address.has_value()) {
+        return std::unexpected{socket_address.error()};
+    }
+
+    FileDescriptor socket{
+        ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0)
+    };
+    if (!socket.valid()) {
+        return std::unexpected{last_error("socket")};
+    }
+
+    // Only replace sockets which no server is listening on, which are left
+    // behind if a server exits without removing its socket.
+    std::error_code error{};
+    if (std::filesystem::is_socket(path, error)) {
+        if (DeviceClient::connect(path).has_value()) {
+            return std::unexpected{std::system_error{
+                std::make_error_code(std::errc::address_in_use), path.native()
+            }};
+        }
+        std::filesystem::remove(path, error);
+    }
+
+    if (::bind(
+            socket.get(),
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+            reinterpret_cast<const sockaddr*>(&*socket_address),
+            sizeof(*socket_address)
+        ) != 0) {
+        return std::unexpected{last_error("bind")};
+    }
+    if (listen(socket.get(), SOMAXCONN) != 0) {
+        return std::unexpected{last_error("listen")};
+    }
+
+    return DeviceServer{std::move(socket), snapshot};
+}
+
+std::expected<std::size_t, std::system_error> evlist::DeviceServer::poll(
+    std::chrono::milliseconds timeout
+) {
+    std::vector<pollfd> ready{{socket_.get(), POLLIN, 0}};
+    for (const auto& client : clients_) {
+        // Requests are only read once the previous responses have been sent.
+        auto events =
+            static_cast<short>(client.output.empty() ? POLLIN : POLLOUT);
+        ready.emplace_back(pollfd{client.socket.get(), events, 0});
+    }
+
+    auto polled =
+        ::poll(ready.data(), ready.size(), static_cast<int>(timeout.count()));
+    if (polled < 0) {
+        if (errno == EINTR) {
+            return 0;
+        }
+        return std::unexpected{last_error("poll")};
+    }
+
+    // Clients which misbehave or can no longer be sent to are dropped, as
+    // are clients which have disconnected once they have been answered.
+    std::size_t answered = 0;
+    for (std::size_t i = 0; i < clients_.size(); i++) {
+        auto& client = clients_[i];
+        if (ready[i + 1].revents == 0) {
+            continue;
+        }
+
+        auto served = (!client.output.empty() || receive(client, answered)) &&
+                      send(client);
+        if (!served || (client.closed && client.output.empty())) {
+            client.socket = FileDescriptor{};
+        }
+    }
+    std::erase_if(clients_, [](const auto& client) {
+        return !client.socket.valid();
+    });
+
+    // Requests from new clients are answered by the next poll, which returns
+    // straight away if they have already been sent.
+    if ((ready.front().revents & POLLIN) != 0) {
+        while (true) {
+            FileDescriptor client{
+                accept4(
+                    socket_.get(),
+                    nullptr,
+                    nullptr,
+                    SOCK_NONBLOCK | SOCK_CLOEXEC
+                )
+            };
+            if (!client.valid()) {
+                break;
+            }
+            clients_.emplace_back(Client{std::move(client), {}, {}});
+        }
+    }
+
+    return answered;
+}
+
+std::expected<std::string, std::string> evlist::DeviceServer::query(
+    const DeviceRequest& request
+) const {
+    try {
+        FilterPlan plan{request.filter, request.use_regex, request.use_glob};
+
+        // Only the devices which match are copied out of the snapshot.
+        auto snapshot = snapshot_->load();
+        std::vector<InputDevice> matches{};
+        for (const auto& device : snapshot->devices()) {
+            if (plan.matches(device)) {
+                matches.emplace_back(device);
+            }
+        }
+
+        InputDevices devices{request.output_format, std::move(matches)};
+        devices.with_parent_columns(request.parent_columns);
+        return std::format("{}", devices);
+    } catch (const std::regex_error& err) {
+        return std::unexpected{std::format("invalid regex: {}", err.what())};
+    }
+}
+
+bool evlist::DeviceServer::receive(Client& client, std::size_t& answered)
+    const {
+    std::array<char, 4096> buffer{};
+    while (true) {
+        auto received =
+            recv(client.socket.get(), buffer.data(), buffer.size(), 0);
+        if (received > 0) {
+            client.input.append(
+                buffer.data(), static_cast<std::size_t>(received)
+            );
+            continue;
+        }
+        // Requests sent before the client disconnected are still answered.
+        if (received == 0) {
+            client.closed = true;
+            break;
+        }
+        if (errno == EINTR) {
+            continue;
+        }
+        if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            break;
+        }
+        return false;
+    }
+
+    std::string_view input{client.input};
+    while (input.size() >= LENGTH_SIZE) {
+        auto length = read_length(input);
+        if (length > MAX_REQUEST) {
+            return false;
+        }
+        if (input.size() - LENGTH_SIZE < length) {
+            break;
+        }
+
+        auto request =
+            DeviceRequest::decode(input.substr(LENGTH_SIZE, length));
+        input.remove_prefix(LENGTH_SIZE + length);
+
+        std::expected<std::string, std::string> response{
+            std::unexpect, "malformed request"
+        };
+        if (request.has_value()) {
+            response = query(*request);
+        }
+        const auto& body =
+            response.has_value() ? *response : response.error();
+
+        append_length(client.output, body.size() + 1);
+        client.output.push_back(
+            response.has_value() ? STATUS_OK : STATUS_ERROR
+        );
+        client.output.append(body);
+        answered++;
+    }
+
+    client.input.erase(0, client.input.size() - input.size());
+    return true;
+}
+
+bool evlist::DeviceServer::send(Client& client) {
+    // Whatever the client does not accept now is sent by a later poll.
+    while (!client.output.empty()) {
+        auto sent = ::send(
+            client.socket.get(),
+            client.output.data(),
+            client.output.size(),
+            MSG_NOSIGNAL
+        );
+        if (sent < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return errno == EAGAIN || errno == EWOULDBLOCK;
+        }
+        client.output.erase(0, static_cast<std::size_t>(sent));
+    }
+    return true;
+}
+
+evlist::DeviceClient::DeviceClient(FileDescriptor socket)
+    : socket_{std::move(socket)} {}
+
+std::expected<evlist::DeviceClient, std::system_error>
+evlist::DeviceClient::connect(const std::filesystem::path& path) {
+    auto socket_address = address(path);
+    if (!socket_address.has_value()) {
+        return std::unexpected{socket_address.error()};
+    }
+
+    FileDescriptor socket{::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0)};
+    if (!socket.valid()) {
+        return std::unexpected{last_error("socket")};
+    }
+    if (::connect(
+            socket.get(),
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+            reinterpret_cast<const sockaddr*>(&*socket_address),
+            sizeof(*socket_address)
+        ) != 0) {
+        return std::unexpected{last_error("connect")};
+    }
+
+    return DeviceClient{std::move(socket)};
+}
+
+std::expected<std::string, std::system_error> evlist::DeviceClient::query(
+    const DeviceRequest& request
+) {
+    auto encoded = request.encode();
+    std::string message{};
+    append_length(message, encoded.size());
+    message.append(encoded);
+    if (auto sent = send_all(socket_.get(), message); !sent.has_value()) {
+        return std::unexpected{sent.error()};
+    }
+
+    std::array<char, LENGTH_SIZE> length{};
+    if (auto received = receive_all(socket_.get(), length);
+        !received.has_value()) {
+        return std::unexpected{received.error()};
+    }
+
+    std::string response(read_length({length.data(), length.size()}), '\0');
+    if (auto received = receive_all(socket_.get(), response);
+        !received.has_value()) {
+        return std::unexpected{received.error()};
+    }
+    if (response.empty()) {
+        return std::unexpected{std::system_error{
+            std::make_error_code(std::errc::bad_message), "empty response"
+        }};
+    }
+
+    auto status = response.front();
+    response.erase(0, 1);
+    if (status != STATUS_OK) {
+        return std::unexpected{std::system_error{
+            std::make_error_code(std::errc::invalid_argument), response
+        }};
+    }
+    return response;
+}
@@ -1,17 +1,26 @@
 #include "evlist/device.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cctype>
 #include <cstddef>
+#include <expected>
 #include <filesystem>
+#include <format>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <optional>
-#include <regex>
+#include <ranges>
+#include <span>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
 #include "evlist/cli.h"
+#include "evlist/plan.h"
 
 const evlist::fs::path& evlist::InputDevice::device_path() const {
     return device_;
@@ -22,13 +31,15 @@ evlist::InputDevice::InputDevice(
     std::string name,
     std::optional<std::string> by_id,
     std::optional<std::string> by_path,
-    std::vector<std::string> capabilities
+    std::vector<std::string> capabilities,
+    bool timed_out
 )
     : device_{std::move(device)},
       name_{std::move(name)},
       by_id_{std::move(by_id)},
       by_path_{std::move(by_path)},
-      capabilities_{std::move(capabilities)} {}
+      capabilities_{std::move(capabilities)},
+      timed_out_{timed_out} {}
 
 const std::optional<std::string>& evlist::InputDevice::by_id() const {
     return by_id_;
@@ -44,6 +55,73 @@ const std::vector<std::string>& evlist::InputDevice::capabilities() const {
     return capabilities_;
 }
 
+bool evlist::InputDevice::timed_out() const { return timed_out_; }
+
+const evlist::ParentDevice& evlist::InputDevice::parent() const {
+    return parent_;
+}
+
+evlist::InputDevice& evlist::InputDevice::with_parent(ParentDevice parent) {
+    parent_ = std::move(parent);
+    return *this;
+}
+
+std::string evlist::InputDevice::value(Filter column) const {
+    std::string out{};
+    value_into(column, out);
+    return out;
+}
+
+void evlist::InputDevice::value_into(Filter column, std::string& out) const {
+    switch (column) {
+        case Filter::DEVICE_PATH:
+            out = device_.native();
+            return;
+        case Filter::NAME:
+            out = name_;
+            return;
+        case Filter::BY_ID:
+            out = by_id_.has_value() ? *by_id_ : std::string_view{};
+            return;
+        case Filter::BY_PATH:
+            out = by_path_.has_value() ? *by_path_ : std::string_view{};
+            return;
+        case Filter::CAPABILITIES:
+            out.clear();
+            if (!capabilities_.empty()) {
+                out += "[";
+                for (const auto& name : capabilities_) {
+                    out += name;
+                    out += ", ";
+                }
+
+                out.erase(out.length() - 2);
+                out += "]";
+            }
+            return;
+        case Filter::PARENT:
+            out = parent_.name;
+            return;
+        case Filter::VENDOR:
+            out = parent_.vendor;
+            return;
+        case Filter::PRODUCT:
+            out = parent_.product;
+            return;
+        case Filter::BUS:
+            out = parent_.bus;
+            return;
+        case Filter::PHYS:
+            out = parent_.phys;
+            return;
+        case Filter::UNIQ:
+            out = parent_.uniq;
+            return;
+    }
+
+    out.clear();
+}
+
 std::vector<std::string> evlist::InputDevice::partition(std::string str) {
     if (str.empty()) {
         return {};
@@ -85,58 +163,197 @@ evlist::InputDevices::InputDevices(
     with_input_devices(std::move(input_devices));
 }
 
-evlist::InputDevices& evlist::InputDevices::filter(
-    const std::vector<std::pair<Filter, std::string>>& filter, bool use_regex
-) {
-    auto capacity = devices_.size();
-    auto devices = std::move(devices_);
-    this->devices_ = {};
-    this->devices_.reserve(capacity);
-
-    for (auto device : devices) {
-        auto keep_device = std::ranges::all_of(
-            filter, [&use_regex, &device, this](const auto& filter) {
-                if (use_regex) {
-                    if (filter_regex(device, filter.first, filter.second)) {
-                        return true;
-                    }
-                } else {
-                    if (filter_equality(device, filter.first, filter.second)) {
-                        return true;
-                    }
-                }
+std::expected<evlist::InputDevices, std::string>
+evlist::InputDevices::from_csv(std::string_view csv, Format output_format) {
+    auto records = parse_csv(csv);
+    if (!records.has_value()) {
+        return std::unexpected{records.error()};
+    }
+    if (records->empty()) {
+        return std::unexpected{"missing CSV header"};
+    }
 
-                return false;
+    const auto& header = records->front();
+    std::map<Filter, std::size_t> positions{};
+    for (const auto& columns : {std::span<const Filter>{COLUMNS},
+                                std::span<const Filter>{PARENT_COLUMNS}}) {
+        for (const auto column : columns) {
+            auto position =
+                std::ranges::find(header, InputDevices::header(column));
+            if (position != header.end()) {
+                positions.emplace(column, position - header.begin());
             }
-        );
+        }
+    }
+    if (!positions.contains(Filter::DEVICE_PATH)) {
+        return std::unexpected{
+            std::format("missing {} column", HEADER_DEVICE_PATH)
+        };
+    }
 
-        if (keep_device) {
-            this->devices_.emplace_back(std::move(device));
+    std::vector<InputDevice> devices{};
+    devices.reserve(records->size() - 1);
+    for (std::size_t row = 1; row < records->size(); row++) {
+        const auto& record = records->at(row);
+        if (record.size() != header.size()) {
+            return std::unexpected{std::format(
+                "row {} has {} fields but the header has {}",
+                row,
+                record.size(),
+                header.size()
+            )};
         }
+
+        auto field = [&positions, &record](Filter column) {
+            auto position = positions.find(column);
+            return position != positions.end() ? record[position->second]
+                                               : std::string{};
+        };
+        auto optional_field =
+            [&field](Filter column) -> std::optional<std::string> {
+            auto value = field(column);
+            if (value.empty()) {
+                return {};
+            }
+            return value;
+        };
+
+        std::vector<std::string> capabilities{};
+        auto capabilities_field = field(Filter::CAPABILITIES);
+        std::string_view list = capabilities_field;
+        if (list.starts_with('[') && list.ends_with(']')) {
+            list = list.substr(1, list.length() - 2);
+            constexpr std::string_view delimiter{", "};
+            for (const auto capability : std::views::split(list, delimiter)) {
+                capabilities.emplace_back(std::string_view{capability});
+            }
+        }
+
+        devices
+            .emplace_back(
+                field(Filter::DEVICE_PATH),
+                field(Filter::NAME),
+                optional_field(Filter::BY_ID),
+                optional_field(Filter::BY_PATH),
+                std::move(capabilities)
+            )
+            .with_parent(ParentDevice{
+                field(Filter::PARENT),
+                field(Filter::VENDOR),
+                field(Filter::PRODUCT),
+                field(Filter::BUS),
+                field(Filter::PHYS),
+                field(Filter::UNIQ)
+            });
     }
 
-    return *this;
+    return InputDevices{output_format, std::move(devices)};
+}
+
+std::expected<std::vector<std::vector<std::string>>, std::string>
+evlist::InputDevices::parse_csv(std::string_view csv) {
+    std::vector<std::vector<std::string>> records{};
+    std::vector<std::string> record{};
+    std::string field{};
+    auto quoted = false;
+
+    for (std::size_t i = 0; i < csv.length(); i++) {
+        auto character = csv[i];
+        if (quoted) {
+            if (character == '"' && i + 1 < csv.length() && csv[i + 1] == '"') {
+                field.push_back('"');
+                i++;
+            } else if (character == '"') {
+                quoted = false;
+            } else {
+                field.push_back(character);
+            }
+        } else if (character == '"') {
+            quoted = true;
+        } else if (character == ',') {
+            record.emplace_back(std::move(field));
+            field = {};
+        } else if (character == '\n') {
+            record.emplace_back(std::move(field));
+            records.emplace_back(std::move(record));
+            field = {};
+            record = {};
+        } else if (character != '\r') {
+            field.push_back(character);
+        }
+    }
+
+    if (quoted) {
+        return std::unexpected{"unterminated quoted CSV field"};
+    }
+    if (!field.empty() || !record.empty()) {
+        record.emplace_back(std::move(field));
+        records.emplace_back(std::move(record));
+    }
+
+    return records;
 }
 
-bool evlist::InputDevices::filter_regex(
-    const InputDevice& device, Filter filter, const std::string& value
+evlist::InputDevices& evlist::InputDevices::filter(
+    const std::vector<FilterTerm>& filter,
+    bool use_regex,
+    bool use_glob
 ) {
-    if (!regexes.contains(value)) {
-        regexes.emplace(value, std::regex{value});
+    if (filter.empty()) {
+        return *this;
     }
-    auto& regex = regexes[value];
 
-    return filter_device(device, filter, [&regex](const auto& compare) {
-        return std::regex_search(compare, regex);
+    FilterPlan plan{filter, use_regex, use_glob};
+    return this->filter(plan);
+}
+
+evlist::InputDevices& evlist::InputDevices::filter(FilterPlan& plan) {
+    indexes_.reset();
+    std::erase_if(devices_, [&plan](const auto& device) {
+        return !plan.matches(device);
     });
+
+    return *this;
+}
+
+std::span<const evlist::InputDevice* const> evlist::InputDevices::find(
+    Filter column, std::string_view value
+) const {
+    const auto& index = indexes_.get(column, devices_);
+    auto devices = index.find(value);
+    if (devices == index.end()) {
+        return {};
+    }
+    return devices->second;
+}
+
+std::vector<std::vector<evlist::InputDevice>>
+evlist::InputDevices::group_by_parent() const {
+    std::vector<std::vector<InputDevice>> groups{};
+    std::map<std::string_view, std::size_t> positions{};
+    for (const auto& device : devices_) {
+        const auto& parent = device.parent().name;
+        if (parent.empty()) {
+            groups.emplace_back().emplace_back(device);
+            continue;
+        }
+
+        auto [position, inserted] =
+            positions.try_emplace(parent, groups.size());
+        if (inserted) {
+            groups.emplace_back();
+        }
+        groups[position->second].emplace_back(device);
+    }
+
+    return groups;
 }
 
-bool evlist::InputDevices::filter_equality(
-    const InputDevice& device, Filter filter, const std::string& value
+evlist::InputDevices& evlist::InputDevices::with_parent_columns(
+    bool parent_columns
 ) {
-    return filter_device(device, filter, [&value](const auto& compare) {
-        return compare == value;
-    });
+    parent_columns_ = parent_columns;
+    return *this;
 }
 
 evlist::InputDevices& evlist::InputDevices::with_max_name(
@@ -174,11 +391,13 @@ evlist::InputDevices& evlist::InputDevices::with_max_by_path(
 evlist::InputDevices& evlist::InputDevices::with_input_devices(
     std::vector<InputDevice> input_devices
 ) {
+    indexes_.reset();
     devices_ = std::move(input_devices);
     return *this;
 }
 
-std::vector<evlist::InputDevice> evlist::InputDevices::devices() const {
+const std::vector<evlist::InputDevice>& evlist::InputDevices::devices(
+) const {
     return devices_;
 }
 
@@ -194,6 +413,133 @@ std::size_t evlist::InputDevices::max_by_path() const {
     return max_by_path_size_;
 }
 
+bool evlist::InputDevices::parent_columns() const { return parent_columns_; }
+
 evlist::Format evlist::InputDevices::output_format() const {
     return output_format_;
 }
+
+evlist::InputDevices::Indexes::Indexes(const Indexes& /*other*/) {}
+
+evlist::InputDevices::Indexes::Indexes(Indexes&& other) noexcept {
+    other.reset();
+}
+
+evlist::InputDevices::Indexes& evlist::InputDevices::Indexes::operator=(
+    const Indexes& other
+) {
+    if (this != &other) {
+        reset();
+    }
+    return *this;
+}
+
+evlist::InputDevices::Indexes& evlist::InputDevices::Indexes::operator=(
+    Indexes&& other
+) noexcept {
+    if (this != &other) {
+        reset();
+        other.reset();
+    }
+    return *this;
+}
+
+evlist::InputDevices::Indexes::~Indexes() { reset(); }
+
+evlist::InputDevices::Indexes::State&
+evlist::InputDevices::Indexes::state() const {
+    auto* state = state_.load(std::memory_order_acquire);
+    if (state != nullptr) {
+        return *state;
+    }
+
+    // Readers which race to create the state keep whichever was published
+    // first.
+    auto created = std::make_unique<State>();
+    if (state_.compare_exchange_strong(
+            state,
+            created.get(),
+            std::memory_order_acq_rel,
+            std::memory_order_acquire
+        )) {
+        return *created.release();
+    }
+    return *state;
+}
+
+const evlist::InputDevices::Indexes::Index&
+evlist::InputDevices::Indexes::get(
+    Filter column, const std::vector<InputDevice>& devices
+) const {
+    static_assert(
+        static_cast<std::size_t>(Filter::UNIQ) + 1 == INDEXED_COLUMNS
+    );
+
+    auto position = static_cast<std::size_t>(column);
+    auto& state = this->state();
+    auto& index = state.indexes.at(position);
+    std::call_once(state.built.at(position), [&index, &devices, column] {
+        // Keys point into the devices, and a missing symlink is keyed by an
+        // empty value to match how it is filtered.
+        auto insert = [&index](
+                          const InputDevice& device, std::string_view key
+                      ) {
+            auto& matches = index[key];
+            if (matches.empty() || matches.back() != &device) {
+                matches.emplace_back(&device);
+            }
+        };
+        auto optional = [](const std::optional<std::string>& value) {
+            return value.has_value() ? std::string_view{*value}
+                                     : std::string_view{};
+        };
+
+        for (const auto& device : devices) {
+            switch (column) {
+                case Filter::DEVICE_PATH:
+                    insert(device, device.device_path().native());
+                    break;
+                case Filter::NAME:
+                    insert(device, device.name());
+                    break;
+                case Filter::BY_ID:
+                    insert(device, optional(device.by_id()));
+                    break;
+                case Filter::BY_PATH:
+                    insert(device, optional(device.by_path()));
+                    break;
+                case Filter::CAPABILITIES:
+                    for (const auto& capability : device.capabilities()) {
+                        insert(device, capability);
+                    }
+                    break;
+                case Filter::PARENT:
+                    insert(device, device.parent().name);
+                    break;
+                case Filter::VENDOR:
+                    insert(device, device.parent().vendor);
+                    break;
+                case Filter::PRODUCT:
+                    insert(device, device.parent().product);
+                    break;
+                case Filter::BUS:
+                    insert(device, device.parent().bus);
+                    break;
+                case Filter::PHYS:
+                    insert(device, device.parent().phys);
+                    break;
+                case Filter::UNIQ:
+                    insert(device, device.parent().uniq);
+                    break;
+            }
+        }
+    });
+
+    return index;
+}
+
+void evlist::InputDevices::Indexes::reset() noexcept {
+    // Only called without concurrent readers, such as when devices change.
+    // NOLINTNEXTLINE(cppcoreguidelines-owning-memory)
+    delete state_.exchange(nullptr, std::memory_order_acq_rel);
+}
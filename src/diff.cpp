@@ -0,0 +1,164 @@
+#include "evlist/diff.h"
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+#include "evlist/cli.h"
+#include "evlist/device.h"
+
+evlist::ChangedInputDevice::ChangedInputDevice(
+    InputDevice previous, InputDevice current, std::vector<Filter> columns
+)
+    : previous_{std::move(previous)},
+      current_{std::move(current)},
+      columns_{std::move(columns)} {}
+
+const evlist::InputDevice& evlist::ChangedInputDevice::previous() const {
+    return previous_;
+}
+
+const evlist::InputDevice& evlist::ChangedInputDevice::current() const {
+    return current_;
+}
+
+const std::vector<evlist::Filter>& evlist::ChangedInputDevice::columns(
+) const {
+    return columns_;
+}
+
+evlist::InputDevicesDiff::InputDevicesDiff(
+    Format output_format,
+    std::vector<InputDevice> added,
+    std::vector<InputDevice> removed,
+    std::vector<ChangedInputDevice> changed
+)
+    : output_format_{output_format},
+      added_{std::move(added)},
+      removed_{std::move(removed)},
+      changed_{std::move(changed)} {}
+
+const std::vector<evlist::InputDevice>& evlist::InputDevicesDiff::added(
+) const {
+    return added_;
+}
+
+const std::vector<evlist::InputDevice>& evlist::InputDevicesDiff::removed(
+) const {
+    return removed_;
+}
+
+const std::vector<evlist::ChangedInputDevice>&
+evlist::InputDevicesDiff::changed() const {
+    return changed_;
+}
+
+bool evlist::InputDevicesDiff::empty() const {
+    return added_.empty() && removed_.empty() && changed_.empty();
+}
+
+evlist::Format evlist::InputDevicesDiff::output_format() const {
+    return output_format_;
+}
+
+evlist::InputDevicesDiff evlist::InputDevices::diff(const InputDevices& other
+) const {
+    // Devices are normally already sorted by the lister, so only sort views
+    // of them if necessary.
+    auto sorted = [](const std::vector<InputDevice>& devices) {
+        std::vector<const InputDevice*> out{};
+        out.reserve(devices.size());
+        std::ranges::transform(
+            devices, std::back_inserter(out), [](auto& device) {
+                return &device;
+            }
+        );
+
+        auto less = [](const auto* lhs, const auto* rhs) {
+            return *lhs < *rhs;
+        };
+        if (!std::ranges::is_sorted(out, less)) {
+            std::ranges::sort(out, less);
+        }
+        return out;
+    };
+
+    auto previous = sorted(devices_);
+    auto current = sorted(other.devices_);
+
+    std::vector<InputDevice> added{};
+    std::vector<InputDevice> removed{};
+    std::vector<ChangedInputDevice> changed{};
+
+    auto lhs = previous.begin();
+    auto rhs = current.begin();
+    while (lhs != previous.end() && rhs != current.end()) {
+        auto order = **lhs <=> **rhs;
+        if (order < 0) {
+            removed.emplace_back(**lhs++);
+        } else if (order > 0) {
+            added.emplace_back(**rhs++);
+        } else {
+            std::vector<Filter> columns{};
+            for (const auto column : COLUMNS) {
+                if (!column_equal(**lhs, **rhs, column)) {
+                    columns.emplace_back(column);
+                }
+            }
+
+            if (!columns.empty()) {
+                changed.emplace_back(**lhs, **rhs, std::move(columns));
+            }
+            lhs++;
+            rhs++;
+        }
+    }
+
+    std::ranges::transform(
+        lhs, previous.end(), std::back_inserter(removed), [](auto* device) {
+            return *device;
+        }
+    );
+    std::ranges::transform(
+        rhs, current.end(), std::back_inserter(added), [](auto* device) {
+            return *device;
+        }
+    );
+
+    return InputDevicesDiff{
+        other.output_format(),
+        std::move(added),
+        std::move(removed),
+        std::move(changed)
+    };
+}
+
+bool evlist::InputDevices::column_equal(
+    const InputDevice& lhs, const InputDevice& rhs, Filter column
+) {
+    // Missing symlinks are output as empty values, so treat them as equal to
+    // empty values read back from a previous listing.
+    switch (column) {
+        case Filter::DEVICE_PATH:
+            return lhs.device_path() == rhs.device_path();
+        case Filter::NAME:
+            return lhs.name() == rhs.name();
+        case Filter::BY_ID:
+            return lhs.by_id().value_or("") == rhs.by_id().value_or("");
+        case Filter::BY_PATH:
+            return lhs.by_path().value_or("") == rhs.by_path().value_or("");
+        case Filter::CAPABILITIES:
+            return lhs.capabilities() == rhs.capabilities();
+        case Filter::PARENT:
+        case Filter::VENDOR:
+        case Filter::PRODUCT:
+        case Filter::BUS:
+        case Filter::PHYS:
+        case Filter::UNIQ:
+            return lhs.value(column) == rhs.value(column);
+    }
+
+    return true;
+}
@@ -0,0 +1,171 @@
+#include "evlist/events.h"
+
+#include <fcntl.h>
+#include <linux/input.h>
+#include <sys/epoll.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <expected>
+#include <span>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include "evlist/device.h"
+
+evlist::FileDescriptor::FileDescriptor(int descriptor)
+    : descriptor_{descriptor} {}
+
+evlist::FileDescriptor::~FileDescriptor() { close(); }
+
+evlist::FileDescriptor::FileDescriptor(FileDescriptor&& other) noexcept
+    : descriptor_{std::exchange(other.descriptor_, -1)} {}
+
+evlist::FileDescriptor& evlist::FileDescriptor::operator=(
+    FileDescriptor&& other
+) noexcept {
+    if (this != &other) {
+        close();
+        descriptor_ = std::exchange(other.descriptor_, -1);
+    }
+    return *this;
+}
+
+int evlist::FileDescriptor::get() const { return descriptor_; }
+
+bool evlist::FileDescriptor::valid() const { return descriptor_ >= 0; }
+
+void evlist::FileDescriptor::close() {
+    if (valid()) {
+        ::close(std::exchange(descriptor_, -1));
+    }
+}
+
+evlist::EventPoller::EventPoller(
+    FileDescriptor epoll, std::vector<FileDescriptor> descriptors
+)
+    : epoll_{std::move(epoll)},
+      descriptors_{std::move(descriptors)},
+      open_{descriptors_.size()},
+      ready_(descriptors_.size()),
+      buffer_(BATCH_SIZE) {
+    ready_devices_.reserve(descriptors_.size());
+}
+
+std::expected<evlist::EventPoller, std::system_error> evlist::EventPoller::open(
+    const std::vector<InputDevice>& devices
+) {
+    std::vector<FileDescriptor> descriptors{};
+    descriptors.reserve(devices.size());
+    for (const auto& device : devices) {
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg,hicpp-vararg)
+        FileDescriptor descriptor{::open(
+            device.device_path().c_str(), O_RDONLY | O_NONBLOCK | O_CLOEXEC
+        )};
+        if (!descriptor.valid()) {
+            return std::unexpected{std::system_error{
+                errno, std::generic_category(), device.device_path().string()
+            }};
+        }
+        descriptors.emplace_back(std::move(descriptor));
+    }
+
+    return from_descriptors(std::move(descriptors));
+}
+
+std::expected<evlist::EventPoller, std::system_error>
+evlist::EventPoller::from_descriptors(std::vector<FileDescriptor> descriptors) {
+    FileDescriptor epoll{epoll_create1(EPOLL_CLOEXEC)};
+    if (!epoll.valid()) {
+        return std::unexpected{
+            std::system_error{errno, std::generic_category(), "epoll_create1"}
+        };
+    }
+
+    for (std::size_t device = 0; device < descriptors.size(); device++) {
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.u64 = device;
+        if (epoll_ctl(
+                epoll.get(), EPOLL_CTL_ADD, descriptors[device].get(), &event
+            ) != 0) {
+            return std::unexpected{
+                std::system_error{errno, std::generic_category(), "epoll_ctl"}
+            };
+        }
+    }
+
+    return EventPoller{std::move(epoll), std::move(descriptors)};
+}
+
+std::size_t evlist::EventPoller::size() const { return descriptors_.size(); }
+
+bool evlist::EventPoller::closed() const { return open_ == 0; }
+
+int evlist::EventPoller::descriptor(std::size_t device) const {
+    return descriptors_.at(device).get();
+}
+
+std::expected<std::span<const std::size_t>, std::system_error>
+evlist::EventPoller::wait(std::chrono::milliseconds timeout) {
+    ready_devices_.clear();
+    if (closed()) {
+        return ready_devices_;
+    }
+
+    auto ready = epoll_wait(
+        epoll_.get(),
+        ready_.data(),
+        static_cast<int>(ready_.size()),
+        static_cast<int>(timeout.count())
+    );
+    if (ready < 0) {
+        if (errno == EINTR) {
+            return ready_devices_;
+        }
+        return std::unexpected{
+            std::system_error{errno, std::generic_category(), "epoll_wait"}
+        };
+    }
+
+    for (const auto& event : std::span{ready_}.first(ready)) {
+        ready_devices_.emplace_back(event.data.u64);
+    }
+    return ready_devices_;
+}
+
+std::expected<std::span<const input_event>, std::system_error>
+evlist::EventPoller::read(std::size_t device) {
+    auto& descriptor = descriptors_[device];
+    if (!descriptor.valid()) {
+        return {};
+    }
+
+    auto bytes = ::read(
+        descriptor.get(), buffer_.data(), buffer_.size() * sizeof(input_event)
+    );
+    if (bytes < 0 && (errno == EAGAIN || errno == EINTR)) {
+        return {};
+    }
+
+    // The device was removed or the input ended.
+    if (bytes == 0 || (bytes < 0 && errno == ENODEV)) {
+        epoll_ctl(epoll_.get(), EPOLL_CTL_DEL, descriptor.get(), nullptr);
+        descriptor.close();
+        open_--;
+        return {};
+    }
+
+    if (bytes < 0) {
+        return std::unexpected{
+            std::system_error{errno, std::generic_category(), "read"}
+        };
+    }
+
+    return std::span{buffer_}.first(
+        static_cast<std::size_t>(bytes) / sizeof(input_event)
+    );
+}
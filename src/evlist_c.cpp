@@ -0,0 +1,235 @@
+#include "evlist/evlist_c.h"
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <limits>
+#include <new>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "evlist/cli.h"
+#include "evlist/codes.h"
+#include "evlist/device.h"
+#include "evlist/list.h"
+#include "evlist_c_internal.h"
+
+namespace {
+
+static_assert(sizeof(evlist_devices) == 24);
+static_assert(sizeof(evlist_device_record) == 104);
+
+// Columns are converted to filters by value, so they must stay in sync.
+static_assert(
+    EVLIST_COLUMN_DEVICE_PATH == static_cast<int>(evlist::Filter::DEVICE_PATH)
+);
+static_assert(EVLIST_COLUMN_NAME == static_cast<int>(evlist::Filter::NAME));
+static_assert(EVLIST_COLUMN_BY_ID == static_cast<int>(evlist::Filter::BY_ID));
+static_assert(
+    EVLIST_COLUMN_BY_PATH == static_cast<int>(evlist::Filter::BY_PATH)
+);
+static_assert(
+    EVLIST_COLUMN_CAPABILITIES ==
+    static_cast<int>(evlist::Filter::CAPABILITIES)
+);
+static_assert(
+    EVLIST_COLUMN_PARENT == static_cast<int>(evlist::Filter::PARENT)
+);
+static_assert(
+    EVLIST_COLUMN_VENDOR == static_cast<int>(evlist::Filter::VENDOR)
+);
+static_assert(
+    EVLIST_COLUMN_PRODUCT == static_cast<int>(evlist::Filter::PRODUCT)
+);
+static_assert(EVLIST_COLUMN_BUS == static_cast<int>(evlist::Filter::BUS));
+static_assert(EVLIST_COLUMN_PHYS == static_cast<int>(evlist::Filter::PHYS));
+static_assert(EVLIST_COLUMN_UNIQ == static_cast<int>(evlist::Filter::UNIQ));
+
+std::string join_capabilities(const evlist::InputDevice& device) {
+    std::string out{};
+    for (const auto& capability : device.capabilities()) {
+        if (!out.empty()) {
+            out += ',';
+        }
+        out += capability;
+    }
+    return out;
+}
+
+uint64_t capability_bits(const evlist::InputDevice& device) {
+    uint64_t bits = 0;
+    for (const auto& capability : device.capabilities()) {
+        auto code = evlist::EventCodes::code(capability);
+        if (code.has_value() && code->type == evlist::CodeType::EV &&
+            code->code < std::numeric_limits<uint64_t>::digits) {
+            bits |= uint64_t{1} << code->code;
+        }
+    }
+    return bits;
+}
+
+} // namespace
+
+evlist_devices* evlist::pack_devices(const std::vector<InputDevice>& devices) {
+    // Measure the strings first so that the buffer is allocated once.
+    std::vector<std::string> capabilities{};
+    capabilities.reserve(devices.size());
+    std::size_t strings_size = 0;
+    auto measure = [&strings_size](std::string_view value) {
+        strings_size += value.size() + 1;
+    };
+    for (const auto& device : devices) {
+        capabilities.emplace_back(join_capabilities(device));
+        measure(device.device_path().native());
+        measure(device.name());
+        measure(device.by_id().value_or(""));
+        measure(device.by_path().value_or(""));
+        measure(capabilities.back());
+        const auto& parent = device.parent();
+        measure(parent.name);
+        measure(parent.vendor);
+        measure(parent.product);
+        measure(parent.bus);
+        measure(parent.phys);
+        measure(parent.uniq);
+    }
+
+    const auto records_offset = sizeof(evlist_devices);
+    const auto strings_offset =
+        records_offset + (devices.size() * sizeof(evlist_device_record));
+    const auto size = strings_offset + strings_size;
+    if (size > std::numeric_limits<uint32_t>::max()) {
+        return nullptr;
+    }
+
+    // NOLINTNEXTLINE(cppcoreguidelines-no-malloc,hicpp-no-malloc)
+    auto* buffer = static_cast<std::byte*>(std::calloc(1, size));
+    if (buffer == nullptr) {
+        return nullptr;
+    }
+
+    evlist_devices header{
+        .abi_version = EVLIST_ABI_VERSION,
+        .record_size = sizeof(evlist_device_record),
+        .count = static_cast<uint32_t>(devices.size()),
+        .records_offset = records_offset,
+        .size = size
+    };
+    std::memcpy(buffer, &header, sizeof(header));
+
+    auto offset = strings_offset;
+    auto write = [&buffer, &offset](std::string_view value) {
+        // The buffer is zeroed, so the NUL terminator is already present.
+        std::memcpy(buffer + offset, value.data(), value.size());
+        evlist_string out{
+            .offset = static_cast<uint32_t>(offset),
+            .length = static_cast<uint32_t>(value.size())
+        };
+        offset += value.size() + 1;
+        return out;
+    };
+    for (std::size_t i = 0; i < devices.size(); i++) {
+        const auto& device = devices[i];
+        const auto& parent = device.parent();
+
+        uint32_t flags = 0;
+        if (device.by_id().has_value()) {
+            flags |= EVLIST_DEVICE_HAS_BY_ID;
+        }
+        if (device.by_path().has_value()) {
+            flags |= EVLIST_DEVICE_HAS_BY_PATH;
+        }
+        if (device.timed_out()) {
+            flags |= EVLIST_DEVICE_TIMED_OUT;
+        }
+
+        evlist_device_record record{
+            .device_path = write(device.device_path().native()),
+            .name = write(device.name()),
+            .by_id = write(device.by_id().value_or("")),
+            .by_path = write(device.by_path().value_or("")),
+            .capabilities = write(capabilities[i]),
+            .capability_bits = capability_bits(device),
+            .flags = flags,
+            .reserved = 0,
+            .parent = write(parent.name),
+            .vendor = write(parent.vendor),
+            .product = write(parent.product),
+            .bus = write(parent.bus),
+            .phys = write(parent.phys),
+            .uniq = write(parent.uniq)
+        };
+        std::memcpy(
+            buffer + records_offset + (i * sizeof(record)),
+            &record,
+            sizeof(record)
+        );
+    }
+
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    return reinterpret_cast<evlist_devices*>(buffer);
+}
+
+extern "C" int evlist_list_devices(
+    const evlist_filter* filters,
+    size_t filter_count,
+    int use_regex,
+    evlist_devices** out
+) {
+    if (out == nullptr || (filters == nullptr && filter_count != 0)) {
+        return EINVAL;
+    }
+    *out = nullptr;
+
+    // Exceptions, such as from an invalid regex, must not cross the C ABI.
+    try {
+        std::vector<evlist::FilterTerm> filter{};
+        for (std::size_t i = 0; i < filter_count; i++) {
+            const auto& [column, value] = filters[i];
+            if (column < EVLIST_COLUMN_DEVICE_PATH ||
+                column > EVLIST_COLUMN_UNIQ || value == nullptr) {
+                return EINVAL;
+            }
+            filter.emplace_back(
+                evlist::FilterTerm{static_cast<evlist::Filter>(column), value}
+            );
+        }
+
+        auto devices = evlist::InputDeviceLister{
+            evlist::Format::TABLE, use_regex != 0, std::move(filter)
+        }
+                           .list_input_devices();
+        if (!devices.has_value()) {
+            return devices.error().code().value();
+        }
+
+        *out = evlist::pack_devices(devices->devices());
+        return *out == nullptr ? ENOMEM : 0;
+    } catch (const std::bad_alloc&) {
+        return ENOMEM;
+    } catch (const std::exception&) {
+        return EINVAL;
+    }
+}
+
+extern "C" const evlist_device_record* evlist_device_at(
+    const evlist_devices* devices, uint32_t index
+) {
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    const auto* bytes = reinterpret_cast<const std::byte*>(devices);
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    return reinterpret_cast<const evlist_device_record*>(
+        bytes + devices->records_offset +
+        (static_cast<std::size_t>(index) * devices->record_size)
+    );
+}
+
+extern "C" void evlist_free(evlist_devices* devices) {
+    // NOLINTNEXTLINE(cppcoreguidelines-no-malloc,hicpp-no-malloc)
+    std::free(devices);
+}
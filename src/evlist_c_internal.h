@@ -0,0 +1,32 @@
+/**
+ * @file evlist_c_internal.h
+ *
+ * Contains definitions shared by the C ABI and its tests, which are not
+ * part of the stable C header.
+ */
+
+#ifndef EVLIST_EVLIST_C_INTERNAL_H
+#define EVLIST_EVLIST_C_INTERNAL_H
+
+#include <vector>
+
+#include "evlist/device.h"
+#include "evlist/evlist_c.h"
+
+/**
+ * The namespace for this project.
+ */
+namespace evlist {
+
+/**
+ * Pack devices into a buffer with the layout of `evlist_devices`, using a
+ * single allocation which is freed using `evlist_free`.
+ *
+ * @param devices the devices
+ * @return the buffer, or null if it could not be allocated
+ */
+evlist_devices* pack_devices(const std::vector<InputDevice>& devices);
+
+} // namespace evlist
+
+#endif // EVLIST_EVLIST_C_INTERNAL_H
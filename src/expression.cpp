@@ -0,0 +1,326 @@
+#include "evlist/expression.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <format>
+#include <iterator>
+#include <optional>
+#include <regex>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "evlist/cli.h"
+#include "evlist/device.h"
+#include "evlist/memo.h"
+#include "evlist/search.h"
+
+/**
+ * A recursive descent parser which emits the program while parsing. The
+ * program has a single result register, so `a and b` compiles to `a`, a jump
+ * past `b` if the result is false, then `b`.
+ */
+class evlist::FilterExpression::Parser {
+public:
+    explicit Parser(std::string_view input) : input_{input} {}
+
+    std::expected<FilterExpression, std::string> parse() && {
+        if (auto result = parse_or(); !result.has_value()) {
+            return std::unexpected{result.error()};
+        }
+        skip_whitespace();
+        if (position_ != input_.length()) {
+            return error("expected `and`, `or` or the end of the expression");
+        }
+        return std::move(expression_);
+    }
+
+private:
+    std::string_view input_;
+    std::size_t position_{0};
+    FilterExpression expression_{};
+
+    std::unexpected<std::string> error(std::string_view message) const {
+        return std::unexpected{
+            std::format("{} at position {}", message, position_)
+        };
+    }
+
+    void skip_whitespace() {
+        while (position_ < input_.length() &&
+               std::isspace(static_cast<unsigned char>(input_[position_])) !=
+                   0) {
+            position_++;
+        }
+    }
+
+    static bool is_word(char character) {
+        return std::isalnum(static_cast<unsigned char>(character)) != 0 ||
+               character == '_';
+    }
+
+    bool consume_keyword(std::string_view keyword) {
+        skip_whitespace();
+        auto rest = input_.substr(position_);
+        if (!rest.starts_with(keyword) ||
+            (rest.length() > keyword.length() &&
+             is_word(rest[keyword.length()]))) {
+            return false;
+        }
+        position_ += keyword.length();
+        return true;
+    }
+
+    bool consume(char character) {
+        skip_whitespace();
+        if (position_ < input_.length() && input_[position_] == character) {
+            position_++;
+            return true;
+        }
+        return false;
+    }
+
+    std::size_t emit(Opcode opcode, uint32_t operand = 0) {
+        expression_.program_.emplace_back(opcode, operand);
+        return expression_.program_.size() - 1;
+    }
+
+    void patch(const std::vector<std::size_t>& jumps) {
+        auto target = static_cast<uint32_t>(expression_.program_.size());
+        for (auto jump : jumps) {
+            expression_.program_[jump].operand = target;
+        }
+    }
+
+    std::expected<void, std::string> parse_or() {
+        // A true result stays true through later jumps, so every jump can go
+        // straight to the end of the chain.
+        std::vector<std::size_t> jumps{};
+        if (auto result = parse_and(); !result.has_value()) {
+            return result;
+        }
+        while (consume_keyword("or")) {
+            jumps.emplace_back(emit(Opcode::JUMP_IF_TRUE));
+            if (auto result = parse_and(); !result.has_value()) {
+                return result;
+            }
+        }
+        patch(jumps);
+        return {};
+    }
+
+    std::expected<void, std::string> parse_and() {
+        std::vector<std::size_t> jumps{};
+        if (auto result = parse_not(); !result.has_value()) {
+            return result;
+        }
+        while (consume_keyword("and")) {
+            jumps.emplace_back(emit(Opcode::JUMP_IF_FALSE));
+            if (auto result = parse_not(); !result.has_value()) {
+                return result;
+            }
+        }
+        patch(jumps);
+        return {};
+    }
+
+    std::expected<void, std::string> parse_not() {
+        if (consume_keyword("not")) {
+            if (auto result = parse_not(); !result.has_value()) {
+                return result;
+            }
+            emit(Opcode::NOT);
+            return {};
+        }
+
+        if (consume('(')) {
+            if (auto result = parse_or(); !result.has_value()) {
+                return result;
+            }
+            if (!consume(')')) {
+                return error("expected `)`");
+            }
+            return {};
+        }
+
+        return parse_comparison();
+    }
+
+    std::expected<void, std::string> parse_comparison() {
+        skip_whitespace();
+        auto start = position_;
+        while (position_ < input_.length() && is_word(input_[position_])) {
+            position_++;
+        }
+        if (start == position_) {
+            return error("expected a comparison");
+        }
+
+        auto key = input_.substr(start, position_ - start);
+        auto column = filter_from_name(key);
+        if (!column.has_value()) {
+            return error(std::format("unknown key `{}`", key));
+        }
+
+        // The operators of `--filter` are checked first, so that `~=` is
+        // not taken as a regex starting with `=`.
+        skip_whitespace();
+        auto rest = input_.substr(position_);
+        auto op = FilterOperator::EQUAL;
+        auto regex = false;
+        auto found = std::ranges::find_if(
+            FILTER_OPERATORS,
+            [&rest](const auto& entry) {
+                return rest.length() > 1 && rest[0] == entry.first &&
+                       rest[1] == '=';
+            }
+        );
+        if (found != FILTER_OPERATORS.end()) {
+            op = found->second;
+            position_ += 2;
+        } else if (consume('~')) {
+            regex = true;
+        } else if (!consume('=')) {
+            return error("expected `=`, `*=`, `^=`, `~=` or `~`");
+        }
+
+        auto value = parse_value();
+        if (!value.has_value()) {
+            return std::unexpected{value.error()};
+        }
+
+        // Identical comparisons share a predicate.
+        auto& predicates = expression_.predicates_;
+        auto predicate = std::ranges::find_if(
+            predicates,
+            [&column, &value, &op, &regex](const auto& predicate) {
+                return predicate.column == *column &&
+                       predicate.value == *value && predicate.op == op &&
+                       predicate.regex.has_value() == regex;
+            }
+        );
+        if (predicate == predicates.end()) {
+            std::optional<std::regex> compiled{};
+            if (regex) {
+                try {
+                    compiled.emplace(*value);
+                } catch (const std::regex_error& err) {
+                    return error(std::format("invalid regex: {}", err.what()));
+                }
+            }
+            predicates.emplace_back(
+                *column, std::move(*value), op, std::move(compiled)
+            );
+            predicate = std::prev(predicates.end());
+        }
+
+        emit(
+            Opcode::TEST, static_cast<uint32_t>(predicate - predicates.begin())
+        );
+        return {};
+    }
+
+    std::expected<std::string, std::string> parse_value() {
+        skip_whitespace();
+        std::string value{};
+        if (position_ < input_.length() && input_[position_] == '"') {
+            position_++;
+            while (position_ < input_.length() && input_[position_] != '"') {
+                if (input_[position_] == '\\' &&
+                    position_ + 1 < input_.length()) {
+                    position_++;
+                }
+                value.push_back(input_[position_++]);
+            }
+            if (position_ == input_.length()) {
+                return error("unterminated quoted value");
+            }
+            position_++;
+            return value;
+        }
+
+        while (position_ < input_.length() && input_[position_] != ')' &&
+               std::isspace(static_cast<unsigned char>(input_[position_])) ==
+                   0) {
+            value.push_back(input_[position_++]);
+        }
+        if (value.empty()) {
+            return error("expected a value");
+        }
+        return value;
+    }
+};
+
+std::expected<evlist::FilterExpression, std::string>
+evlist::FilterExpression::parse(std::string_view expression) {
+    return Parser{expression}.parse();
+}
+
+evlist::FilterExpression::Memos evlist::FilterExpression::memos() const {
+    return Memos(predicates_.size());
+}
+
+bool evlist::FilterExpression::matches(const InputDevice& device) const {
+    auto memos = this->memos();
+    return matches(device, memos);
+}
+
+bool evlist::FilterExpression::matches(
+    const InputDevice& device, Memos& memos
+) const {
+    auto result = false;
+    std::size_t counter = 0;
+    while (counter < program_.size()) {
+        const auto& [opcode, operand] = program_[counter];
+        switch (opcode) {
+            case Opcode::TEST:
+                result = test(device, predicates_[operand], memos[operand]);
+                counter++;
+                break;
+            case Opcode::JUMP_IF_FALSE:
+                counter = result ? counter + 1 : operand;
+                break;
+            case Opcode::JUMP_IF_TRUE:
+                counter = result ? operand : counter + 1;
+                break;
+            case Opcode::NOT:
+                result = !result;
+                counter++;
+                break;
+        }
+    }
+
+    return result;
+}
+
+std::size_t evlist::FilterExpression::size() const { return program_.size(); }
+
+bool evlist::FilterExpression::test(
+    const InputDevice& device, const Predicate& predicate, PredicateMemo& memo
+) {
+    if (predicate.regex.has_value()) {
+        auto search = [&predicate](std::string_view value) {
+            return std::regex_search(
+                value.begin(), value.end(), *predicate.regex
+            );
+        };
+        return InputDevices::filter_device(
+            device,
+            predicate.column,
+            [&predicate, &memo, &search](const auto& compare) {
+                return repeats(predicate.column) ? memo(compare, search)
+                                                 : search(compare);
+            }
+        );
+    }
+
+    return InputDevices::filter_device(
+        device, predicate.column, [&predicate](const auto& compare) {
+            return evlist::compare(predicate.op, compare, predicate.value);
+        }
+    );
+}
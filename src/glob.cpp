@@ -0,0 +1,200 @@
+#include "evlist/glob.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+evlist::Glob::Glob(std::string_view pattern) {
+    Segment current{};
+    std::size_t position = 0;
+    while (position < pattern.length()) {
+        auto character = pattern[position];
+        if (character == '*') {
+            segments_.emplace_back(std::move(current));
+            current = {};
+            position++;
+            continue;
+        }
+        if (character == '?') {
+            current.atoms.emplace_back(Kind::ANY, '\0', 0);
+            position++;
+            continue;
+        }
+        if (character == '[') {
+            if (auto end = parse_class(pattern, position + 1);
+                end != std::string_view::npos) {
+                current.atoms.emplace_back(
+                    Kind::CLASS,
+                    '\0',
+                    static_cast<uint32_t>(classes_.size() - 1)
+                );
+                position = end;
+                continue;
+            }
+        }
+
+        if (character == '\\' && position + 1 < pattern.length()) {
+            position++;
+        }
+        current.atoms.emplace_back(Kind::LITERAL, pattern[position], 0);
+        position++;
+    }
+    segments_.emplace_back(std::move(current));
+
+    // Repeated stars leave empty segments between them, which always match.
+    if (segments_.size() > 2) {
+        auto middle = std::ranges::remove_if(
+            segments_.begin() + 1,
+            segments_.end() - 1,
+            [](const auto& segment) { return segment.atoms.empty(); }
+        );
+        segments_.erase(middle.begin(), middle.end());
+    }
+
+    for (auto& segment : segments_) {
+        if (std::ranges::all_of(segment.atoms, [](const auto& atom) {
+                return atom.kind == Kind::LITERAL;
+            })) {
+            std::string literal{};
+            literal.reserve(segment.atoms.size());
+            for (const auto& atom : segment.atoms) {
+                literal.push_back(atom.character);
+            }
+            segment.literal = std::move(literal);
+        }
+    }
+}
+
+bool evlist::Glob::matches(std::string_view value) const {
+    const auto& first = segments_.front();
+    if (segments_.size() == 1) {
+        return value.length() == first.atoms.size() &&
+               matches_at(first, value, 0);
+    }
+
+    const auto& last = segments_.back();
+    if (value.length() < first.atoms.size() + last.atoms.size()) {
+        return false;
+    }
+    auto end = value.length() - last.atoms.size();
+    if (!matches_at(first, value, 0) || !matches_at(last, value, end)) {
+        return false;
+    }
+
+    // The leftmost match of each segment leaves the most room for the rest,
+    // so there is never a reason to backtrack.
+    auto position = first.atoms.size();
+    auto middle = value.substr(0, end);
+    for (std::size_t i = 1; i + 1 < segments_.size(); i++) {
+        position = find(segments_[i], middle, position);
+        if (position == std::string_view::npos) {
+            return false;
+        }
+        position += segments_[i].atoms.size();
+    }
+
+    return true;
+}
+
+std::optional<std::string_view> evlist::Glob::literal() const {
+    if (segments_.size() != 1 || !segments_.front().literal.has_value()) {
+        return std::nullopt;
+    }
+    return *segments_.front().literal;
+}
+
+std::size_t evlist::Glob::parse_class(
+    std::string_view pattern, std::size_t position
+) {
+    CharacterSet set{};
+    auto negate = position < pattern.length() &&
+                  (pattern[position] == '!' || pattern[position] == '^');
+    if (negate) {
+        position++;
+    }
+
+    // A `]` at the start of the class is a member rather than its end.
+    auto start = position;
+    while (position < pattern.length() &&
+           (pattern[position] != ']' || position == start)) {
+        if (pattern[position] == '\\' && position + 1 < pattern.length()) {
+            position++;
+        }
+        auto lower = static_cast<unsigned char>(pattern[position]);
+        auto upper = lower;
+        if (position + 2 < pattern.length() && pattern[position + 1] == '-' &&
+            pattern[position + 2] != ']') {
+            position += 2;
+            if (pattern[position] == '\\' && position + 1 < pattern.length()) {
+                position++;
+            }
+            upper = static_cast<unsigned char>(pattern[position]);
+        }
+        for (auto character = static_cast<std::size_t>(lower);
+             character <= upper;
+             character++) {
+            set.set(character);
+        }
+        position++;
+    }
+
+    if (position >= pattern.length()) {
+        return std::string_view::npos;
+    }
+
+    classes_.emplace_back(negate ? ~set : set);
+    return position + 1;
+}
+
+bool evlist::Glob::matches_at(
+    const Segment& segment, std::string_view value, std::size_t position
+) const {
+    if (segment.literal.has_value()) {
+        return value.substr(position).starts_with(*segment.literal);
+    }
+    if (value.length() - position < segment.atoms.size()) {
+        return false;
+    }
+
+    for (const auto& atom : segment.atoms) {
+        auto character = value[position++];
+        switch (atom.kind) {
+            case Kind::LITERAL:
+                if (character != atom.character) {
+                    return false;
+                }
+                break;
+            case Kind::ANY:
+                break;
+            case Kind::CLASS:
+                if (!classes_[atom.set].test(
+                        static_cast<unsigned char>(character)
+                    )) {
+                    return false;
+                }
+                break;
+        }
+    }
+
+    return true;
+}
+
+std::size_t evlist::Glob::find(
+    const Segment& segment, std::string_view value, std::size_t position
+) const {
+    if (segment.literal.has_value()) {
+        return value.find(*segment.literal, position);
+    }
+
+    for (; position + segment.atoms.size() <= value.length(); position++) {
+        if (matches_at(segment, value, position)) {
+            return position;
+        }
+    }
+    return std::string_view::npos;
+}
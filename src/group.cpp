@@ -0,0 +1,61 @@
+#include "evlist/group.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "evlist/cli.h"
+#include "evlist/device.h"
+
+evlist::DeviceGroups::DeviceGroups(Format output_format, Filter column)
+    : output_format_{output_format}, column_{column} {}
+
+void evlist::DeviceGroups::add(const InputDevice& device) {
+    if (column_ == Filter::CAPABILITIES) {
+        for (const auto& capability : device.capabilities()) {
+            count(capability);
+        }
+        return;
+    }
+
+    device.value_into(column_, value_);
+    if (column_ == Filter::BY_PATH) {
+        // By-path names start with the bus, such as `pci-0000:00:14.0-...`.
+        std::string_view name{value_};
+        name = name.substr(name.rfind('/') + 1);
+        count(name.substr(0, name.find('-')));
+        return;
+    }
+    count(value_);
+}
+
+std::vector<std::pair<std::string_view, std::size_t>>
+evlist::DeviceGroups::counts() const {
+    std::vector<std::pair<std::string_view, std::size_t>> groups{
+        counts_.begin(), counts_.end()
+    };
+    std::ranges::sort(groups, [](const auto& lhs, const auto& rhs) {
+        if (lhs.second != rhs.second) {
+            return lhs.second > rhs.second;
+        }
+        return lhs.first < rhs.first;
+    });
+    return groups;
+}
+
+evlist::Filter evlist::DeviceGroups::column() const { return column_; }
+
+evlist::Format evlist::DeviceGroups::output_format() const {
+    return output_format_;
+}
+
+void evlist::DeviceGroups::count(std::string_view value) {
+    if (auto group = counts_.find(value); group != counts_.end()) {
+        group->second++;
+        return;
+    }
+    counts_.emplace(value, 1);
+}
@@ -0,0 +1,225 @@
+#include "evlist/hotplug.h"
+
+#include <linux/netlink.h>
+#include <poll.h>
+#include <sys/socket.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstring>
+#include <expected>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <system_error>
+#include <utility>
+
+#include "evlist/device.h"
+#include "evlist/events.h"
+#include "evlist/list.h"
+
+namespace {
+
+// The multicast group that the kernel sends uevents to, as opposed to the
+// group that udev rebroadcasts them to.
+constexpr unsigned KERNEL_GROUP{1};
+
+constexpr std::string_view EVENT_PREFIX{"input/event"};
+
+std::optional<evlist::UeventAction> parse_action(std::string_view action) {
+    if (action == "add") {
+        return evlist::UeventAction::ADD;
+    }
+    if (action == "remove") {
+        return evlist::UeventAction::REMOVE;
+    }
+    if (action == "change") {
+        return evlist::UeventAction::CHANGE;
+    }
+    return {};
+}
+
+/**
+ * Split the next null terminated field from the front of a message.
+ */
+std::string_view next_field(std::span<const char>& message) {
+    const auto* end = static_cast<const char*>(
+        std::memchr(message.data(), '\0', message.size())
+    );
+    auto length = end == nullptr
+                      ? message.size()
+                      : static_cast<std::size_t>(end - message.data());
+    std::string_view field{message.data(), length};
+    message = message.subspan(std::min(length + 1, message.size()));
+    return field;
+}
+
+} // namespace
+
+std::optional<evlist::Uevent> evlist::Uevent::parse(
+    std::span<const char> message
+) {
+    // Messages rebroadcast by udev start with `libudev` rather than a header.
+    auto header = next_field(message);
+    auto at = header.find('@');
+    if (at == std::string_view::npos) {
+        return {};
+    }
+
+    auto action = parse_action(header.substr(0, at));
+    if (!action.has_value()) {
+        return {};
+    }
+
+    Uevent uevent{*action, header.substr(at + 1), {}, {}};
+    while (!message.empty()) {
+        auto field = next_field(message);
+        auto equals = field.find('=');
+        if (equals == std::string_view::npos) {
+            continue;
+        }
+
+        auto key = field.substr(0, equals);
+        auto value = field.substr(equals + 1);
+        if (key == "SUBSYSTEM") {
+            uevent.subsystem = value;
+        } else if (key == "DEVNAME") {
+            uevent.devname = value;
+        } else if (key == "DEVPATH") {
+            uevent.devpath = value;
+        }
+    }
+
+    return uevent;
+}
+
+std::optional<std::string_view> evlist::Uevent::event_device() const {
+    if (subsystem != "input" || !devname.starts_with(EVENT_PREFIX)) {
+        return {};
+    }
+    return devname.substr(devname.rfind('/') + 1);
+}
+
+evlist::NetlinkUeventSource::NetlinkUeventSource(FileDescriptor socket)
+    : socket_{std::move(socket)} {}
+
+std::expected<evlist::NetlinkUeventSource, std::system_error>
+evlist::NetlinkUeventSource::open() {
+    FileDescriptor socket{::socket(
+        AF_NETLINK,
+        SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC,
+        NETLINK_KOBJECT_UEVENT
+    )};
+    if (!socket.valid()) {
+        return std::unexpected{
+            std::system_error{errno, std::generic_category(), "socket"}
+        };
+    }
+
+    sockaddr_nl address{};
+    address.nl_family = AF_NETLINK;
+    address.nl_groups = KERNEL_GROUP;
+    if (bind(
+            socket.get(),
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+            reinterpret_cast<const sockaddr*>(&address),
+            sizeof(address)
+        ) != 0) {
+        return std::unexpected{
+            std::system_error{errno, std::generic_category(), "bind"}
+        };
+    }
+
+    return NetlinkUeventSource{std::move(socket)};
+}
+
+std::expected<std::size_t, std::system_error>
+evlist::NetlinkUeventSource::receive(
+    std::span<char> buffer, std::chrono::milliseconds timeout
+) {
+    pollfd ready{socket_.get(), POLLIN, 0};
+    auto polled = ::poll(&ready, 1, static_cast<int>(timeout.count()));
+    if (polled < 0) {
+        if (errno == EINTR) {
+            return 0;
+        }
+        return std::unexpected{
+            std::system_error{errno, std::generic_category(), "poll"}
+        };
+    }
+
+    // Only the kernel may send uevents, so messages from other processes
+    // are dropped rather than trusted.
+    while (true) {
+        sockaddr_nl sender{};
+        socklen_t sender_size = sizeof(sender);
+        // With `MSG_TRUNC`, the full size of a message is returned even if
+        // it did not fit in the buffer.
+        auto size = recvfrom(
+            socket_.get(),
+            buffer.data(),
+            buffer.size(),
+            MSG_TRUNC,
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+            reinterpret_cast<sockaddr*>(&sender),
+            &sender_size
+        );
+        if (size < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+                return 0;
+            }
+            // The socket buffer overflowed and uevents were dropped, but the
+            // socket can still be used once the caller has resynchronised.
+            if (errno == ENOBUFS) {
+                return std::unexpected{std::system_error{
+                    std::make_error_code(std::errc::no_buffer_space),
+                    "uevents were dropped"
+                }};
+            }
+            return std::unexpected{
+                std::system_error{errno, std::generic_category(), "recvfrom"}
+            };
+        }
+        // The fields of a truncated message are incomplete, so it is dropped.
+        if (static_cast<std::size_t>(size) > buffer.size()) {
+            continue;
+        }
+        if (sender.nl_pid == 0) {
+            return static_cast<std::size_t>(size);
+        }
+    }
+}
+
+evlist::HotplugListener::HotplugListener(
+    std::unique_ptr<UeventSource> source, InputDeviceLister lister
+)
+    : source_{std::move(source)}, lister_{std::move(lister)} {}
+
+std::expected<std::optional<evlist::HotplugEvent>, std::system_error>
+evlist::HotplugListener::handle(std::span<const char> message) const {
+    auto uevent = Uevent::parse(message);
+    if (!uevent.has_value()) {
+        return std::nullopt;
+    }
+    auto name = uevent->event_device();
+    if (!name.has_value()) {
+        return std::nullopt;
+    }
+
+    HotplugEvent event{uevent->action, *name, {}};
+    if (event.action == UeventAction::REMOVE) {
+        return event;
+    }
+
+    auto device = lister_.list_input_device(*name);
+    if (!device.has_value()) {
+        return std::unexpected{
+            std::system_error{device.error().code(), device.error().what()}
+        };
+    }
+    event.device = std::move(*device);
+    return event;
+}
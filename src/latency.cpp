@@ -0,0 +1,130 @@
+#include "evlist/latency.h"
+
+#include <linux/input.h>
+#include <sys/ioctl.h>
+#include <time.h>
+
+#include <algorithm>
+#include <bit>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <span>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include "evlist/cli.h"
+#include "evlist/device.h"
+
+void evlist::LatencyHistogram::record(uint64_t value) noexcept {
+    counts_[bucket(value)]++;
+    count_++;
+    max_ = std::max(max_, value);
+}
+
+void evlist::LatencyHistogram::reset() noexcept {
+    counts_.fill(0);
+    count_ = 0;
+    max_ = 0;
+}
+
+uint64_t evlist::LatencyHistogram::count() const { return count_; }
+
+uint64_t evlist::LatencyHistogram::max() const { return max_; }
+
+uint64_t evlist::LatencyHistogram::percentile(double percentile) const {
+    if (count_ == 0) {
+        return 0;
+    }
+
+    constexpr double HUNDRED{100};
+    auto target = static_cast<uint64_t>(
+        std::ceil(std::clamp(percentile, 0.0, HUNDRED) / HUNDRED *
+                  static_cast<double>(count_))
+    );
+    target = std::max<uint64_t>(target, 1);
+
+    uint64_t seen = 0;
+    for (std::size_t i = 0; i < counts_.size(); i++) {
+        seen += counts_[i];
+        if (seen >= target) {
+            return std::min(highest(i), max_);
+        }
+    }
+    return max_;
+}
+
+std::size_t evlist::LatencyHistogram::bucket(uint64_t value) noexcept {
+    // Keep the top `SUB_BUCKET_BITS + 1` bits of the value, so each power of
+    // two above the linear range is split into `SUB_BUCKETS` buckets.
+    auto width = static_cast<std::size_t>(std::bit_width(value));
+    auto shift = std::max(width, SUB_BUCKET_BITS + 1) - (SUB_BUCKET_BITS + 1);
+    return (SUB_BUCKETS * shift) + static_cast<std::size_t>(value >> shift);
+}
+
+uint64_t evlist::LatencyHistogram::highest(std::size_t bucket) noexcept {
+    if (bucket < 2 * SUB_BUCKETS) {
+        return bucket;
+    }
+
+    auto shift = (bucket / SUB_BUCKETS) - 1;
+    auto lowest = static_cast<uint64_t>((bucket % SUB_BUCKETS) + SUB_BUCKETS)
+                  << shift;
+    return lowest + ((uint64_t{1} << shift) - 1);
+}
+
+std::expected<void, std::system_error> evlist::set_monotonic_clock(
+    int descriptor
+) {
+    int clock = CLOCK_MONOTONIC;
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg,hicpp-vararg)
+    if (ioctl(descriptor, EVIOCSCLOCKID, &clock) != 0) {
+        return std::unexpected{
+            std::system_error{errno, std::generic_category(), "EVIOCSCLOCKID"}
+        };
+    }
+    return {};
+}
+
+evlist::DeviceLatencies::DeviceLatencies(
+    Format output_format, std::vector<InputDevice> devices
+)
+    : output_format_{output_format},
+      devices_{std::move(devices)},
+      histograms_(devices_.size()) {}
+
+void evlist::DeviceLatencies::record(
+    std::size_t device,
+    std::span<const input_event> events,
+    std::chrono::microseconds read_time
+) noexcept {
+    constexpr int64_t MICROSECONDS{1'000'000};
+
+    auto& histogram = histograms_[device];
+    for (const auto& event : events) {
+        auto timestamp =
+            (static_cast<int64_t>(event.input_event_sec) * MICROSECONDS) +
+            static_cast<int64_t>(event.input_event_usec);
+        auto latency = read_time.count() - timestamp;
+        histogram.record(latency > 0 ? static_cast<uint64_t>(latency) : 0);
+    }
+}
+
+const std::vector<evlist::InputDevice>& evlist::DeviceLatencies::devices(
+) const {
+    return devices_;
+}
+
+const evlist::LatencyHistogram& evlist::DeviceLatencies::histogram(
+    std::size_t device
+) const {
+    return histograms_.at(device);
+}
+
+evlist::Format evlist::DeviceLatencies::output_format() const {
+    return output_format_;
+}
@@ -1,36 +1,145 @@
 #include "evlist/list.h"
 
+#include <fcntl.h>
 #include <linux/input-event-codes.h>
 #include <linux/input.h>
 #include <sys/ioctl.h>
 
 #include <algorithm>
 #include <array>
+#include <chrono>
 #include <climits>
+#include <condition_variable>
+#include <cstddef>
 #include <cstdint>
-#include <cstdio>
+#include <deque>
 #include <expected>
 #include <filesystem>
 #include <fstream>
 #include <functional>
+#include <future>
 #include <iterator>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <ranges>
+#include <span>
+#include <stop_token>
 #include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
 #include <utility>
 #include <vector>
 
 #include "evlist/cli.h"
+#include "evlist/codes.h"
 #include "evlist/device.h"
+#include "evlist/events.h"
+#include "evlist/expression.h"
+#include "evlist/plan.h"
 
-#define STRINGIFY(x) #x
+namespace {
+
+/**
+ * The threads which probe devices, shared by every lister so that the
+ * number of threads is bounded no matter how often devices are listed.
+ * Workers exit after being idle for a while. Probes which are still queued
+ * after their deadline are dropped, since their device has already been
+ * listed as timed out.
+ */
+class ProbePool {
+public:
+    static ProbePool& instance() {
+        // The pool is never destroyed, since workers may still be blocked
+        // in a probe when the process exits.
+        // NOLINTNEXTLINE(cppcoreguidelines-owning-memory)
+        static auto* pool = new ProbePool{};
+        return *pool;
+    }
+
+    /**
+     * Queue a probe, starting a worker for it if none are idle.
+     *
+     * @param until when the probe is no longer needed
+     * @param task the probe
+     * @return whether the probe was queued, or false if no worker could be
+     *         started to run it
+     */
+    bool submit(
+        std::chrono::steady_clock::time_point until,
+        std::move_only_function<void()> task
+    ) {
+        const std::lock_guard lock{mutex_};
+        tasks_.emplace_back(Task{until, std::move(task)});
+        if (idle_ < tasks_.size() &&
+            workers_ < evlist::InputDeviceLister::MAX_PROBE_THREADS) {
+            try {
+                std::thread{[this] { work(); }}.detach();
+                workers_++;
+            } catch (const std::system_error&) {
+                // Queued probes still run if there are other workers.
+                if (workers_ == 0) {
+                    tasks_.pop_back();
+                    return false;
+                }
+            }
+        }
+
+        ready_.notify_one();
+        return true;
+    }
+
+private:
+    static constexpr std::chrono::seconds IDLE_TIMEOUT{10};
+
+    struct Task {
+        std::chrono::steady_clock::time_point until;
+        std::move_only_function<void()> run;
+    };
+
+    std::mutex mutex_;
+    std::condition_variable ready_;
+    std::deque<Task> tasks_;
+    std::size_t workers_{0};
+    std::size_t idle_{0};
+
+    ProbePool() = default;
+
+    void work() {
+        std::unique_lock lock{mutex_};
+        while (true) {
+            idle_++;
+            auto woken = ready_.wait_for(lock, IDLE_TIMEOUT, [this] {
+                return !tasks_.empty();
+            });
+            idle_--;
+            if (!woken) {
+                workers_--;
+                return;
+            }
+
+            auto task = std::move(tasks_.front());
+            tasks_.pop_front();
+            if (std::chrono::steady_clock::now() > task.until) {
+                continue;
+            }
+
+            lock.unlock();
+            task.run();
+            task.run = nullptr;
+            lock.lock();
+        }
+    }
+};
+
+} // namespace
 
 evlist::InputDeviceLister::InputDeviceLister(
     Format output_format,
     bool use_regex,
-    std::vector<std::pair<Filter, std::string>> filter
+    std::vector<FilterTerm> filter
 )
     : output_format_{output_format},
       use_regex_{use_regex},
@@ -38,43 +147,231 @@ evlist::InputDeviceLister::InputDeviceLister(
 
 std::expected<evlist::InputDevices, std::filesystem::filesystem_error>
 evlist::InputDeviceLister::list_input_devices() const {
-    std::vector<InputDevice> devices{};
-    auto inputDevices = InputDevices{output_format_, devices};
-
     if (!fs::is_directory(input_directory_)) {
-        return inputDevices;
+        return InputDevices{output_format_, {}};
     }
 
+    auto start = std::chrono::steady_clock::now();
+    auto deadline = deadline_.has_value()
+                        ? start + *deadline_
+                        : std::chrono::steady_clock::time_point::max();
+
+    std::vector<fs::path> paths{};
     for (const auto& entry : fs::directory_iterator(input_directory_)) {
         if (entry.is_character_file() &&
             entry.path().filename().string().contains("event")) {
-            auto by_id_symlink = check_symlink(entry, by_id_);
-            if (!by_id_symlink.has_value()) {
-                return std::unexpected{by_id_symlink.error()};
-            }
-            auto by_path_symlink = check_symlink(entry, by_path_);
-            if (!by_path_symlink.has_value()) {
-                return std::unexpected{by_path_symlink.error()};
+            paths.emplace_back(entry.path());
+        }
+    }
+
+    std::ranges::sort(paths, [](const auto& lhs, const auto& rhs) {
+        return natural_order(lhs, rhs) < 0;
+    });
+
+    // Probe devices in natural sort order. Without a limit, every device is
+    // probed at once. With a limit, the first batch only probes as many
+    // devices as are needed, and each later batch doubles, so finding a few
+    // devices only probes a few devices while the number of batches stays
+    // logarithmic. Matches in earlier batches are always smaller than later
+    // ones, so probing stops as soon as the limit is met.
+    auto limit = limit_.value_or(paths.size());
+    auto batch = limit_.has_value() ? std::min(limit, MAX_PROBE_THREADS)
+                                    : paths.size();
+
+    FilterPlan plan{filter_, use_regex_, use_glob_};
+    auto memos = where_memos();
+    std::map<fs::path, ParentDevice> parents{};
+    std::vector<InputDevice> devices{};
+    for (auto begin = paths.begin();
+         begin != paths.end() && devices.size() < limit;) {
+        auto end = begin + static_cast<std::ptrdiff_t>(std::min(
+                               batch,
+                               static_cast<std::size_t>(paths.end() - begin)
+                           ));
+
+        auto probed = probe_devices(
+            {begin, end},
+            deadline,
+            plan,
+            memos,
+            limit - devices.size(),
+            parents
+        );
+        if (!probed.has_value()) {
+            return std::unexpected{probed.error()};
+        }
+
+        std::ranges::move(*probed, std::back_inserter(devices));
+        begin = end;
+        batch *= 2;
+    }
+
+    return InputDevices{output_format_, std::move(devices)};
+}
+
+std::expected<
+    std::optional<evlist::InputDevice>,
+    std::filesystem::filesystem_error>
+evlist::InputDeviceLister::list_input_device(std::string_view name) const {
+    const std::array paths{fs::path{input_directory_} / name};
+    auto deadline = deadline_.has_value()
+                        ? std::chrono::steady_clock::now() + *deadline_
+                        : std::chrono::steady_clock::time_point::max();
+
+    FilterPlan plan{filter_, use_regex_, use_glob_};
+    auto memos = where_memos();
+    std::map<fs::path, ParentDevice> parents{};
+    auto probed = probe_devices(paths, deadline, plan, memos, 1, parents);
+    if (!probed.has_value()) {
+        return std::unexpected{probed.error()};
+    }
+
+    if (probed->empty()) {
+        return std::nullopt;
+    }
+    return std::move(probed->front());
+}
+
+std::expected<
+    std::vector<evlist::InputDevice>,
+    std::filesystem::filesystem_error>
+evlist::InputDeviceLister::probe_devices(
+    std::span<const fs::path> paths,
+    std::chrono::steady_clock::time_point deadline,
+    FilterPlan& plan,
+    FilterExpression::Memos& memos,
+    std::size_t limit,
+    std::map<fs::path, ParentDevice>& parents
+) const {
+    struct Pending {
+        fs::path path;
+        std::chrono::steady_clock::time_point until;
+        std::shared_ptr<ProbeProgress> progress;
+        std::future<Probe> probe;
+    };
+
+    // Start probing every device before waiting on any of them, so the
+    // listing takes at most the deadline rather than the sum of the probes.
+    std::vector<Pending> pending{};
+    for (const auto& path : paths) {
+        auto until = std::min(
+            std::chrono::steady_clock::now() + probe_deadline_, deadline
+        );
+        auto progress = std::make_shared<ProbeProgress>();
+        auto probed = probe(path, until, progress);
+        pending.emplace_back(
+            Pending{path, until, std::move(progress), std::move(probed)}
+        );
+    }
+
+    // Symlinks and sysfs attributes do not block, so read them while the
+    // probes run. A probe which could not be started has no future, and one
+    // which was dropped by the pool after its deadline has a broken promise.
+    // Probes after the limit is met are abandoned rather than waited on.
+    std::vector<InputDevice> devices{};
+    for (auto& device : pending) {
+        if (devices.size() == limit) {
+            break;
+        }
+
+        std::optional<Probe> probed{};
+        if (device.probe.valid() &&
+            device.probe.wait_until(device.until) ==
+                std::future_status::ready) {
+            try {
+                probed = device.probe.get();
+            } catch (const std::future_error&) {
             }
+        }
+        if (!probed.has_value()) {
+            probed = device.progress->timed_out();
+        }
 
-            InputDevice device = {
-                entry.path(),
-                this->name(entry.path()),
-                *by_id_symlink,
-                *by_path_symlink,
-                capabilities(entry.path())
-            };
-            devices.emplace_back(std::move(device));
+        auto listed =
+            this->device(std::move(device.path), std::move(*probed), parents);
+        if (!listed.has_value()) {
+            return std::unexpected{listed.error()};
+        }
+        if (matches(*listed, plan, memos)) {
+            devices.emplace_back(std::move(*listed));
         }
     }
 
-    std::ranges::sort(devices, std::less{});
+    return devices;
+}
+
+evlist::InputDeviceStream evlist::InputDeviceLister::stream_input_devices(
+) const {
+    auto start = std::chrono::steady_clock::now();
+    auto deadline = deadline_.has_value()
+                        ? start + *deadline_
+                        : std::chrono::steady_clock::time_point::max();
 
-    if (!filter_.empty()) {
-        inputDevices.filter(filter_, use_regex_);
+    std::vector<fs::path> paths{};
+    if (fs::is_directory(input_directory_)) {
+        for (const auto& entry : fs::directory_iterator(input_directory_)) {
+            if (entry.is_character_file() &&
+                entry.path().filename().string().contains("event")) {
+                paths.emplace_back(entry.path());
+            }
+        }
     }
+    std::ranges::sort(paths, [](const auto& lhs, const auto& rhs) {
+        return natural_order(lhs, rhs) < 0;
+    });
+
+    return InputDeviceStream{*this, std::move(paths), deadline};
+}
+
+evlist::InputDeviceLister& evlist::InputDeviceLister::with_probe_deadline(
+    std::chrono::milliseconds probe_deadline
+) {
+    probe_deadline_ = probe_deadline;
+    return *this;
+}
+
+evlist::InputDeviceLister& evlist::InputDeviceLister::with_deadline(
+    std::chrono::milliseconds deadline
+) {
+    deadline_ = deadline;
+    return *this;
+}
+
+evlist::InputDeviceLister& evlist::InputDeviceLister::with_limit(
+    std::size_t limit
+) {
+    limit_ = limit;
+    return *this;
+}
+
+evlist::InputDeviceLister& evlist::InputDeviceLister::with_glob(
+    bool use_glob
+) {
+    use_glob_ = use_glob;
+    return *this;
+}
 
-    return inputDevices;
+evlist::InputDeviceLister& evlist::InputDeviceLister::with_where(
+    FilterExpression where
+) {
+    where_ = std::move(where);
+    return *this;
+}
+
+evlist::InputDeviceLister& evlist::InputDeviceLister::with_input_directory(
+    std::string input_directory
+) {
+    input_directory_ = std::move(input_directory);
+    by_id_ = input_directory_ + "/by-id";
+    by_path_ = input_directory_ + "/by-path";
+    return *this;
+}
+
+evlist::InputDeviceLister& evlist::InputDeviceLister::with_sys_class(
+    std::string sys_class
+) {
+    sys_class_ = std::move(sys_class);
+    return *this;
 }
 
 std::
@@ -101,41 +398,155 @@ std::
 
 std::vector<std::string> evlist::InputDeviceLister::capabilities(
     const fs::path& device
-) const {
+) {
     std::array<std::uint64_t, EV_MAX> bit{};
 
-    auto deleter = [](auto* file) {
-        if (file != nullptr) {
-            // NOLINTNEXTLINE(cppcoreguidelines-owning-memory)
-            return std::fclose(file);
-        }
-        return EOF;
-    };
-    auto file = std::unique_ptr<FILE, decltype(deleter)>{
-        std::fopen(device.c_str(), "re"), deleter
+    // Open the device without blocking, in case it is not a real device node.
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg,hicpp-vararg)
+    const FileDescriptor file{
+        ::open(device.c_str(), O_RDONLY | O_NONBLOCK | O_CLOEXEC)
     };
-
-    if (file == nullptr) {
+    if (!file.valid()) {
         return {};
     }
 
     // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg,hicpp-vararg,misc-include-cleaner)
-    ioctl(fileno(file.get()), EVIOCGBIT(0, EV_MAX), bit.data());
+    ioctl(file.get(), EVIOCGBIT(0, EV_MAX), bit.data());
 
     std::vector<std::string> out{};
-    for (const auto& [first, second] : event_names_) {
-        if ((bit.at(first / ULONG_WIDTH) & 1UL << first % ULONG_WIDTH) != 0U) {
-            out.emplace_back(second);
+    for (uint16_t code = 0; code < EventCodes::count(CodeType::EV); code++) {
+        auto name = EventCodes::name(CodeType::EV, code);
+        if (name.has_value() &&
+            (bit.at(code / ULONG_WIDTH) & 1UL << code % ULONG_WIDTH) != 0U) {
+            out.emplace_back(*name);
         }
     }
 
     return out;
 }
 
-std::string evlist::InputDeviceLister::name(const fs::path& device) const {
-    const fs::path fullPath = sys_class_ / device.filename() / name_path_;
+evlist::InputDeviceLister::Probe
+evlist::InputDeviceLister::ProbeProgress::timed_out() {
+    const std::lock_guard lock{mutex};
+    return Probe{name, std::nullopt};
+}
+
+std::future<evlist::InputDeviceLister::Probe>
+evlist::InputDeviceLister::probe(
+    const fs::path& device,
+    std::chrono::steady_clock::time_point until,
+    std::shared_ptr<ProbeProgress> progress
+) const {
+    std::promise<Probe> promise{};
+    auto future = promise.get_future();
+    if (!probe(
+            device,
+            until,
+            std::move(progress),
+            [promise = std::move(promise)](Probe probed) mutable {
+                promise.set_value(std::move(probed));
+            }
+        )) {
+        return {};
+    }
+
+    return future;
+}
+
+bool evlist::InputDeviceLister::probe(
+    const fs::path& device,
+    std::chrono::steady_clock::time_point until,
+    std::shared_ptr<ProbeProgress> progress,
+    std::move_only_function<void(Probe)> on_probe
+) const {
+    // The probe may outlive the caller if it never finishes, so it only
+    // owns copies of its inputs.
+    return ProbePool::instance().submit(
+        until,
+        [on_probe = std::move(on_probe),
+         progress = std::move(progress),
+         device,
+         name_path = sys_class_ / device.filename() / name_path_]() mutable {
+            auto probed = name(name_path);
+            {
+                const std::lock_guard lock{progress->mutex};
+                progress->name = probed;
+            }
+            on_probe(Probe{std::move(probed), capabilities(device)});
+        }
+    );
+}
+
+std::expected<evlist::InputDevice, std::filesystem::filesystem_error>
+evlist::InputDeviceLister::device(
+    fs::path path, Probe probe, std::map<fs::path, ParentDevice>& parents
+) const {
+    auto by_id = check_symlink(path, by_id_);
+    if (!by_id.has_value()) {
+        return std::unexpected{by_id.error()};
+    }
+    auto by_path = check_symlink(path, by_path_);
+    if (!by_path.has_value()) {
+        return std::unexpected{by_path.error()};
+    }
+
+    auto timed_out = !probe.capabilities.has_value();
+    InputDevice device{
+        std::move(path),
+        std::move(probe.name).value_or(std::string{TIMED_OUT_NAME}),
+        std::move(*by_id),
+        std::move(*by_path),
+        std::move(probe.capabilities).value_or(std::vector<std::string>{}),
+        timed_out
+    };
+    device.with_parent(this->parent(device.device_path(), parents));
+    return device;
+}
+
+bool evlist::InputDeviceLister::matches(
+    const InputDevice& device,
+    FilterPlan& plan,
+    FilterExpression::Memos& memos
+) const {
+    return plan.matches(device) &&
+           (!where_.has_value() || where_->matches(device, memos));
+}
+
+evlist::FilterExpression::Memos evlist::InputDeviceLister::where_memos() const {
+    return where_.has_value() ? where_->memos() : FilterExpression::Memos{};
+}
+
+evlist::ParentDevice evlist::InputDeviceLister::parent(
+    const fs::path& device, std::map<fs::path, ParentDevice>& parents
+) const {
+    // Parents are keyed by their resolved sysfs path, since each event device
+    // links to its parent through a different `device` symlink.
+    std::error_code error{};
+    auto path =
+        fs::canonical(sys_class_ / device.filename() / "device", error);
+    if (error) {
+        return {};
+    }
+
+    auto cached = parents.find(path);
+    if (cached != parents.end()) {
+        return cached->second;
+    }
+
+    ParentDevice parent{
+        path.filename().string(),
+        name(path / "id/vendor"),
+        name(path / "id/product"),
+        name(path / "id/bustype"),
+        name(path / "phys"),
+        name(path / "uniq")
+    };
+    parents.emplace(std::move(path), parent);
+    return parent;
+}
 
-    std::ifstream file{fullPath};
+std::string evlist::InputDeviceLister::name(const fs::path& name_path) {
+    std::ifstream file{name_path};
     std::string name{
         (std::istreambuf_iterator(file)), std::istreambuf_iterator<char>()
     };
@@ -146,20 +557,125 @@ std::string evlist::InputDeviceLister::name(const fs::path& device) const {
     return name;
 }
 
-std::map<uint32_t, std::string> evlist::InputDeviceLister::event_names() {
-    return {
-        {EV_SYN, STRINGIFY(EV_SYN)},
-        {EV_KEY, STRINGIFY(EV_KEY)},
-        {EV_REL, STRINGIFY(EV_REL)},
-        {EV_ABS, STRINGIFY(EV_ABS)},
-        {EV_MSC, STRINGIFY(EV_MSC)},
-        {EV_SW, STRINGIFY(EV_SW)},
-        {EV_LED, STRINGIFY(EV_LED)},
-        {EV_SND, STRINGIFY(EV_SND)},
-        {EV_REP, STRINGIFY(EV_REP)},
-        {EV_FF, STRINGIFY(EV_FF)},
-        {EV_PWR, STRINGIFY(EV_PWR)},
-        {EV_FF_STATUS, STRINGIFY(EV_FF_STATUS)},
-        {EV_MAX, STRINGIFY(EV_MAX)},
+evlist::InputDeviceStream::InputDeviceStream(
+    InputDeviceLister lister,
+    std::vector<fs::path> paths,
+    std::chrono::steady_clock::time_point deadline
+)
+    : lister_{std::move(lister)},
+      paths_{std::move(paths)},
+      limit_{lister_.limit_.value_or(paths_.size())},
+      probed_{std::make_shared<MpscQueue<Probed>>(paths_.size())},
+      progress_(paths_.size()),
+      filtered_{paths_.size()},
+      reorder_{paths_.size()},
+      filter_{[this, deadline](const std::stop_token& stop) {
+          filter(stop, deadline);
+      }} {}
+
+std::expected<
+    std::optional<evlist::InputDevice>,
+    std::filesystem::filesystem_error>
+evlist::InputDeviceStream::next() {
+    while (listed_ < limit_) {
+        while (auto device = reorder_.pop()) {
+            if (device->has_value()) {
+                listed_++;
+                return std::move(*device);
+            }
+        }
+        if (reorder_.next() == paths_.size()) {
+            break;
+        }
+
+        // A device which failed is skipped so the stream can continue.
+        auto filtered = filtered_.pop();
+        if (!filtered.device.has_value()) {
+            reorder_.insert(filtered.position, std::nullopt);
+            return std::unexpected{filtered.device.error()};
+        }
+        reorder_.insert(filtered.position, std::move(*filtered.device));
+    }
+
+    return std::nullopt;
+}
+
+void evlist::InputDeviceStream::filter(
+    const std::stop_token& stop, std::chrono::steady_clock::time_point deadline
+) {
+    // Wake the stage if it is waiting for probes when the stream is destroyed.
+    const std::stop_callback wake{stop, [this] { probed_->wake(); }};
+
+    FilterPlan plan{lister_.filter_, lister_.use_regex_, lister_.use_glob_};
+    auto memos = lister_.where_memos();
+    std::map<fs::path, ParentDevice> parents{};
+    auto pass = [this, &plan, &memos, &parents](
+                    std::size_t position, InputDeviceLister::Probe probe
+                ) {
+        auto device =
+            lister_.device(paths_[position], std::move(probe), parents);
+        if (!device.has_value()) {
+            filtered_.push(Filtered{position, std::unexpected{device.error()}});
+        } else if (!lister_.matches(*device, plan, memos)) {
+            filtered_.push(Filtered{position, std::nullopt});
+        } else {
+            filtered_.push(Filtered{position, std::move(*device)});
+        }
     };
+
+    // Probes are started by this stage rather than the constructor, and
+    // devices which finish while later probes are starting are passed on
+    // straight away, so the first device does not wait for every probe to
+    // start.
+    std::vector<bool> probed(paths_.size());
+    auto remaining = paths_.size();
+    auto receive = [this, &pass, &probed, &remaining](
+                       std::chrono::steady_clock::time_point until
+                   ) {
+        auto next = probed_->pop_until(until);
+        if (next.has_value()) {
+            probed[next->position] = true;
+            remaining--;
+            pass(next->position, std::move(next->probe));
+        }
+        return next.has_value();
+    };
+
+    // Every probe starts at about the same time, so they share a deadline.
+    auto until = std::min(
+        std::chrono::steady_clock::now() + lister_.probe_deadline_, deadline
+    );
+    for (std::size_t position = 0;
+         position < paths_.size() && !stop.stop_requested();
+         position++) {
+        progress_[position] =
+            std::make_shared<InputDeviceLister::ProbeProgress>();
+        if (!lister_.probe(
+                paths_[position],
+                until,
+                progress_[position],
+                [queue = probed_, position](InputDeviceLister::Probe probe) {
+                    queue->push(Probed{position, std::move(probe)});
+                }
+            )) {
+            // A probe which could not be started times out straight away.
+            probed[position] = true;
+            remaining--;
+            pass(position, progress_[position]->timed_out());
+        }
+        while (receive(std::chrono::steady_clock::now())) {
+        }
+    }
+
+    while (remaining > 0 && !stop.stop_requested()) {
+        if (!receive(until) && std::chrono::steady_clock::now() >= until) {
+            for (std::size_t position = 0; position < paths_.size();
+                 position++) {
+                if (!probed[position]) {
+                    pass(position, progress_[position]->timed_out());
+                }
+            }
+            return;
+        }
+    }
 }
@@ -1,11 +1,523 @@
+#include <unistd.h>
 
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <csignal>
+#include <cstddef>
+#include <cstdio>
+#include <filesystem>
 #include <format>
+#include <fstream>
 #include <iostream>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <set>
+#include <stop_token>
+#include <string>
+#include <thread>
 #include <utility>
 
 // NOLINTNEXTLINE(misc-include-cleaner)
 #include "evlist/evlist.h"
 
+namespace {
+
+int diff_against(
+    const evlist::Cli& cli,
+    const std::string& path,
+    const evlist::InputDevices& devices
+) {
+    std::ifstream file{path};
+    const std::string csv{
+        (std::istreambuf_iterator(file)), std::istreambuf_iterator<char>()
+    };
+
+    auto previous = evlist::InputDevices::from_csv(csv, cli.format());
+    if (!previous.has_value()) {
+        std::cout << std::format(
+            "failed to read previous devices: {}", previous.error()
+        );
+        return 1;
+    }
+    if (!cli.filter().empty()) {
+        previous->filter(cli.filter(), cli.use_regex(), cli.use_glob());
+    }
+
+    std::cout << std::format("{}", previous->diff(devices));
+    return 0;
+}
+
+int top(const evlist::Cli& cli, const evlist::InputDevices& devices) {
+    auto poller = evlist::EventPoller::open(devices.devices());
+    if (!poller.has_value()) {
+        const auto& err = poller.error();
+        std::cout << std::format("failed to open devices: {}", err.what());
+        return err.code().value();
+    }
+
+    // Refresh the screen like `top` when writing a table to a terminal.
+    auto refresh = cli.format() == evlist::Format::TABLE &&
+                   isatty(fileno(stdout)) != 0;
+
+    evlist::EventRates rates{cli.format(), devices.devices()};
+    auto start = std::chrono::steady_clock::now();
+    while (!poller->closed()) {
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        // A negative timeout would wait indefinitely for events, so a late
+        // interval is output straight away.
+        auto remaining = std::max(
+            std::chrono::ceil<std::chrono::milliseconds>(
+                cli.interval() - elapsed
+            ),
+            std::chrono::milliseconds{0}
+        );
+
+        auto polled =
+            poller->poll(remaining, [&rates](auto device, auto events) {
+                rates.record(device, events);
+            });
+        if (!polled.has_value()) {
+            const auto& err = polled.error();
+            std::cout << std::format("failed to read events: {}", err.what());
+            return err.code().value();
+        }
+
+        auto now = std::chrono::steady_clock::now();
+        if (now - start >= cli.interval()) {
+            rates.finish_interval(now - start);
+            start = now;
+
+            if (refresh) {
+                std::cout << "\x1b[H\x1b[2J";
+            }
+            std::cout << std::format("{}\n", rates) << std::flush;
+        }
+    }
+
+    return 0;
+}
+
+volatile std::sig_atomic_t interrupted = 0;
+
+void interrupt(int /*signal*/) { interrupted = 1; }
+
+void handle_interrupts() {
+    // Installing the handlers without `SA_RESTART` interrupts `epoll_wait`.
+    struct sigaction action{};
+    action.sa_handler = interrupt;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGINT, &action, nullptr);
+    sigaction(SIGTERM, &action, nullptr);
+}
+
+int record(
+    const evlist::Cli& cli,
+    const std::string& path,
+    const evlist::InputDevices& devices
+) {
+    auto poller = evlist::EventPoller::open(devices.devices());
+    if (!poller.has_value()) {
+        const auto& err = poller.error();
+        std::cout << std::format("failed to open devices: {}", err.what());
+        return err.code().value();
+    }
+
+    auto recorder =
+        evlist::EventRecorder::create(path, devices.devices(), cli.capacity());
+    if (!recorder.has_value()) {
+        const auto& err = recorder.error();
+        std::cout << std::format("failed to create recording: {}", err.what());
+        return err.code().value();
+    }
+
+    // Stop recording cleanly so that the recording is flushed.
+    handle_interrupts();
+
+    while (interrupted == 0 && !poller->closed()) {
+        auto polled = poller->poll(
+            std::chrono::milliseconds{-1},
+            [&recorder](auto device, auto events) {
+                recorder->append(device, events);
+            }
+        );
+        if (!polled.has_value()) {
+            const auto& err = polled.error();
+            std::cout << std::format("failed to read events: {}", err.what());
+            return err.code().value();
+        }
+    }
+
+    if (auto synced = recorder->sync(); !synced.has_value()) {
+        const auto& err = synced.error();
+        std::cout << std::format("failed to write recording: {}", err.what());
+        return err.code().value();
+    }
+
+    auto written = recorder->written();
+    auto overwritten = written > cli.capacity() ? written - cli.capacity() : 0;
+    std::cerr << std::format(
+        "recorded {} events from {} devices to {} ({} overwritten)\n",
+        written,
+        devices.devices().size(),
+        path,
+        overwritten
+    );
+    return 0;
+}
+
+int latency(const evlist::Cli& cli, const evlist::InputDevices& devices) {
+    auto poller = evlist::EventPoller::open(devices.devices());
+    if (!poller.has_value()) {
+        const auto& err = poller.error();
+        std::cout << std::format("failed to open devices: {}", err.what());
+        return err.code().value();
+    }
+    for (std::size_t device = 0; device < poller->size(); device++) {
+        auto clock = evlist::set_monotonic_clock(poller->descriptor(device));
+        if (!clock.has_value()) {
+            const auto& err = clock.error();
+            std::cout << std::format("failed to set clock: {}", err.what());
+            return err.code().value();
+        }
+    }
+
+    // Output the final latencies when interrupted.
+    handle_interrupts();
+
+    evlist::DeviceLatencies latencies{cli.format(), devices.devices()};
+    auto start = std::chrono::steady_clock::now();
+    while (interrupted == 0 && !poller->closed()) {
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        auto remaining = std::max(
+            std::chrono::ceil<std::chrono::milliseconds>(
+                cli.interval() - elapsed
+            ),
+            std::chrono::milliseconds{0}
+        );
+
+        // `steady_clock` uses `CLOCK_MONOTONIC`, which matches the clock set
+        // on the devices.
+        auto polled =
+            poller->poll(remaining, [&latencies](auto device, auto events) {
+                using std::chrono::microseconds;
+                auto now = std::chrono::steady_clock::now().time_since_epoch();
+                latencies.record(
+                    device, events, std::chrono::duration_cast<microseconds>(now)
+                );
+            });
+        if (!polled.has_value()) {
+            const auto& err = polled.error();
+            std::cout << std::format("failed to read events: {}", err.what());
+            return err.code().value();
+        }
+
+        auto now = std::chrono::steady_clock::now();
+        if (now - start >= cli.interval()) {
+            start = now;
+            std::cout << std::format("{}\n", latencies) << std::flush;
+        }
+    }
+
+    std::cout << std::format("{}", latencies);
+    return 0;
+}
+
+int archive(const evlist::Cli& cli) {
+    auto recording = evlist::EventRecording::open(cli.recording());
+    if (!recording.has_value()) {
+        const auto& err = recording.error();
+        std::cout << std::format("failed to read recording: {}", err.what());
+        return err.code().value();
+    }
+
+    auto written = evlist::EventArchive::write(
+        cli.archive(), recording->devices(), recording->records()
+    );
+    if (!written.has_value()) {
+        const auto& err = written.error();
+        std::cout << std::format("failed to write archive: {}", err.what());
+        return err.code().value();
+    }
+
+    return 0;
+}
+
+int query(const evlist::Cli& cli) {
+    auto archive = evlist::EventArchive::open(cli.archive());
+    if (!archive.has_value()) {
+        const auto& err = archive.error();
+        std::cout << std::format("failed to read archive: {}", err.what());
+        return err.code().value();
+    }
+
+    auto query = evlist::ArchiveQuery::parse(cli.query(), archive->devices());
+    if (!query.has_value()) {
+        std::cout << std::format("invalid query: {}", query.error());
+        return 1;
+    }
+
+    if (cli.summary()) {
+        std::cout << std::format(
+            "{}", evlist::ArchiveSummary{cli.format(), *archive, *query}
+        );
+    } else {
+        std::cout << std::format(
+            "{}",
+            evlist::ArchiveEvents{
+                cli.format(), archive->devices(), archive->query(*query)
+            }
+        );
+    }
+
+    return 0;
+}
+
+template <typename Writer, std::size_t N>
+int stream_rows(
+    evlist::InputDeviceStream& devices,
+    const std::array<evlist::Filter, N>& columns
+) {
+    evlist::DeviceRowWriter<Writer, N> writer{columns};
+    auto out = writer.begin(std::ostreambuf_iterator{std::cout});
+    std::optional<std::filesystem::filesystem_error> error{};
+    while (true) {
+        auto device = devices.next();
+        if (!device.has_value()) {
+            error = std::move(device.error());
+            break;
+        }
+        if (!device->has_value()) {
+            break;
+        }
+        out = writer.row(std::move(out), **device);
+    }
+
+    // The rows written so far are always ended, such as closing a JSON array.
+    writer.end(std::move(out));
+    if (error.has_value()) {
+        std::cout << std::format("failed to list devices: {}", error->what());
+        return error->code().value();
+    }
+    return 0;
+}
+
+int stream(const evlist::Cli& cli, const evlist::InputDeviceLister& lister) {
+    auto devices = lister.stream_input_devices();
+    return evlist::with_row_writer(cli.format(), [&]<typename Writer>(Writer) {
+        if (cli.parent()) {
+            return stream_rows<Writer>(
+                devices, evlist::InputDevices::ALL_COLUMNS
+            );
+        }
+        return stream_rows<Writer>(devices, evlist::InputDevices::COLUMNS);
+    });
+}
+
+int group(
+    const evlist::Cli& cli,
+    const evlist::InputDeviceLister& lister,
+    evlist::Filter column
+) {
+    evlist::DeviceGroups groups{cli.format(), column};
+
+    // A stream probes every device, so with a limit, devices are listed
+    // instead, which stops probing once enough devices match.
+    if (cli.limit().has_value()) {
+        auto devices = lister.list_input_devices();
+        if (!devices.has_value()) {
+            const auto& err = devices.error();
+            std::cout << std::format("failed to list devices: {}", err.what());
+            return err.code().value();
+        }
+        for (const auto& device : devices->devices()) {
+            groups.add(device);
+        }
+        std::cout << std::format("{}", groups);
+        return 0;
+    }
+
+    // Devices are counted as they are streamed, without keeping them.
+    auto devices = lister.stream_input_devices();
+    while (true) {
+        auto device = devices.next();
+        if (!device.has_value()) {
+            const auto& err = device.error();
+            std::cout << std::format("failed to list devices: {}", err.what());
+            return err.code().value();
+        }
+        if (!device->has_value()) {
+            break;
+        }
+        groups.add(**device);
+    }
+
+    std::cout << std::format("{}", groups);
+    return 0;
+}
+
+/**
+ * Update the snapshot whenever input devices are added, removed or changed,
+ * until stopped. Only the affected devices are probed, unless events were
+ * missed, in which case every device is listed again.
+ */
+void refresh_on_hotplug(
+    const std::stop_token& stop,
+    evlist::NetlinkUeventSource source,
+    const evlist::InputDeviceLister& lister,
+    evlist::InputDevicesSnapshot& snapshot
+) {
+    using namespace std::chrono_literals;
+
+    // Probe added and changed devices again once udev has had time to create
+    // their `by-id` and `by-path` symlinks.
+    constexpr auto SETTLE = 1s;
+
+    auto refresh = [&lister, &snapshot] {
+        if (auto refreshed = snapshot.refresh(lister); !refreshed.has_value()) {
+            std::cout << std::format(
+                "failed to list devices: {}\n", refreshed.error().what()
+            );
+        }
+    };
+
+    evlist::HotplugListener listener{
+        std::make_unique<evlist::NetlinkUeventSource>(std::move(source)), lister
+    };
+    std::optional<std::chrono::steady_clock::time_point> settle{};
+    std::set<std::string> settling{};
+    auto relist = false;
+    while (!stop.stop_requested()) {
+        auto events = listener.poll(
+            100ms,
+            [&snapshot, &settling](const evlist::HotplugEvent& event) {
+                snapshot.update(event.name, event.device);
+                if (event.action == evlist::UeventAction::REMOVE) {
+                    settling.erase(std::string{event.name});
+                } else {
+                    settling.emplace(event.name);
+                }
+            }
+        );
+
+        // Events which were dropped or could not be probed are recovered by
+        // listing every device, which is also repeated once settled.
+        auto now = std::chrono::steady_clock::now();
+        if (!events.has_value()) {
+            const auto& err = events.error();
+            if (err.code() != std::errc::no_buffer_space) {
+                std::cout << std::format(
+                    "failed to receive hotplug events: {}\n", err.what()
+                );
+            }
+            refresh();
+            relist = true;
+            settle = now + SETTLE;
+            continue;
+        }
+        if (*events != 0) {
+            settle = now + SETTLE;
+            continue;
+        }
+        if (!settle.has_value() || now < *settle) {
+            continue;
+        }
+
+        settle.reset();
+        if (std::exchange(relist, false)) {
+            refresh();
+        } else {
+            for (const auto& name : settling) {
+                auto device = lister.list_input_device(name);
+                if (!device.has_value()) {
+                    std::cout << std::format(
+                        "failed to list devices: {}\n", device.error().what()
+                    );
+                    continue;
+                }
+                snapshot.update(name, std::move(*device));
+            }
+        }
+        settling.clear();
+    }
+}
+
+int serve(const std::string& path, const evlist::InputDeviceLister& lister) {
+    evlist::InputDevicesSnapshot snapshot{};
+    if (auto refreshed = snapshot.refresh(lister); !refreshed.has_value()) {
+        const auto& err = refreshed.error();
+        std::cout << std::format("failed to list devices: {}", err.what());
+        return err.code().value();
+    }
+
+    auto server = evlist::DeviceServer::bind(path, snapshot);
+    if (!server.has_value()) {
+        const auto& err = server.error();
+        std::cout << std::format("failed to serve: {}", err.what());
+        return err.code().value();
+    }
+
+    // Without hotplug events, queries are answered from the initial devices.
+    std::jthread refresher{};
+    if (auto source = evlist::NetlinkUeventSource::open(); source.has_value()) {
+        refresher = std::jthread{
+            refresh_on_hotplug, std::move(*source), lister, std::ref(snapshot)
+        };
+    } else {
+        std::cout << std::format(
+            "failed to listen for hotplug events: {}\n", source.error().what()
+        );
+    }
+
+    // Remove the socket when interrupted. The signal may be handled on the
+    // refresh thread, so polling wakes periodically to check for it.
+    handle_interrupts();
+
+    auto exit = 0;
+    while (interrupted == 0) {
+        auto polled = server->poll(std::chrono::milliseconds{1000});
+        if (!polled.has_value()) {
+            const auto& err = polled.error();
+            std::cout << std::format("failed to serve: {}", err.what());
+            exit = err.code().value();
+            break;
+        }
+    }
+
+    std::error_code error{};
+    std::filesystem::remove(path, error);
+    return exit;
+}
+
+int connect(const evlist::Cli& cli, const std::string& path) {
+    auto client = evlist::DeviceClient::connect(path);
+    if (!client.has_value()) {
+        const auto& err = client.error();
+        std::cout << std::format("failed to connect: {}", err.what());
+        return err.code().value();
+    }
+
+    const evlist::DeviceRequest request{
+        cli.format(),
+        cli.filter(),
+        cli.use_regex(),
+        cli.use_glob(),
+        cli.parent()
+    };
+    auto devices = client->query(request);
+    if (!devices.has_value()) {
+        const auto& err = devices.error();
+        std::cout << std::format("failed to query devices: {}", err.what());
+        return err.code().value();
+    }
+
+    std::cout << *devices;
+    return 0;
+}
+
+} // namespace
+
 int main(int argc, char** argv) {
     auto cli = evlist::Cli{};
     auto exit = cli.parse(argc, argv);
@@ -16,18 +528,98 @@ int main(int argc, char** argv) {
         return 0;
     }
 
-    auto devices =
-        evlist::InputDeviceLister{
-            cli.format(), cli.use_regex(), std::move(cli).into_filter()
+    switch (cli.command()) {
+        case evlist::Command::ARCHIVE:
+            return archive(cli);
+        case evlist::Command::QUERY:
+            return query(cli);
+        case evlist::Command::LIST:
+            break;
+    }
+
+    if (const auto& path = cli.connect(); path.has_value()) {
+        return connect(cli, *path);
+    }
+
+    evlist::InputDeviceLister lister{
+        cli.format(), cli.use_regex(), cli.filter()
+    };
+    lister.with_glob(cli.use_glob());
+    if (auto deadline = cli.deadline(); deadline.has_value()) {
+        lister.with_deadline(
+            std::chrono::ceil<std::chrono::milliseconds>(*deadline)
+        );
+    }
+    if (auto limit = cli.limit(); limit.has_value()) {
+        lister.with_limit(*limit);
+    }
+    if (const auto& where = cli.where(); where.has_value()) {
+        auto expression = evlist::FilterExpression::parse(*where);
+        if (!expression.has_value()) {
+            std::cout << std::format(
+                "failed to parse expression: {}", expression.error()
+            );
+            return 1;
         }
-            .list_input_devices();
+        lister.with_where(std::move(*expression));
+    }
+
+    if (const auto& path = cli.serve(); path.has_value()) {
+        return serve(*path, lister);
+    }
+    if (auto column = cli.group_by(); column.has_value()) {
+        return group(cli, lister, *column);
+    }
+
+    // Tables need the width of every row before the first row is written, so
+    // only other formats output each device as soon as it is probed. A stream
+    // probes every device, so devices are listed instead if there is a limit.
+    if (cli.format() != evlist::Format::TABLE && !cli.limit().has_value() &&
+        !cli.diff_against().has_value() && !cli.top() &&
+        !cli.record().has_value() && !cli.latency() && cli.queries().empty()) {
+        return stream(cli, lister);
+    }
+
+    auto devices = lister.list_input_devices();
     if (!devices.has_value()) {
         const auto& err = devices.error();
         std::cout << std::format("failed to list devices: {}", err.what());
         return err.code().value();
     }
 
-    std::cout << std::format("{}", *devices);
+    if (const auto& path = cli.diff_against(); path.has_value()) {
+        return diff_against(cli, *path, *devices);
+    }
+    if (cli.top()) {
+        return top(cli, *devices);
+    }
+    if (const auto& path = cli.record(); path.has_value()) {
+        return record(cli, *path, *devices);
+    }
+    if (cli.latency()) {
+        return latency(cli, *devices);
+    }
+
+    if (!cli.queries().empty()) {
+        const evlist::DeviceQueries queries{
+            cli.queries(), cli.use_regex(), cli.use_glob()
+        };
+        std::cout << std::format("{}", queries.evaluate(*devices));
+        return 0;
+    }
+
+    // Large listings are formatted on every core.
+    devices->with_parent_columns(cli.parent());
+    auto written = evlist::write_devices(
+        STDOUT_FILENO,
+        *devices,
+        std::max(std::thread::hardware_concurrency(), 1U)
+    );
+    if (!written.has_value()) {
+        const auto& err = written.error();
+        std::cout << std::format("failed to write devices: {}", err.what());
+        return err.code().value();
+    }
 
     return 0;
 }
@@ -0,0 +1,121 @@
+#include "evlist/output.h"
+
+#include <sys/uio.h>
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <climits>
+#include <cstddef>
+#include <expected>
+#include <iterator>
+#include <span>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include "evlist/device.h"
+#include "evlist/format.h"
+
+namespace {
+
+/**
+ * Write every buffer, retrying after partial writes and writing at most
+ * `IOV_MAX` buffers per call.
+ */
+std::expected<void, std::system_error> write_all(
+    int descriptor, std::span<iovec> buffers
+) {
+    while (!buffers.empty()) {
+        auto count = std::min(buffers.size(), std::size_t{IOV_MAX});
+        auto written =
+            writev(descriptor, buffers.data(), static_cast<int>(count));
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return std::unexpected{
+                std::system_error{errno, std::generic_category(), "writev"}
+            };
+        }
+
+        auto remaining = static_cast<std::size_t>(written);
+        while (!buffers.empty() && remaining >= buffers.front().iov_len) {
+            remaining -= buffers.front().iov_len;
+            buffers = buffers.subspan(1);
+        }
+        if (remaining > 0) {
+            auto& partial = buffers.front();
+            partial.iov_base = static_cast<char*>(partial.iov_base) + remaining;
+            partial.iov_len -= remaining;
+        }
+    }
+    return {};
+}
+
+} // namespace
+
+std::expected<void, std::system_error> evlist::write_devices(
+    int descriptor, const InputDevices& devices, std::size_t threads
+) {
+    const auto& rows = devices.devices();
+    auto chunks = std::clamp(
+        rows.size() / MIN_CHUNK_ROWS,
+        std::size_t{1},
+        std::max(threads, std::size_t{1})
+    );
+    auto chunk_rows = (rows.size() + chunks - 1) / chunks;
+
+    // The first buffer holds the header and the last buffer holds the end of
+    // the output, with one buffer for each chunk of rows in between.
+    std::vector<std::string> buffers(chunks + 2);
+    with_output_columns(devices, [&](const auto& columns, const auto& widths) {
+        with_row_writer(devices.output_format(), [&]<typename Writer>(Writer) {
+            using RowWriter = DeviceRowWriter<
+                Writer,
+                std::tuple_size_v<std::remove_cvref_t<decltype(columns)>>>;
+
+            auto format_chunk = [&](std::size_t chunk) {
+                auto begin = std::min(chunk * chunk_rows, rows.size());
+                auto end = std::min(begin + chunk_rows, rows.size());
+                RowWriter writer{columns, widths, begin};
+                auto& buffer = buffers.at(chunk + 1);
+                auto out = std::back_inserter(buffer);
+                for (auto row = begin; row < end; row++) {
+                    out = writer.row(out, rows[row]);
+
+                    // Rows are similar in size, so reserve for the chunk
+                    // using the first row to avoid growing the buffer.
+                    if (row == begin) {
+                        buffer.reserve(buffer.size() * (end - begin) * 5 / 4);
+                    }
+                }
+            };
+
+            // The calling thread formats the first chunk, and the threads
+            // are joined when they go out of scope.
+            {
+                std::vector<std::jthread> workers{};
+                for (std::size_t chunk = 1; chunk < chunks; chunk++) {
+                    workers.emplace_back(format_chunk, chunk);
+                }
+                format_chunk(0);
+            }
+
+            const RowWriter writer{columns, widths};
+            writer.begin(std::back_inserter(buffers.front()));
+            writer.end(std::back_inserter(buffers.back()));
+        });
+    });
+
+    std::vector<iovec> iovecs{};
+    for (auto& buffer : buffers) {
+        if (!buffer.empty()) {
+            iovecs.emplace_back(iovec{buffer.data(), buffer.size()});
+        }
+    }
+    return write_all(descriptor, iovecs);
+}
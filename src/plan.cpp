@@ -0,0 +1,138 @@
+#include "evlist/plan.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <optional>
+#include <regex>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "evlist/cli.h"
+#include "evlist/device.h"
+#include "evlist/search.h"
+
+evlist::FilterPlan::FilterPlan(
+    const std::vector<FilterTerm>& filter,
+    bool use_regex,
+    bool use_glob
+) {
+    use_glob = use_glob && !use_regex;
+    steps_.reserve(filter.size());
+    for (std::size_t i = 0; i < filter.size(); i++) {
+        const auto& [column, value, op] = filter[i];
+        auto regex = use_regex && op == FilterOperator::EQUAL;
+
+        // A glob without wildcards is compared for equality instead.
+        auto target = value;
+        std::optional<Glob> glob{};
+        if (use_glob && op == FilterOperator::EQUAL) {
+            glob.emplace(value);
+            if (auto literal = glob->literal(); literal.has_value()) {
+                target = *literal;
+                glob.reset();
+            }
+        }
+
+        // A substring search is a single pass, similar to a glob.
+        auto estimate = cost(
+            column, regex, glob.has_value() || op == FilterOperator::CONTAINS
+        );
+        steps_.emplace_back(
+            i,
+            column,
+            std::move(target),
+            op,
+            regex ? std::optional{std::regex{value}} : std::nullopt,
+            std::move(glob),
+            estimate
+        );
+    }
+
+    replan();
+}
+
+bool evlist::FilterPlan::matches(const InputDevice& device) {
+    auto matched = true;
+    for (auto& step : steps_) {
+        step.evaluated++;
+        if (!evaluate(device, step)) {
+            step.rejected++;
+            matched = false;
+            break;
+        }
+    }
+
+    if (--until_replan_ == 0) {
+        replan();
+        until_replan_ = REPLAN_INTERVAL;
+    }
+
+    return matched;
+}
+
+std::vector<std::size_t> evlist::FilterPlan::order() const {
+    std::vector<std::size_t> out{};
+    out.reserve(steps_.size());
+    for (const auto& step : steps_) {
+        out.emplace_back(step.index);
+    }
+    return out;
+}
+
+double evlist::FilterPlan::cost(Filter column, bool regex, bool glob) {
+    // Capabilities are a list with several values per device, and a regex
+    // search is far more expensive than comparing strings. A glob is a single
+    // pass over the value.
+    constexpr double LIST_COST{8.0};
+    constexpr double REGEX_COST{20.0};
+    constexpr double GLOB_COST{2.0};
+
+    auto out = column == Filter::CAPABILITIES ? LIST_COST : 1.0;
+    if (regex) {
+        return out * REGEX_COST;
+    }
+    return glob ? out * GLOB_COST : out;
+}
+
+bool evlist::FilterPlan::evaluate(const InputDevice& device, Step& step) {
+    if (step.regex.has_value()) {
+        auto search = [&step](std::string_view value) {
+            return std::regex_search(value.begin(), value.end(), *step.regex);
+        };
+        return InputDevices::filter_device(
+            device, step.column, [&step, &search](const auto& compare) {
+                return repeats(step.column) ? step.memo(compare, search)
+                                            : search(compare);
+            }
+        );
+    }
+    if (step.glob.has_value()) {
+        return InputDevices::filter_device(
+            device, step.column, [&step](const auto& compare) {
+                return step.glob->matches(compare);
+            }
+        );
+    }
+
+    return InputDevices::filter_device(
+        device, step.column, [&step](const auto& compare) {
+            return evlist::compare(step.op, compare, step.value);
+        }
+    );
+}
+
+double evlist::FilterPlan::rank(const Step& step) {
+    // The expected cost of reaching a rejection, using a prior of one pass
+    // and one rejection so that unevaluated filters are ranked by cost.
+    auto rejection = static_cast<double>(step.rejected + 1) /
+                     static_cast<double>(step.evaluated + 2);
+    return step.cost / rejection;
+}
+
+void evlist::FilterPlan::replan() {
+    std::ranges::stable_sort(steps_, [](const auto& lhs, const auto& rhs) {
+        return rank(lhs) < rank(rhs);
+    });
+}
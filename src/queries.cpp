@@ -0,0 +1,157 @@
+#include "evlist/queries.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <optional>
+#include <regex>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "evlist/cli.h"
+#include "evlist/device.h"
+#include "evlist/glob.h"
+#include "evlist/memo.h"
+#include "evlist/search.h"
+
+evlist::DeviceQueryResults::DeviceQueryResults(
+    Format output_format,
+    std::vector<std::string> names,
+    std::vector<std::vector<const InputDevice*>> matches
+)
+    : output_format_{output_format},
+      names_{std::move(names)},
+      matches_{std::move(matches)} {}
+
+const std::vector<std::string>& evlist::DeviceQueryResults::names() const {
+    return names_;
+}
+
+const std::vector<const evlist::InputDevice*>&
+evlist::DeviceQueryResults::matches(std::size_t query) const {
+    return matches_.at(query);
+}
+
+evlist::Format evlist::DeviceQueryResults::output_format() const {
+    return output_format_;
+}
+
+evlist::DeviceQueries::DeviceQueries(
+    const std::vector<DeviceQuery>& queries, bool use_regex, bool use_glob
+) {
+    use_glob = use_glob && !use_regex;
+    for (const auto& query : queries) {
+        names_.emplace_back(query.name);
+
+        auto& predicates = queries_.emplace_back();
+        for (const auto& [column, value, op] : query.filter) {
+            auto pattern = op == FilterOperator::EQUAL;
+
+            // A glob without wildcards is compared for equality instead.
+            auto target = value;
+            std::optional<Glob> glob{};
+            if (use_glob && pattern) {
+                glob.emplace(value);
+                if (auto literal = glob->literal(); literal.has_value()) {
+                    target = *literal;
+                    glob.reset();
+                }
+            }
+
+            auto predicate = std::ranges::find_if(
+                predicates_,
+                [&column, &target, &op, &glob](const auto& predicate) {
+                    return predicate.column == column &&
+                           predicate.value == target && predicate.op == op &&
+                           predicate.glob.has_value() == glob.has_value();
+                }
+            );
+            if (predicate == predicates_.end()) {
+                predicates_.emplace_back(
+                    column,
+                    target,
+                    op,
+                    use_regex && pattern ? std::optional{std::regex{value}}
+                                         : std::nullopt,
+                    std::move(glob)
+                );
+                predicate = std::prev(predicates_.end());
+            }
+            predicates.emplace_back(predicate - predicates_.begin());
+        }
+    }
+}
+
+evlist::DeviceQueryResults evlist::DeviceQueries::evaluate(
+    const InputDevices& devices
+) const {
+    enum class Result : uint8_t { UNKNOWN, MATCH, NO_MATCH };
+
+    std::vector<std::vector<const InputDevice*>> out(queries_.size());
+    std::vector<Result> results(predicates_.size());
+    std::vector<PredicateMemo> memos(predicates_.size());
+    for (const auto& device : devices.devices()) {
+        // Predicates are evaluated lazily, so each query still short-circuits
+        // and a predicate shared by several queries is evaluated once.
+        std::ranges::fill(results, Result::UNKNOWN);
+        auto result = [this, &results, &memos, &device](std::size_t index) {
+            auto& cached = results[index];
+            if (cached == Result::UNKNOWN) {
+                auto matched =
+                    matches(device, predicates_[index], memos[index]);
+                cached = matched ? Result::MATCH : Result::NO_MATCH;
+            }
+            return cached == Result::MATCH;
+        };
+
+        for (std::size_t query = 0; query < queries_.size(); query++) {
+            if (std::ranges::all_of(queries_[query], result)) {
+                out[query].emplace_back(&device);
+            }
+        }
+    }
+
+    return DeviceQueryResults{
+        devices.output_format(), names_, std::move(out)
+    };
+}
+
+std::size_t evlist::DeviceQueries::predicates() const {
+    return predicates_.size();
+}
+
+bool evlist::DeviceQueries::matches(
+    const InputDevice& device, const Predicate& predicate, PredicateMemo& memo
+) const {
+    if (predicate.regex.has_value()) {
+        auto search = [&predicate](std::string_view value) {
+            return std::regex_search(
+                value.begin(), value.end(), *predicate.regex
+            );
+        };
+        return InputDevices::filter_device(
+            device,
+            predicate.column,
+            [&predicate, &memo, &search](const auto& compare) {
+                return repeats(predicate.column) ? memo(compare, search)
+                                                 : search(compare);
+            }
+        );
+    }
+    if (predicate.glob.has_value()) {
+        return InputDevices::filter_device(
+            device, predicate.column, [&predicate](const auto& compare) {
+                return predicate.glob->matches(compare);
+            }
+        );
+    }
+
+    return InputDevices::filter_device(
+        device, predicate.column, [&predicate](const auto& compare) {
+            return evlist::compare(predicate.op, compare, predicate.value);
+        }
+    );
+}
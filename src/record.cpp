@@ -0,0 +1,293 @@
+#include "evlist/record.h"
+
+#include <fcntl.h>
+#include <linux/input.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <expected>
+#include <format>
+#include <span>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include "evlist/cli.h"
+#include "evlist/device.h"
+#include "evlist/events.h"
+
+namespace {
+
+constexpr std::size_t RECORDS_ALIGNMENT{64};
+
+std::system_error invalid_recording(const evlist::fs::path& path) {
+    return std::system_error{
+        std::make_error_code(std::errc::invalid_argument),
+        std::format("{} is not a valid recording", path.string())
+    };
+}
+
+} // namespace
+
+evlist::MemoryMap::MemoryMap(std::byte* data, std::size_t size)
+    : data_{data}, size_{size} {}
+
+std::expected<evlist::MemoryMap, std::system_error> evlist::MemoryMap::map(
+    int descriptor, std::size_t size, bool writable
+) {
+    auto protection = writable ? PROT_READ | PROT_WRITE : PROT_READ;
+    auto* data = mmap(nullptr, size, protection, MAP_SHARED, descriptor, 0);
+    if (data == MAP_FAILED) {
+        return std::unexpected{
+            std::system_error{errno, std::generic_category(), "mmap"}
+        };
+    }
+
+    return MemoryMap{static_cast<std::byte*>(data), size};
+}
+
+evlist::MemoryMap::~MemoryMap() {
+    if (data_ != nullptr) {
+        munmap(data_, size_);
+    }
+}
+
+evlist::MemoryMap::MemoryMap(MemoryMap&& other) noexcept
+    : data_{std::exchange(other.data_, nullptr)},
+      size_{std::exchange(other.size_, 0)} {}
+
+evlist::MemoryMap& evlist::MemoryMap::operator=(MemoryMap&& other) noexcept {
+    if (this != &other) {
+        if (data_ != nullptr) {
+            munmap(data_, size_);
+        }
+        data_ = std::exchange(other.data_, nullptr);
+        size_ = std::exchange(other.size_, 0);
+    }
+    return *this;
+}
+
+std::span<std::byte> evlist::MemoryMap::data() const {
+    return {data_, size_};
+}
+
+evlist::EventRecorder::EventRecorder(MemoryMap map) : map_{std::move(map)} {
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    header_ = reinterpret_cast<RecordingHeader*>(map_.data().data());
+    auto records = map_.data().subspan(header_->records_offset);
+    records_ = {
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        reinterpret_cast<EventRecord*>(records.data()),
+        header_->capacity
+    };
+}
+
+std::expected<evlist::EventRecorder, std::system_error>
+evlist::EventRecorder::create(
+    const fs::path& path,
+    const std::vector<InputDevice>& devices,
+    std::size_t capacity
+) {
+    if (capacity == 0) {
+        return std::unexpected{std::system_error{
+            std::make_error_code(std::errc::invalid_argument),
+            "recording capacity must be greater than zero"
+        }};
+    }
+
+    auto metadata = std::format("{}", InputDevices{Format::CSV, devices});
+    auto metadata_offset = sizeof(RecordingHeader);
+    auto records_offset =
+        (metadata_offset + metadata.size() + RECORDS_ALIGNMENT - 1) /
+        RECORDS_ALIGNMENT * RECORDS_ALIGNMENT;
+    auto size = records_offset + capacity * sizeof(EventRecord);
+
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg,hicpp-vararg)
+    FileDescriptor file{::open(
+        path.c_str(),
+        O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC,
+        S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH
+    )};
+    if (!file.valid()) {
+        return std::unexpected{
+            std::system_error{errno, std::generic_category(), path.string()}
+        };
+    }
+    if (ftruncate(file.get(), static_cast<off_t>(size)) != 0) {
+        return std::unexpected{
+            std::system_error{errno, std::generic_category(), "ftruncate"}
+        };
+    }
+
+    auto map = MemoryMap::map(file.get(), size, true);
+    if (!map.has_value()) {
+        return std::unexpected{map.error()};
+    }
+
+    RecordingHeader header{
+        .magic = RecordingHeader::MAGIC,
+        .version = RecordingHeader::VERSION,
+        .devices = static_cast<uint32_t>(devices.size()),
+        .metadata_offset = metadata_offset,
+        .metadata_size = metadata.size(),
+        .records_offset = records_offset,
+        .capacity = capacity,
+        .head = 0
+    };
+    auto data = map->data();
+    std::memcpy(data.data(), &header, sizeof(header));
+    std::memcpy(
+        data.subspan(metadata_offset).data(), metadata.data(), metadata.size()
+    );
+
+    return EventRecorder{std::move(*map)};
+}
+
+void evlist::EventRecorder::append(
+    std::size_t device, std::span<const input_event> events
+) noexcept {
+    // There is a single writer, so the head only needs to be published
+    // after the batch is written for concurrent readers of the file.
+    std::atomic_ref head{header_->head};
+    auto position = head.load(std::memory_order_relaxed);
+    auto index = position % records_.size();
+    for (const auto& event : events) {
+        records_[index] = EventRecord{
+            .seconds = static_cast<int64_t>(event.input_event_sec),
+            .microseconds = static_cast<int64_t>(event.input_event_usec),
+            .device = static_cast<uint32_t>(device),
+            .type = event.type,
+            .code = event.code,
+            .value = event.value,
+            .reserved = 0
+        };
+
+        if (++index == records_.size()) {
+            index = 0;
+        }
+    }
+    head.store(position + events.size(), std::memory_order_release);
+}
+
+std::expected<void, std::system_error> evlist::EventRecorder::sync() {
+    auto data = map_.data();
+    if (msync(data.data(), data.size(), MS_SYNC) != 0) {
+        return std::unexpected{
+            std::system_error{errno, std::generic_category(), "msync"}
+        };
+    }
+    return {};
+}
+
+uint64_t evlist::EventRecorder::written() const {
+    return std::atomic_ref{header_->head}.load(std::memory_order_acquire);
+}
+
+evlist::EventRecording::EventRecording(
+    MemoryMap map,
+    const RecordingHeader* header,
+    std::vector<InputDevice> devices
+)
+    : map_{std::move(map)}, header_{header}, devices_{std::move(devices)} {
+    auto records = map_.data().subspan(header_->records_offset);
+    records_ = {
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        reinterpret_cast<const EventRecord*>(records.data()),
+        header_->capacity
+    };
+}
+
+std::expected<evlist::EventRecording, std::system_error>
+evlist::EventRecording::open(const fs::path& path) {
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg,hicpp-vararg)
+    const FileDescriptor file{::open(path.c_str(), O_RDONLY | O_CLOEXEC)};
+    if (!file.valid()) {
+        return std::unexpected{
+            std::system_error{errno, std::generic_category(), path.string()}
+        };
+    }
+
+    struct stat status{};
+    if (fstat(file.get(), &status) != 0) {
+        return std::unexpected{
+            std::system_error{errno, std::generic_category(), "fstat"}
+        };
+    }
+    auto size = static_cast<std::size_t>(status.st_size);
+    if (size < sizeof(RecordingHeader)) {
+        return std::unexpected{invalid_recording(path)};
+    }
+
+    auto map = MemoryMap::map(file.get(), size, false);
+    if (!map.has_value()) {
+        return std::unexpected{map.error()};
+    }
+
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    const auto* header = reinterpret_cast<const RecordingHeader*>(
+        map->data().data()
+    );
+    if (header->magic != RecordingHeader::MAGIC ||
+        header->version != RecordingHeader::VERSION || header->capacity == 0 ||
+        header->metadata_offset + header->metadata_size > size ||
+        header->records_offset % alignof(EventRecord) != 0 ||
+        header->records_offset > size ||
+        (size - header->records_offset) / sizeof(EventRecord) <
+            header->capacity) {
+        return std::unexpected{invalid_recording(path)};
+    }
+
+    auto metadata = map->data().subspan(
+        header->metadata_offset, header->metadata_size
+    );
+    auto devices = InputDevices::from_csv(std::string_view{
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        reinterpret_cast<const char*>(metadata.data()),
+        metadata.size()
+    });
+    if (!devices.has_value() || devices->devices().size() != header->devices) {
+        return std::unexpected{invalid_recording(path)};
+    }
+
+    return EventRecording{std::move(*map), header, devices->devices()};
+}
+
+const std::vector<evlist::InputDevice>& evlist::EventRecording::devices(
+) const {
+    return devices_;
+}
+
+uint64_t evlist::EventRecording::written() const {
+    // The recording may still be written by another process, and
+    // `std::atomic_ref` cannot refer to a const object until C++26. Loading
+    // never writes to the header, so this is safe on a read-only mapping.
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
+    auto& head = const_cast<uint64_t&>(header_->head);
+    return std::atomic_ref{head}.load(std::memory_order_acquire);
+}
+
+uint64_t evlist::EventRecording::overwritten() const {
+    return written() > records_.size() ? written() - records_.size() : 0;
+}
+
+std::vector<evlist::EventRecord> evlist::EventRecording::records() const {
+    auto head = written();
+    if (head <= records_.size()) {
+        return {records_.begin(), records_.begin() + static_cast<long>(head)};
+    }
+
+    // The ring buffer has wrapped, so the oldest event is at the head.
+    auto start = records_.begin() + static_cast<long>(head % records_.size());
+    std::vector<EventRecord> out{start, records_.end()};
+    out.insert(out.end(), records_.begin(), start);
+    return out;
+}
@@ -0,0 +1,263 @@
+#include "evlist/search.h"
+
+#include <bit>
+#include <cstddef>
+#include <cstring>
+#include <string_view>
+
+#include "evlist/cli.h"
+
+// SSE2 is always available on x86-64, and AVX2 is detected at runtime.
+#if defined(__x86_64__)
+#include <immintrin.h>
+#define EVLIST_SEARCH_X86
+#endif
+
+namespace {
+
+constexpr char CASE_BIT{0x20};
+
+char fold(char character) {
+    return character >= 'A' && character <= 'Z'
+               ? static_cast<char>(character | CASE_BIT)
+               : character;
+}
+
+bool equals_ignore_case_scalar(
+    const char* lhs, const char* rhs, std::size_t size
+) {
+    for (std::size_t i = 0; i < size; i++) {
+        if (fold(lhs[i]) != fold(rhs[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+#ifdef EVLIST_SEARCH_X86
+
+// Offsets ASCII upper case characters to the bottom of the signed range, so
+// that a single signed comparison finds them.
+constexpr auto UPPER_OFFSET = static_cast<char>(128 - 'A');
+constexpr auto UPPER_LIMIT = static_cast<char>(-128 + 26);
+
+constexpr std::size_t SSE2_WIDTH{16};
+constexpr std::size_t AVX2_WIDTH{32};
+
+/**
+ * Check each block of positions in the value against the first and last
+ * characters of the substring, comparing the substring in full only at
+ * positions where both match. The last block overlaps the previous one so
+ * that no scalar remainder is needed, which requires the value to have at
+ * least one block of positions.
+ */
+bool contains_sse2(std::string_view value, std::string_view substring) {
+    constexpr std::size_t WIDTH{SSE2_WIDTH};
+
+    const auto first = _mm_set1_epi8(substring.front());
+    const auto last = _mm_set1_epi8(substring.back());
+    const auto offset = substring.length() - 1;
+    const auto* rest = substring.data() + 1;
+
+    auto found = [first, last, offset, rest, &value](std::size_t i) {
+        const auto* data = value.data() + i;
+        auto block_first =
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+        auto block_last =
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + offset));
+        auto mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_and_si128(
+            _mm_cmpeq_epi8(first, block_first), _mm_cmpeq_epi8(last, block_last)
+        )));
+        for (; mask != 0; mask &= mask - 1) {
+            auto position = std::countr_zero(mask) + 1;
+            if (std::memcmp(data + position, rest, offset) == 0) {
+                return true;
+            }
+        }
+        return false;
+    };
+
+    auto positions = value.length() - offset;
+    for (std::size_t i = 0; i + WIDTH < positions; i += WIDTH) {
+        if (found(i)) {
+            return true;
+        }
+    }
+    return found(positions - WIDTH);
+}
+
+__attribute__((target("avx2"))) bool contains_avx2(
+    std::string_view value, std::string_view substring
+) {
+    constexpr std::size_t WIDTH{AVX2_WIDTH};
+
+    const auto first = _mm256_set1_epi8(substring.front());
+    const auto last = _mm256_set1_epi8(substring.back());
+    const auto offset = substring.length() - 1;
+    const auto* rest = substring.data() + 1;
+
+    auto found = [first, last, offset, rest, &value](std::size_t i)
+        __attribute__((target("avx2"))) {
+        const auto* data = value.data() + i;
+        auto block_first =
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data));
+        auto block_last =
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + offset)
+            );
+        auto mask =
+            static_cast<unsigned>(_mm256_movemask_epi8(_mm256_and_si256(
+                _mm256_cmpeq_epi8(first, block_first),
+                _mm256_cmpeq_epi8(last, block_last)
+            )));
+        for (; mask != 0; mask &= mask - 1) {
+            auto position = std::countr_zero(mask) + 1;
+            if (std::memcmp(data + position, rest, offset) == 0) {
+                return true;
+            }
+        }
+        return false;
+    };
+
+    auto positions = value.length() - offset;
+    for (std::size_t i = 0; i + WIDTH < positions; i += WIDTH) {
+        if (found(i)) {
+            return true;
+        }
+    }
+    return found(positions - WIDTH);
+}
+
+__m128i fold_sse2(__m128i block) {
+    auto shifted = _mm_add_epi8(block, _mm_set1_epi8(UPPER_OFFSET));
+    auto upper = _mm_cmplt_epi8(shifted, _mm_set1_epi8(UPPER_LIMIT));
+    return _mm_or_si128(block, _mm_and_si128(upper, _mm_set1_epi8(CASE_BIT)));
+}
+
+/**
+ * Compare both values in blocks, finishing with a block which overlaps the
+ * previous one so that no scalar remainder is needed. The values must be at
+ * least one block long.
+ */
+bool equals_ignore_case_sse2(std::string_view lhs, std::string_view rhs) {
+    constexpr std::size_t WIDTH{SSE2_WIDTH};
+    constexpr unsigned ALL{0xFFFF};
+
+    auto equal = [&lhs, &rhs](std::size_t i) {
+        auto left = fold_sse2(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(lhs.data() + i))
+        );
+        auto right = fold_sse2(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(rhs.data() + i))
+        );
+        return static_cast<unsigned>(
+                   _mm_movemask_epi8(_mm_cmpeq_epi8(left, right))
+               ) == ALL;
+    };
+
+    for (std::size_t i = 0; i + WIDTH < lhs.length(); i += WIDTH) {
+        if (!equal(i)) {
+            return false;
+        }
+    }
+    return equal(lhs.length() - WIDTH);
+}
+
+__attribute__((target("avx2"))) __m256i fold_avx2(__m256i block) {
+    auto shifted = _mm256_add_epi8(block, _mm256_set1_epi8(UPPER_OFFSET));
+    auto upper = _mm256_cmpgt_epi8(_mm256_set1_epi8(UPPER_LIMIT), shifted);
+    return _mm256_or_si256(
+        block, _mm256_and_si256(upper, _mm256_set1_epi8(CASE_BIT))
+    );
+}
+
+__attribute__((target("avx2"))) bool equals_ignore_case_avx2(
+    std::string_view lhs, std::string_view rhs
+) {
+    constexpr std::size_t WIDTH{AVX2_WIDTH};
+    constexpr unsigned ALL{0xFFFFFFFF};
+
+    auto equal = [&lhs, &rhs](std::size_t i) __attribute__((target("avx2"))) {
+        auto left = fold_avx2(_mm256_loadu_si256(
+            reinterpret_cast<const __m256i*>(lhs.data() + i)
+        ));
+        auto right = fold_avx2(_mm256_loadu_si256(
+            reinterpret_cast<const __m256i*>(rhs.data() + i)
+        ));
+        return static_cast<unsigned>(
+                   _mm256_movemask_epi8(_mm256_cmpeq_epi8(left, right))
+               ) == ALL;
+    };
+
+    for (std::size_t i = 0; i + WIDTH < lhs.length(); i += WIDTH) {
+        if (!equal(i)) {
+            return false;
+        }
+    }
+    return equal(lhs.length() - WIDTH);
+}
+
+bool has_avx2() {
+    static const bool supported = __builtin_cpu_supports("avx2") != 0;
+    return supported;
+}
+
+#endif
+
+} // namespace
+
+bool evlist::contains(std::string_view value, std::string_view substring) {
+    if (substring.length() <= 1) {
+        return substring.empty() || value.contains(substring.front());
+    }
+
+#ifdef EVLIST_SEARCH_X86
+    // Each path handles values with at least one block of positions where
+    // the substring could start, so that AVX2 code does not fall through to
+    // SSE2 code and pay for the transition.
+    auto positions = value.length() < substring.length()
+                         ? 0
+                         : value.length() - substring.length() + 1;
+    if (positions >= AVX2_WIDTH && has_avx2()) {
+        return contains_avx2(value, substring);
+    }
+    if (positions >= SSE2_WIDTH) {
+        return contains_sse2(value, substring);
+    }
+#endif
+    return value.find(substring) != std::string_view::npos;
+}
+
+bool evlist::equals_ignore_case(std::string_view lhs, std::string_view rhs) {
+    if (lhs.length() != rhs.length()) {
+        return false;
+    }
+
+#ifdef EVLIST_SEARCH_X86
+    // Each path handles values of at least one block, so that AVX2 code does
+    // not fall through to SSE2 code and pay for the transition.
+    if (lhs.length() >= AVX2_WIDTH && has_avx2()) {
+        return equals_ignore_case_avx2(lhs, rhs);
+    }
+    if (lhs.length() >= SSE2_WIDTH) {
+        return equals_ignore_case_sse2(lhs, rhs);
+    }
+#endif
+    return equals_ignore_case_scalar(lhs.data(), rhs.data(), lhs.length());
+}
+
+bool evlist::compare(
+    FilterOperator op, std::string_view column, std::string_view value
+) {
+    switch (op) {
+        case FilterOperator::EQUAL:
+            return column == value;
+        case FilterOperator::CONTAINS:
+            return contains(column, value);
+        case FilterOperator::PREFIX:
+            // A prefix is a single `memcmp`, which is already vectorised.
+            return column.starts_with(value);
+        case FilterOperator::CASE_INSENSITIVE:
+            return equals_ignore_case(column, value);
+    }
+    return false;
+}
@@ -0,0 +1,118 @@
+#include "evlist/snapshot.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <expected>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "evlist/device.h"
+#include "evlist/list.h"
+
+evlist::InputDevicesSnapshot::InputDevicesSnapshot()
+    : InputDevicesSnapshot{InputDevices{std::vector<InputDevice>{}}} {}
+
+evlist::InputDevicesSnapshot::InputDevicesSnapshot(InputDevices devices)
+    : slots_{{std::make_shared<const InputDevices>(std::move(devices))}} {}
+
+std::shared_ptr<const evlist::InputDevices>
+evlist::InputDevicesSnapshot::load() const {
+    // Announcing the reader before reading the slot means that a publish
+    // which changes the slot afterwards waits for this reader to finish.
+    auto& counter = counters_.at(counters_index_.load()).at(stripe()).readers;
+    counter.fetch_add(1);
+    auto snapshot = slots_.at(slot_.load());
+    counter.fetch_sub(1);
+    return snapshot;
+}
+
+void evlist::InputDevicesSnapshot::publish(InputDevices devices) {
+    auto snapshot = std::make_shared<const InputDevices>(std::move(devices));
+
+    const std::lock_guard lock{publish_mutex_};
+    replace(std::move(snapshot));
+}
+
+void evlist::InputDevicesSnapshot::update(
+    std::string_view name, std::optional<InputDevice> device
+) {
+    // The latest snapshot cannot change while the lock is held, so no other
+    // update is lost.
+    const std::lock_guard lock{publish_mutex_};
+    const auto& latest = *slots_.at(slot_.load(std::memory_order_relaxed));
+
+    std::vector<InputDevice> devices{};
+    devices.reserve(latest.devices().size() + 1);
+    for (const auto& existing : latest.devices()) {
+        if (existing.device_path().filename() != name) {
+            devices.emplace_back(existing);
+        }
+    }
+    if (device.has_value()) {
+        auto position = std::ranges::upper_bound(devices, *device);
+        devices.insert(position, std::move(*device));
+    }
+
+    InputDevices next{latest.output_format(), std::move(devices)};
+    next.with_parent_columns(latest.parent_columns());
+    replace(std::make_shared<const InputDevices>(std::move(next)));
+}
+
+void evlist::InputDevicesSnapshot::replace(
+    std::shared_ptr<const InputDevices> snapshot
+) {
+    // No reader can be reading the unused slot, since the previous publish
+    // waited for readers of it before returning.
+    auto previous = slot_.load(std::memory_order_relaxed);
+    auto next = 1 - previous;
+    slots_.at(next) = std::move(snapshot);
+    slot_.store(next);
+
+    // Readers which announced themselves on either set of counters may have
+    // read the previous slot. Switching sets between waits means that
+    // readers which keep arriving cannot delay the publish indefinitely.
+    auto index = counters_index_.load(std::memory_order_relaxed);
+    wait_for_readers(1 - index);
+    counters_index_.store(1 - index);
+    wait_for_readers(index);
+
+    slots_.at(previous).reset();
+    generation_.fetch_add(1, std::memory_order_release);
+}
+
+std::expected<void, std::filesystem::filesystem_error>
+evlist::InputDevicesSnapshot::refresh(const InputDeviceLister& lister) {
+    auto devices = lister.list_input_devices();
+    if (!devices.has_value()) {
+        return std::unexpected{devices.error()};
+    }
+
+    publish(std::move(*devices));
+    return {};
+}
+
+std::size_t evlist::InputDevicesSnapshot::generation() const {
+    return generation_.load(std::memory_order_acquire);
+}
+
+std::size_t evlist::InputDevicesSnapshot::stripe() {
+    static std::atomic<std::size_t> threads{0};
+    thread_local const std::size_t stripe =
+        threads.fetch_add(1, std::memory_order_relaxed) % STRIPES;
+    return stripe;
+}
+
+void evlist::InputDevicesSnapshot::wait_for_readers(std::size_t index) const {
+    for (const auto& counter : counters_.at(index)) {
+        while (counter.readers.load() != 0) {
+            std::this_thread::yield();
+        }
+    }
+}
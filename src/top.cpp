@@ -0,0 +1,94 @@
+#include "evlist/top.h"
+
+#include <linux/input.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "evlist/cli.h"
+#include "evlist/device.h"
+
+void evlist::EventCounts::record(std::span<const input_event> events
+) noexcept {
+    events_ += events.size();
+    for (const auto& event : events) {
+        if (event.type < types_.size()) {
+            types_[event.type]++;
+        }
+        if (event.type == EV_SYN && event.code == SYN_DROPPED) {
+            syn_dropped_++;
+        }
+    }
+}
+
+void evlist::EventCounts::reset() noexcept { *this = EventCounts{}; }
+
+uint64_t evlist::EventCounts::events() const { return events_; }
+
+uint64_t evlist::EventCounts::syn_dropped() const { return syn_dropped_; }
+
+const std::array<uint64_t, EV_CNT>& evlist::EventCounts::types() const {
+    return types_;
+}
+
+evlist::EventRates::EventRates(
+    Format output_format, std::vector<InputDevice> devices
+)
+    : output_format_{output_format},
+      devices_{std::move(devices)},
+      current_(devices_.size()),
+      finished_(devices_.size()),
+      order_(devices_.size()) {
+    std::iota(order_.begin(), order_.end(), 0);
+}
+
+void evlist::EventRates::record(
+    std::size_t device, std::span<const input_event> events
+) {
+    current_.at(device).record(events);
+}
+
+void evlist::EventRates::finish_interval(std::chrono::duration<double> elapsed
+) {
+    std::swap(current_, finished_);
+    for (auto& counts : current_) {
+        counts.reset();
+    }
+    elapsed_ = elapsed;
+
+    std::ranges::stable_sort(order_, [this](auto lhs, auto rhs) {
+        return finished_[lhs].events() > finished_[rhs].events();
+    });
+}
+
+const std::vector<evlist::InputDevice>& evlist::EventRates::devices() const {
+    return devices_;
+}
+
+const std::vector<std::size_t>& evlist::EventRates::order() const {
+    return order_;
+}
+
+const evlist::EventCounts& evlist::EventRates::counts(std::size_t device
+) const {
+    return finished_.at(device);
+}
+
+double evlist::EventRates::rate(std::size_t device) const {
+    if (elapsed_.count() <= 0) {
+        return 0;
+    }
+    return static_cast<double>(finished_.at(device).events()) /
+           elapsed_.count();
+}
+
+evlist::Format evlist::EventRates::output_format() const {
+    return output_format_;
+}
@@ -0,0 +1,203 @@
+#include "evlist/archive.h"
+
+#include <gtest/gtest.h>
+#include <linux/input.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include "evlist/cli.h"
+#include "evlist/device.h"
+#include "evlist/record.h"
+
+namespace {
+
+const std::vector<evlist::InputDevice> DEVICES{
+    evlist::InputDevice{"/dev/input/event3", "keyboard", {}, {}, {}},
+    evlist::InputDevice{"/dev/input/event10", "mouse", {}, {}, {}}
+};
+
+/**
+ * Generate interleaved key presses on device 0 and relative motion on device
+ * 1, one event per millisecond starting at 100 seconds.
+ */
+std::vector<evlist::EventRecord> generate(std::size_t count) {
+    std::vector<evlist::EventRecord> records{};
+    for (std::size_t i = 0; i < count; i++) {
+        auto device = static_cast<uint32_t>(i % 2);
+        auto time = static_cast<int64_t>(100'000'000 + i * 1'000);
+        records.emplace_back(evlist::EventRecord{
+            .seconds = time / 1'000'000,
+            .microseconds = time % 1'000'000,
+            .device = device,
+            .type = static_cast<uint16_t>(device == 0 ? EV_KEY : EV_REL),
+            .code = static_cast<uint16_t>(
+                device == 0 ? KEY_A + (i / 2 % 3) : REL_X
+            ),
+            .value = device == 0 ? static_cast<int32_t>(i % 3)
+                                 : -static_cast<int32_t>(i),
+            .reserved = 0
+        });
+    }
+    return records;
+}
+
+std::vector<evlist::EventRecord> expected(
+    const std::vector<evlist::EventRecord>& records, auto matches
+) {
+    std::vector<evlist::EventRecord> out{};
+    for (uint32_t device = 0; device < DEVICES.size(); device++) {
+        for (const auto& record : records) {
+            if (record.device == device && matches(record)) {
+                out.emplace_back(record);
+            }
+        }
+    }
+    return out;
+}
+
+evlist::EventArchive create(
+    const std::vector<evlist::EventRecord>& records,
+    std::size_t block_size = evlist::EventArchive::BLOCK_SIZE
+) {
+    return evlist::EventArchive::decode(
+               evlist::EventArchive::encode(DEVICES, records, block_size)
+    )
+        .value();
+}
+
+evlist::ArchiveQuery parse(const std::vector<std::string>& filters) {
+    return evlist::ArchiveQuery::parse(filters, DEVICES).value();
+}
+
+} // namespace
+
+TEST(EventArchiveTest, RoundTrip) {
+    auto records = generate(1000);
+    auto archive = create(records, 64);
+
+    ASSERT_EQ(archive.devices(), DEVICES);
+    // 500 events per device in blocks of 64.
+    ASSERT_EQ(archive.blocks().size(), 16);
+    ASSERT_EQ(
+        archive.query({}), expected(records, [](auto&) { return true; })
+    );
+}
+
+TEST(EventArchiveTest, Compressed) {
+    auto records = generate(10000);
+    auto bytes = evlist::EventArchive::encode(DEVICES, records);
+    ASSERT_LT(bytes.size(), records.size() * sizeof(input_event) / 3);
+}
+
+TEST(EventArchiveTest, Index) {
+    auto archive = create(generate(256), 64);
+
+    const auto& block = archive.blocks()[0];
+    ASSERT_EQ(block.device, 0);
+    ASSERT_EQ(block.events, 64);
+    ASSERT_EQ(block.min_time, 100'000'000);
+    ASSERT_EQ(block.max_time, 100'126'000);
+    ASSERT_EQ(block.min_type, EV_KEY);
+    ASSERT_EQ(block.max_type, EV_KEY);
+    ASSERT_EQ(block.min_code, KEY_A);
+    ASSERT_EQ(block.max_code, KEY_A + 2);
+
+    ASSERT_TRUE(parse({"device=1"}).skip(block));
+    ASSERT_TRUE(parse({"type=EV_REL"}).skip(block));
+    ASSERT_TRUE(parse({"from=100.2"}).skip(block));
+    ASSERT_FALSE(parse({"code=KEY_S", "to=100.1"}).skip(block));
+}
+
+TEST(EventArchiveTest, Query) {
+    auto records = generate(1000);
+    auto archive = create(records, 64);
+
+    ASSERT_EQ(
+        archive.query(parse({"type=EV_KEY", "code=KEY_S"})),
+        expected(records, [](auto& record) {
+            return record.type == EV_KEY && record.code == KEY_S;
+        })
+    );
+    ASSERT_EQ(
+        archive.query(parse({"device=/dev/input/event10", "from=100.5"})),
+        expected(records, [](auto& record) {
+            return record.device == 1 && record.seconds == 100 &&
+                   record.microseconds >= 500'000;
+        })
+    );
+    ASSERT_EQ(
+        archive.query(parse({"from=100.25", "to=100.75", "code=REL_X"})),
+        expected(records, [](auto& record) {
+            auto time = record.seconds * 1'000'000 + record.microseconds;
+            return time >= 100'250'000 && time < 100'750'000 &&
+                   record.type == EV_REL;
+        })
+    );
+    ASSERT_TRUE(archive.query(parse({"type=EV_ABS"})).empty());
+}
+
+TEST(EventArchiveTest, QueryInvalid) {
+    ASSERT_FALSE(evlist::ArchiveQuery::parse({"type"}, DEVICES).has_value());
+    ASSERT_FALSE(
+        evlist::ArchiveQuery::parse({"type=KEY_A"}, DEVICES).has_value()
+    );
+    ASSERT_FALSE(
+        evlist::ArchiveQuery::parse({"code=EV_KEY"}, DEVICES).has_value()
+    );
+    ASSERT_FALSE(
+        evlist::ArchiveQuery::parse({"type=EV_REL", "code=KEY_A"}, DEVICES)
+            .has_value()
+    );
+    ASSERT_FALSE(evlist::ArchiveQuery::parse({"device=2"}, DEVICES).has_value());
+    ASSERT_FALSE(evlist::ArchiveQuery::parse({"from=x"}, DEVICES).has_value());
+    ASSERT_FALSE(evlist::ArchiveQuery::parse({"name=a"}, DEVICES).has_value());
+}
+
+TEST(EventArchiveTest, DecodeInvalid) {
+    auto bytes = evlist::EventArchive::encode(DEVICES, generate(100));
+
+    auto truncated = evlist::EventArchive::decode(bytes.substr(0, 100));
+    ASSERT_FALSE(truncated.has_value());
+    ASSERT_EQ(
+        truncated.error().code(),
+        std::make_error_code(std::errc::invalid_argument)
+    );
+
+    bytes[0] = 'X';
+    ASSERT_FALSE(evlist::EventArchive::decode(bytes).has_value());
+    ASSERT_FALSE(evlist::EventArchive::decode("").has_value());
+}
+
+TEST(EventArchiveTest, Summary) {
+    auto archive = create(generate(2002));
+    const evlist::ArchiveSummary summary{
+        evlist::Format::CSV, archive, parse({"type=EV_REL"})
+    };
+
+    ASSERT_EQ(summary.events(0), 0);
+    ASSERT_EQ(summary.events(1), 1001);
+    ASSERT_DOUBLE_EQ(summary.seconds(1), 2.0);
+    ASSERT_DOUBLE_EQ(summary.rate(1), 500.5);
+    ASSERT_EQ(
+        std::format("{}", summary),
+        "\"DEVICE_PATH\",\"NAME\",\"EVENTS\",\"SECONDS\",\"EVENTS_PER_SEC\"\n"
+        "\"/dev/input/event10\",\"mouse\",\"1001\",\"2.000\",\"500.5\"\n"
+    );
+}
+
+TEST(EventArchiveTest, Format) {
+    const evlist::ArchiveEvents events{
+        evlist::Format::TABLE, DEVICES, generate(2)
+    };
+    ASSERT_EQ(
+        std::format("{}", events),
+        "DEVICE_PATH        TIME       TYPE   CODE  VALUE\n"
+        "/dev/input/event3  100.000000 EV_KEY KEY_A 0\n"
+        "/dev/input/event10 100.001000 EV_REL REL_X -1\n"
+    );
+}
@@ -0,0 +1,69 @@
+#include "evlist/cli.h"
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <vector>
+
+TEST(CliTest, ParseCommonNoArguments) {
+    auto cli = evlist::Cli::parse_common({});
+    ASSERT_TRUE(cli.has_value());
+    ASSERT_EQ(cli->format(), evlist::Format::TABLE);
+    ASSERT_TRUE(cli->filter().empty());
+    ASSERT_FALSE(cli->use_regex());
+    ASSERT_FALSE(cli->limit().has_value());
+    ASSERT_EQ(cli->command(), evlist::Command::LIST);
+}
+
+TEST(CliTest, ParseCommonOptions) {
+    const std::array args{
+        "--format",
+        "CSV",
+        "-f",
+        "name*=logi",
+        "--filter=vendor=046d",
+        "-g",
+        "-p",
+        "--first"
+    };
+    auto cli = evlist::Cli::parse_common(args);
+    ASSERT_TRUE(cli.has_value());
+    ASSERT_EQ(cli->format(), evlist::Format::CSV);
+    ASSERT_EQ(
+        cli->filter(),
+        (std::vector<evlist::FilterTerm>{
+            {evlist::Filter::NAME, "logi", evlist::FilterOperator::CONTAINS},
+            {evlist::Filter::VENDOR, "046d"},
+        })
+    );
+    ASSERT_TRUE(cli->use_glob());
+    ASSERT_TRUE(cli->parent());
+    ASSERT_EQ(cli->limit(), 1);
+
+    const std::array json{"-o", "json", "-r"};
+    cli = evlist::Cli::parse_common(json);
+    ASSERT_TRUE(cli.has_value());
+    ASSERT_EQ(cli->format(), evlist::Format::JSON);
+    ASSERT_TRUE(cli->use_regex());
+}
+
+TEST(CliTest, ParseCommonFallsBack) {
+    // Anything other than a valid common invocation is left to the full
+    // parser, which reports errors and prints help.
+    const std::vector<std::vector<const char*>> fallbacks{
+        {"--help"},
+        {"--version"},
+        {"--limit", "3"},
+        {"-o"},
+        {"-o", "xml"},
+        {"-o", "csv", "--format", "csv"},
+        {"-f", "name"},
+        {"-f", "unknown=value"},
+        {"-r", "-g"},
+        {"-p", "-p"},
+        {"archive", "recording", "archive"},
+    };
+    for (const auto& args : fallbacks) {
+        ASSERT_FALSE(evlist::Cli::parse_common(args).has_value());
+    }
+}
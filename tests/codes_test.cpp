@@ -0,0 +1,98 @@
+#include "evlist/codes.h"
+
+#include <gtest/gtest.h>
+#include <linux/input-event-codes.h>
+
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+TEST(EventCodesTest, Name) {
+    ASSERT_EQ(evlist::EventCodes::name(evlist::CodeType::EV, EV_KEY), "EV_KEY");
+    ASSERT_EQ(evlist::EventCodes::name(evlist::CodeType::KEY, KEY_A), "KEY_A");
+    ASSERT_EQ(
+        evlist::EventCodes::name(evlist::CodeType::KEY, BTN_LEFT), "BTN_LEFT"
+    );
+    ASSERT_EQ(evlist::EventCodes::name(evlist::CodeType::ABS, ABS_X), "ABS_X");
+    ASSERT_EQ(
+        evlist::EventCodes::name(
+            evlist::CodeType::INPUT_PROP, INPUT_PROP_POINTER
+        ),
+        "INPUT_PROP_POINTER"
+    );
+}
+
+TEST(EventCodesTest, NameAlias) {
+    ASSERT_EQ(
+        evlist::EventCodes::name(evlist::CodeType::KEY, BTN_SOUTH), "BTN_SOUTH"
+    );
+    ASSERT_EQ(
+        evlist::EventCodes::code("BTN_A"),
+        (evlist::EventCode{evlist::CodeType::KEY, BTN_SOUTH})
+    );
+}
+
+TEST(EventCodesTest, NameNotDefined) {
+    ASSERT_EQ(
+        evlist::EventCodes::name(evlist::CodeType::EV, EV_MAX - 1), std::nullopt
+    );
+    ASSERT_EQ(
+        evlist::EventCodes::name(evlist::CodeType::REL, REL_CNT), std::nullopt
+    );
+}
+
+TEST(EventCodesTest, Code) {
+    ASSERT_EQ(
+        evlist::EventCodes::code("EV_ABS"),
+        (evlist::EventCode{evlist::CodeType::EV, EV_ABS})
+    );
+    ASSERT_EQ(
+        evlist::EventCodes::code("KEY_A"),
+        (evlist::EventCode{evlist::CodeType::KEY, KEY_A})
+    );
+    ASSERT_EQ(
+        evlist::EventCodes::code("SW_LID"),
+        (evlist::EventCode{evlist::CodeType::SW, SW_LID})
+    );
+}
+
+TEST(EventCodesTest, CodeNotDefined) {
+    ASSERT_EQ(evlist::EventCodes::code(""), std::nullopt);
+    ASSERT_EQ(evlist::EventCodes::code("KEY_"), std::nullopt);
+    ASSERT_EQ(evlist::EventCodes::code("EV_KEYS"), std::nullopt);
+}
+
+TEST(EventCodesTest, RoundTrip) {
+    for (const auto type :
+         {evlist::CodeType::EV,
+          evlist::CodeType::KEY,
+          evlist::CodeType::REL,
+          evlist::CodeType::ABS,
+          evlist::CodeType::SW,
+          evlist::CodeType::LED,
+          evlist::CodeType::MSC,
+          evlist::CodeType::SND,
+          evlist::CodeType::INPUT_PROP}) {
+        for (uint16_t code = 0; code < evlist::EventCodes::count(type);
+             code++) {
+            auto name = evlist::EventCodes::name(type, code);
+            if (name.has_value()) {
+                ASSERT_EQ(
+                    evlist::EventCodes::code(*name),
+                    (evlist::EventCode{type, code})
+                );
+            }
+        }
+    }
+}
+
+TEST(EventCodesTest, CodeType) {
+    ASSERT_EQ(evlist::EventCodes::code_type(EV_KEY), evlist::CodeType::KEY);
+    ASSERT_EQ(evlist::EventCodes::code_type(EV_ABS), evlist::CodeType::ABS);
+    ASSERT_EQ(evlist::EventCodes::code_type(EV_SYN), std::nullopt);
+    ASSERT_EQ(evlist::EventCodes::event_type(evlist::CodeType::REL), EV_REL);
+    ASSERT_EQ(
+        evlist::EventCodes::event_type(evlist::CodeType::INPUT_PROP),
+        std::nullopt
+    );
+}
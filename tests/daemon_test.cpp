@@ -0,0 +1,304 @@
+#include "evlist/daemon.h"
+
+#include <gtest/gtest.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <format>
+#include <fstream>
+#include <optional>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "common/common.h"
+#include "evlist/cli.h"
+#include "evlist/device.h"
+#include "evlist/events.h"
+#include "evlist/snapshot.h"
+
+namespace {
+
+using namespace std::chrono_literals;
+
+evlist::fs::path temporary_socket(const std::string& name) {
+    return evlist::fs::temp_directory_path() /
+           std::format("evlist_{}_{}.sock", getpid(), name);
+}
+
+evlist::InputDevices create_devices() {
+    std::vector<evlist::InputDevice> devices{};
+    devices.emplace_back(
+        "/dev/input/event1",
+        "keyboard",
+        "/dev/input/by-id/usb-keyboard-event-kbd",
+        std::nullopt,
+        evlist::create_capabilities()
+    );
+    devices.emplace_back(
+        "/dev/input/event2",
+        "mouse",
+        std::nullopt,
+        "/dev/input/by-path/platform-i8042-serio-1-event-mouse",
+        std::vector<std::string>{"EV_REL"}
+    );
+    return evlist::InputDevices{std::move(devices)};
+}
+
+evlist::DeviceRequest name_request(std::string name) {
+    evlist::DeviceRequest request{};
+    request.output_format = evlist::Format::CSV;
+    request.filter.emplace_back(
+        evlist::FilterTerm{evlist::Filter::NAME, std::move(name)}
+    );
+    return request;
+}
+
+/**
+ * Connect to a server without a `DeviceClient`, so that tests control exactly
+ * what is sent.
+ */
+evlist::FileDescriptor connect_socket(const evlist::fs::path& path) {
+    evlist::FileDescriptor socket{
+        ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0)
+    };
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    std::ranges::copy(path.native(), std::begin(address.sun_path));
+    EXPECT_EQ(
+        ::connect(
+            socket.get(),
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+            reinterpret_cast<const sockaddr*>(&address),
+            sizeof(address)
+        ),
+        0
+    );
+    return socket;
+}
+
+/**
+ * Frame an encoded request with its length, as a `DeviceClient` sends it.
+ */
+std::string frame(const evlist::DeviceRequest& request) {
+    auto encoded = request.encode();
+    auto length = static_cast<std::uint32_t>(encoded.size());
+    std::string message(sizeof(length), '\0');
+    std::memcpy(message.data(), &length, sizeof(length));
+    return message + encoded;
+}
+
+/**
+ * Serve a snapshot on a background thread until the test ends.
+ */
+class ServerThread {
+public:
+    ServerThread(
+        const evlist::fs::path& path,
+        const evlist::InputDevicesSnapshot& snapshot
+    )
+        : server_{evlist::DeviceServer::bind(path, snapshot).value()},
+          thread_{[this](const std::stop_token& stop) {
+              while (!stop.stop_requested()) {
+                  ASSERT_TRUE(server_.poll(10ms).has_value());
+              }
+          }} {}
+
+private:
+    evlist::DeviceServer server_;
+    std::jthread thread_;
+};
+
+} // namespace
+
+TEST(DeviceRequestTest, EncodeDecode) {
+    auto request = name_request("keyboard");
+    request.filter.emplace_back(evlist::FilterTerm{
+        evlist::Filter::CAPABILITIES, "EV_KEY", evlist::FilterOperator::CONTAINS
+    });
+    request.use_glob = true;
+    request.parent_columns = true;
+
+    ASSERT_EQ(evlist::DeviceRequest::decode(request.encode()), request);
+    ASSERT_EQ(
+        evlist::DeviceRequest::decode(evlist::DeviceRequest{}.encode()),
+        evlist::DeviceRequest{}
+    );
+}
+
+TEST(DeviceRequestTest, DecodeMalformed) {
+    auto encoded = name_request("keyboard").encode();
+
+    ASSERT_FALSE(evlist::DeviceRequest::decode("").has_value());
+    ASSERT_FALSE(
+        evlist::DeviceRequest::decode(encoded.substr(0, encoded.size() - 1))
+            .has_value()
+    );
+
+    auto format = encoded;
+    format[0] = '\x7f';
+    ASSERT_FALSE(evlist::DeviceRequest::decode(format).has_value());
+
+    auto column = encoded;
+    column[2] = '\x7f';
+    ASSERT_FALSE(evlist::DeviceRequest::decode(column).has_value());
+}
+
+TEST(DeviceServerTest, Query) {
+    const auto path = temporary_socket("query");
+    const evlist::InputDevicesSnapshot snapshot{create_devices()};
+    const auto server = evlist::DeviceServer::bind(path, snapshot);
+    ASSERT_TRUE(server.has_value());
+
+    ASSERT_EQ(
+        server->query(name_request("mouse")).value(),
+        "\"NAME\",\"DEVICE_PATH\",\"BY_ID\",\"BY_PATH\",\"CAPABILITIES\"\n"
+        "\"mouse\",\"/dev/input/event2\",\"\","
+        "\"/dev/input/by-path/platform-i8042-serio-1-event-mouse\","
+        "\"[EV_REL]\"\n"
+    );
+
+    auto regex = name_request("(");
+    regex.use_regex = true;
+    ASSERT_FALSE(server->query(regex).has_value());
+
+    evlist::fs::remove(path);
+}
+
+TEST(DeviceServerTest, ClientQueries) {
+    const auto path = temporary_socket("client");
+    evlist::InputDevicesSnapshot snapshot{create_devices()};
+    const ServerThread server{path, snapshot};
+
+    auto client = evlist::DeviceClient::connect(path);
+    ASSERT_TRUE(client.has_value());
+
+    auto keyboard = client->query(name_request("keyboard"));
+    ASSERT_TRUE(keyboard.has_value());
+    ASSERT_TRUE(keyboard->contains(R"("keyboard","/dev/input/event1")"));
+    ASSERT_FALSE(keyboard->contains("mouse"));
+
+    // Invalid filters are reported without dropping the connection.
+    auto regex = name_request("(");
+    regex.use_regex = true;
+    auto invalid = client->query(regex);
+    ASSERT_FALSE(invalid.has_value());
+    ASSERT_EQ(
+        invalid.error().code(),
+        std::make_error_code(std::errc::invalid_argument)
+    );
+
+    // Later queries are answered from newly published snapshots.
+    snapshot.publish(
+        evlist::InputDevices{std::vector<evlist::InputDevice>{}}
+    );
+    auto empty = client->query(name_request("keyboard"));
+    ASSERT_TRUE(empty.has_value());
+    ASSERT_FALSE(empty->contains("keyboard"));
+
+    // Other clients are served alongside the first.
+    auto other = evlist::DeviceClient::connect(path);
+    ASSERT_TRUE(other.has_value());
+    ASSERT_TRUE(other->query(evlist::DeviceRequest{}).has_value());
+
+    evlist::fs::remove(path);
+}
+
+TEST(DeviceServerTest, ReplaceStaleSocket) {
+    const auto path = temporary_socket("stale");
+    const evlist::InputDevicesSnapshot snapshot{create_devices()};
+    ASSERT_TRUE(evlist::DeviceServer::bind(path, snapshot).has_value());
+
+    // The socket of a server that exited is replaced, but other files are not.
+    ASSERT_TRUE(evlist::DeviceServer::bind(path, snapshot).has_value());
+    evlist::fs::remove(path);
+    std::ofstream{path} << "data\n";
+    ASSERT_FALSE(evlist::DeviceServer::bind(path, snapshot).has_value());
+
+    evlist::fs::remove(path);
+}
+
+TEST(DeviceServerTest, KeepLiveSocket) {
+    const auto path = temporary_socket("live");
+    const evlist::InputDevicesSnapshot snapshot{create_devices()};
+    const ServerThread server{path, snapshot};
+
+    // The socket of a running server is not replaced.
+    auto other = evlist::DeviceServer::bind(path, snapshot);
+    ASSERT_FALSE(other.has_value());
+    ASSERT_EQ(
+        other.error().code(), std::make_error_code(std::errc::address_in_use)
+    );
+
+    auto client = evlist::DeviceClient::connect(path);
+    ASSERT_TRUE(client.has_value());
+    ASSERT_TRUE(client->query(evlist::DeviceRequest{}).has_value());
+
+    evlist::fs::remove(path);
+}
+
+TEST(DeviceServerTest, AnswerBeforeDisconnect) {
+    const auto path = temporary_socket("disconnect");
+    const evlist::InputDevicesSnapshot snapshot{create_devices()};
+    const ServerThread server{path, snapshot};
+
+    // A request sent just before the client stops sending is answered.
+    auto socket = connect_socket(path);
+    auto message = frame(name_request("mouse"));
+    ASSERT_EQ(
+        send(socket.get(), message.data(), message.size(), 0),
+        static_cast<ssize_t>(message.size())
+    );
+    ASSERT_EQ(shutdown(socket.get(), SHUT_WR), 0);
+
+    std::string response{};
+    std::array<char, 4096> buffer{};
+    auto received = recv(socket.get(), buffer.data(), buffer.size(), 0);
+    while (received > 0) {
+        response.append(buffer.data(), static_cast<std::size_t>(received));
+        received = recv(socket.get(), buffer.data(), buffer.size(), 0);
+    }
+    ASSERT_EQ(received, 0);
+    ASSERT_TRUE(response.contains(R"("mouse","/dev/input/event2")"));
+
+    evlist::fs::remove(path);
+}
+
+TEST(DeviceServerTest, SlowClient) {
+    const auto path = temporary_socket("slow");
+    const evlist::InputDevicesSnapshot snapshot{create_devices()};
+    const ServerThread server{path, snapshot};
+
+    // Responses to a client which never reads them outgrow the socket buffer,
+    // which must not stop other clients from being served.
+    auto slow = connect_socket(path);
+    std::string requests{};
+    for (int i = 0; i < 4096; i++) {
+        requests += frame(evlist::DeviceRequest{});
+    }
+    ASSERT_EQ(
+        send(slow.get(), requests.data(), requests.size(), 0),
+        static_cast<ssize_t>(requests.size())
+    );
+
+    auto client = evlist::DeviceClient::connect(path);
+    ASSERT_TRUE(client.has_value());
+    auto keyboard = client->query(name_request("keyboard"));
+    ASSERT_TRUE(keyboard.has_value());
+    ASSERT_TRUE(keyboard->contains(R"("keyboard","/dev/input/event1")"));
+
+    evlist::fs::remove(path);
+}
+
+TEST(DeviceClientTest, ConnectMissing) {
+    auto client = evlist::DeviceClient::connect(temporary_socket("missing"));
+    ASSERT_FALSE(client.has_value());
+}
@@ -4,6 +4,7 @@
 
 #include <format>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "common/common.h"
@@ -207,3 +208,139 @@ TEST(InputDeviceTest, Format) {
         "\n"
     );
 }
+
+TEST(InputDeviceTest, FormatJson) {
+    std::string input{"event"};
+    auto capabilities = evlist::create_capabilities();
+    evlist::InputDevice device{input, input, {}, input, capabilities};
+
+    ASSERT_EQ(
+        std::format("{}", evlist::InputDevices{evlist::Format::JSON, {device}}),
+        "[\n"
+        R"({"NAME":"event","DEVICE_PATH":"event","BY_ID":"","BY_PATH":"event",)"
+        R"("CAPABILITIES":"[EV_SYN, EV_KEY, EV_REL, EV_MSC]"})"
+        "\n]\n"
+    );
+    ASSERT_EQ(
+        std::format(
+            "{}", evlist::InputDevices{evlist::Format::NDJSON, {device, device}}
+        ),
+        std::format(
+            "{0}\n{0}\n",
+            R"({"NAME":"event","DEVICE_PATH":"event","BY_ID":"",)"
+            R"("BY_PATH":"event",)"
+            R"("CAPABILITIES":"[EV_SYN, EV_KEY, EV_REL, EV_MSC]"})"
+        )
+    );
+    ASSERT_EQ(
+        std::format("{}", evlist::InputDevices{evlist::Format::TSV, {device}}),
+        "NAME\tDEVICE_PATH\tBY_ID\tBY_PATH\tCAPABILITIES\n"
+        "event\tevent\t\tevent\t[EV_SYN, EV_KEY, EV_REL, EV_MSC]\n"
+    );
+}
+
+TEST(InputDeviceTest, FormatParentColumnsTable) {
+    std::string input{"event"};
+    evlist::InputDevice device{input, input, input, input, {}};
+    device.with_parent({"input3", "046d", "c52b", "0003", "usb-1/input0", ""});
+
+    const auto devices =
+        evlist::InputDevices{evlist::Format::TABLE, {device}}
+            .with_parent_columns(true);
+    ASSERT_EQ(
+        std::format("{}", devices),
+        "NAME  DEVICE_PATH BY_ID BY_PATH PARENT VENDOR PRODUCT BUS  "
+        "PHYS         UNIQ CAPABILITIES\n"
+        "event event       event event   input3 046d   c52b    0003 "
+        "usb-1/input0      \n"
+    );
+}
+
+TEST(InputDeviceTest, FormatParentColumns) {
+    std::string input{"event"};
+    evlist::InputDevice device{input, input, input, input, {}};
+    device.with_parent({"input3", "046d", "c52b", "0003", "usb-1/input0", ""});
+
+    const auto devices =
+        evlist::InputDevices{evlist::Format::CSV, {device}}.with_parent_columns(
+            true
+        );
+    auto csv = std::format("{}", devices);
+    ASSERT_EQ(
+        csv,
+        R"("NAME","DEVICE_PATH","BY_ID","BY_PATH","PARENT","VENDOR","PRODUCT",)"
+        R"("BUS","PHYS","UNIQ","CAPABILITIES")"
+        "\n"
+        R"("event","event","event","event","input3","046d","c52b","0003",)"
+        R"("usb-1/input0","","")"
+        "\n"
+    );
+
+    auto parsed = evlist::InputDevices::from_csv(csv);
+    ASSERT_TRUE(parsed.has_value());
+    ASSERT_EQ(parsed->devices(), std::vector{device});
+}
+
+TEST(InputDeviceTest, FilterAndGroupByParent) {
+    auto device = [](std::string path, std::string parent) {
+        evlist::InputDevice device{std::move(path), "", {}, {}, {}};
+        device.with_parent({std::move(parent), "046d", "", "", "", ""});
+        return device;
+    };
+
+    evlist::InputDevices devices{
+        {device("/dev/input/event0", "input1"),
+         device("/dev/input/event1", "input2"),
+         device("/dev/input/event2", "input1"),
+         device("/dev/input/event3", "")}
+    };
+
+    auto groups = devices.group_by_parent();
+    ASSERT_EQ(groups.size(), 3);
+    ASSERT_EQ(groups[0].size(), 2);
+    ASSERT_EQ(groups[0][1].device_path(), "/dev/input/event2");
+    ASSERT_EQ(groups[1].size(), 1);
+    ASSERT_EQ(groups[2][0].device_path(), "/dev/input/event3");
+
+    devices.filter(
+        {{evlist::Filter::PARENT, "input1"}, {evlist::Filter::VENDOR, "046d"}},
+        false
+    );
+    ASSERT_EQ(devices.devices().size(), 2);
+}
+
+TEST(InputDeviceTest, Find) {
+    evlist::InputDevices devices{
+        {{"/dev/input/event0", "keyboard", "by_id_0", {}, {"EV_SYN", "EV_KEY"}},
+         {"/dev/input/event1", "mouse", {}, {}, {"EV_SYN", "EV_REL"}},
+         {"/dev/input/event2", "keyboard", {}, "by_path_2", {"EV_SYN"}}}
+    };
+
+    auto keyboards = devices.find(evlist::Filter::NAME, "keyboard");
+    ASSERT_EQ(keyboards.size(), 2);
+    ASSERT_EQ(keyboards[0]->device_path(), "/dev/input/event0");
+    ASSERT_EQ(keyboards[1]->device_path(), "/dev/input/event2");
+
+    auto path = devices.find(evlist::Filter::DEVICE_PATH, "/dev/input/event1");
+    ASSERT_EQ(path.size(), 1);
+    ASSERT_EQ(path[0]->name(), "mouse");
+
+    ASSERT_EQ(devices.find(evlist::Filter::BY_ID, "by_id_0").size(), 1);
+    ASSERT_EQ(devices.find(evlist::Filter::BY_ID, "").size(), 2);
+    ASSERT_EQ(devices.find(evlist::Filter::CAPABILITIES, "EV_SYN").size(), 3);
+    ASSERT_TRUE(devices.find(evlist::Filter::NAME, "touchpad").empty());
+
+    // Copies index their own devices, and modifying devices rebuilds indexes.
+    const auto copy = devices;
+    devices.filter({{evlist::Filter::NAME, "mouse"}}, false);
+    ASSERT_TRUE(devices.find(evlist::Filter::NAME, "keyboard").empty());
+    keyboards = copy.find(evlist::Filter::NAME, "keyboard");
+    ASSERT_EQ(keyboards.size(), 2);
+    ASSERT_EQ(keyboards[0], copy.find(evlist::Filter::BY_ID, "by_id_0")[0]);
+
+    // Moves index their own devices, and leave the moved-from devices empty.
+    auto moved = std::move(devices);
+    ASSERT_EQ(moved.find(evlist::Filter::NAME, "mouse").size(), 1);
+    // NOLINTNEXTLINE(bugprone-use-after-move,hicpp-invalid-access-moved)
+    ASSERT_TRUE(devices.find(evlist::Filter::NAME, "mouse").empty());
+}
@@ -0,0 +1,143 @@
+#include "evlist/diff.h"
+
+#include <gtest/gtest.h>
+
+#include <format>
+#include <string>
+#include <vector>
+
+#include "common/common.h"
+#include "evlist/cli.h"
+#include "evlist/device.h"
+
+TEST(InputDevicesDiffTest, Diff) {
+    const evlist::InputDevice first{
+        "/dev/input/event3", "3", {"by_id_3"}, {}, evlist::create_capabilities()
+    };
+    const evlist::InputDevice second{
+        "/dev/input/event10", "10", {}, {}, evlist::create_capabilities()
+    };
+    const evlist::InputDevice second_changed{
+        "/dev/input/event10", "ten", {"by_id_10"}, {}, {}
+    };
+    const evlist::InputDevice third{
+        "/dev/input/event11", "11", {}, {}, evlist::create_capabilities()
+    };
+
+    const evlist::InputDevices previous{std::vector{first, second}};
+    const evlist::InputDevices current{std::vector{second_changed, third}};
+    auto diff = previous.diff(current);
+
+    ASSERT_EQ(diff.added(), std::vector{third});
+    ASSERT_EQ(diff.removed(), std::vector{first});
+    ASSERT_EQ(diff.changed().size(), 1);
+    ASSERT_EQ(diff.changed()[0].previous(), second);
+    ASSERT_EQ(diff.changed()[0].current(), second_changed);
+    ASSERT_EQ(
+        diff.changed()[0].columns(),
+        (std::vector{
+            evlist::Filter::NAME,
+            evlist::Filter::BY_ID,
+            evlist::Filter::CAPABILITIES
+        })
+    );
+}
+
+TEST(InputDevicesDiffTest, DiffUnsorted) {
+    const evlist::InputDevice first{"/dev/input/event3", "3", {}, {}, {}};
+    const evlist::InputDevice second{"/dev/input/event10", "10", {}, {}, {}};
+
+    const evlist::InputDevices previous{std::vector{second, first}};
+    const evlist::InputDevices current{std::vector{first}};
+    auto diff = previous.diff(current);
+
+    ASSERT_TRUE(diff.added().empty());
+    ASSERT_EQ(diff.removed(), std::vector{second});
+    ASSERT_TRUE(diff.changed().empty());
+}
+
+TEST(InputDevicesDiffTest, DiffEmpty) {
+    const evlist::InputDevice device{
+        "/dev/input/event3", "3", {""}, {}, evlist::create_capabilities()
+    };
+
+    const evlist::InputDevices previous{std::vector{device}};
+    const evlist::InputDevice without_by_id{
+        "/dev/input/event3", "3", {}, {}, evlist::create_capabilities()
+    };
+    const evlist::InputDevices current{std::vector{without_by_id}};
+
+    ASSERT_TRUE(previous.diff(current).empty());
+}
+
+TEST(InputDevicesDiffTest, FromCsv) {
+    const evlist::InputDevices devices{
+        evlist::Format::CSV,
+        {{"/dev/input/event10", R"(name "10")", {}, {"by_path"}, {}},
+         {"/dev/input/event3",
+          "name, 3",
+          {"by_id"},
+          {},
+          evlist::create_capabilities()}}
+    };
+
+    auto parsed = evlist::InputDevices::from_csv(std::format("{}", devices));
+    ASSERT_TRUE(parsed.has_value());
+    ASSERT_TRUE(devices.diff(*parsed).empty());
+    ASSERT_EQ(parsed->devices()[0].name(), R"(name "10")");
+    ASSERT_EQ(parsed->devices()[0].by_path(), "by_path");
+    ASSERT_EQ(parsed->devices()[1].device_path(), "/dev/input/event3");
+    ASSERT_EQ(parsed->devices()[1].name(), "name, 3");
+    ASSERT_EQ(
+        parsed->devices()[1].capabilities(), evlist::create_capabilities()
+    );
+}
+
+TEST(InputDevicesDiffTest, FromCsvReorderedColumns) {
+    auto parsed = evlist::InputDevices::from_csv(
+        "\"DEVICE_PATH\",\"NAME\"\n\"/dev/input/event3\",\"3\"\n"
+    );
+    ASSERT_TRUE(parsed.has_value());
+    ASSERT_EQ(parsed->devices().size(), 1);
+    ASSERT_EQ(parsed->devices()[0].name(), "3");
+    ASSERT_EQ(parsed->devices()[0].by_id(), std::nullopt);
+}
+
+TEST(InputDevicesDiffTest, FromCsvInvalid) {
+    ASSERT_FALSE(evlist::InputDevices::from_csv("").has_value());
+    ASSERT_FALSE(evlist::InputDevices::from_csv("\"NAME\"\n\"3\"\n").has_value()
+    );
+    ASSERT_FALSE(evlist::InputDevices::from_csv("\"DEVICE_PATH\"\n\"event3")
+                     .has_value());
+    ASSERT_FALSE(evlist::InputDevices::from_csv(
+                     "\"DEVICE_PATH\",\"NAME\"\n\"/dev/input/event3\"\n"
+    )
+                     .has_value());
+}
+
+TEST(InputDevicesDiffTest, Format) {
+    const evlist::InputDevices previous{
+        std::vector<evlist::InputDevice>{{"event1", "a", {}, {}, {}}}
+    };
+    const evlist::InputDevices current_table{
+        evlist::Format::TABLE, {{"event1", "b", {}, {}, {}}}
+    };
+    ASSERT_EQ(
+        std::format("{}", previous.diff(current_table)),
+        "CHANGE  DEVICE_PATH COLUMN PREVIOUS CURRENT\n"
+        "changed event1      NAME   a        b\n"
+    );
+
+    const evlist::InputDevices current_csv{
+        evlist::Format::CSV, {{"event2", "b", {}, {}, {}}}
+    };
+    ASSERT_EQ(
+        std::format("{}", previous.diff(current_csv)),
+        R"("CHANGE","DEVICE_PATH","COLUMN","PREVIOUS","CURRENT")"
+        "\n"
+        R"("removed","event1","","a","")"
+        "\n"
+        R"("added","event2","","","b")"
+        "\n"
+    );
+}
@@ -0,0 +1,108 @@
+#include "evlist/events.h"
+
+#include <fcntl.h>
+#include <gtest/gtest.h>
+#include <linux/input.h>
+#include <unistd.h>
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace {
+
+std::pair<evlist::FileDescriptor, evlist::FileDescriptor> create_pipe() {
+    std::array<int, 2> descriptors{};
+    EXPECT_EQ(pipe2(descriptors.data(), O_NONBLOCK | O_CLOEXEC), 0);
+    return {
+        evlist::FileDescriptor{descriptors[0]},
+        evlist::FileDescriptor{descriptors[1]}
+    };
+}
+
+void write_events(const evlist::FileDescriptor& pipe, std::size_t count) {
+    std::vector<input_event> events(count);
+    for (std::size_t i = 0; i < count; i++) {
+        events[i].type = EV_KEY;
+        events[i].code = static_cast<uint16_t>(i);
+    }
+    ASSERT_EQ(
+        write(pipe.get(), events.data(), events.size() * sizeof(input_event)),
+        events.size() * sizeof(input_event)
+    );
+}
+
+} // namespace
+
+TEST(EventPollerTest, PollMultipleDevices) {
+    auto [first_read, first_write] = create_pipe();
+    auto [second_read, second_write] = create_pipe();
+
+    std::vector<evlist::FileDescriptor> descriptors{};
+    descriptors.emplace_back(std::move(first_read));
+    descriptors.emplace_back(std::move(second_read));
+    auto poller = evlist::EventPoller::from_descriptors(std::move(descriptors));
+    ASSERT_TRUE(poller.has_value());
+    ASSERT_EQ(poller->size(), 2);
+
+    // More than one batch of events.
+    write_events(first_write, evlist::EventPoller::BATCH_SIZE + 3);
+    write_events(second_write, 2);
+
+    std::array<std::size_t, 2> counts{};
+    std::array<std::size_t, 2> batches{};
+    auto read = poller->poll(
+        std::chrono::milliseconds{1000},
+        [&counts, &batches](auto device, auto events) {
+            counts.at(device) += events.size();
+            batches.at(device)++;
+        }
+    );
+
+    ASSERT_TRUE(read.has_value());
+    ASSERT_EQ(*read, evlist::EventPoller::BATCH_SIZE + 5);
+    ASSERT_EQ(counts[0], evlist::EventPoller::BATCH_SIZE + 3);
+    ASSERT_EQ(counts[1], 2);
+    ASSERT_EQ(batches[0], 2);
+    ASSERT_EQ(batches[1], 1);
+}
+
+TEST(EventPollerTest, PollTimeout) {
+    auto [read_end, write_end] = create_pipe();
+
+    std::vector<evlist::FileDescriptor> descriptors{};
+    descriptors.emplace_back(std::move(read_end));
+    auto poller = evlist::EventPoller::from_descriptors(std::move(descriptors));
+    ASSERT_TRUE(poller.has_value());
+
+    auto read = poller->poll(std::chrono::milliseconds{1}, [](auto, auto) {
+        FAIL();
+    });
+    ASSERT_TRUE(read.has_value());
+    ASSERT_EQ(*read, 0);
+    ASSERT_FALSE(poller->closed());
+}
+
+TEST(EventPollerTest, PollClosed) {
+    auto [read_end, write_end] = create_pipe();
+
+    std::vector<evlist::FileDescriptor> descriptors{};
+    descriptors.emplace_back(std::move(read_end));
+    auto poller = evlist::EventPoller::from_descriptors(std::move(descriptors));
+    ASSERT_TRUE(poller.has_value());
+
+    write_events(write_end, 1);
+    write_end.close();
+
+    std::size_t count = 0;
+    while (!poller->closed()) {
+        auto read = poller->poll(
+            std::chrono::milliseconds{1000},
+            [&count](auto, auto events) { count += events.size(); }
+        );
+        ASSERT_TRUE(read.has_value());
+    }
+    ASSERT_EQ(count, 1);
+}
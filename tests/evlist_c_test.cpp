@@ -0,0 +1,122 @@
+#include "evlist/evlist_c.h"
+
+#include <gtest/gtest.h>
+#include <linux/input-event-codes.h>
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "common/common.h"
+#include "evlist/device.h"
+#include "evlist_c_internal.h"
+
+namespace {
+
+std::string_view string_at(
+    const evlist_devices* devices, const evlist_string& string
+) {
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    const auto* bytes = reinterpret_cast<const char*>(devices);
+    EXPECT_EQ(bytes[string.offset + string.length], '\0');
+    return {bytes + string.offset, string.length};
+}
+
+} // namespace
+
+TEST(EvlistCTest, PackDevices) {
+    const std::vector devices{
+        evlist::InputDevice{
+            "/dev/input/event3",
+            "keyboard",
+            {"by_id_3"},
+            {},
+            evlist::create_capabilities()
+        }
+            .with_parent(
+                {"input3", "046d", "c52b", "0003", "usb-0000:00:14.0-2", "S1"}
+            ),
+        evlist::InputDevice{
+            "/dev/input/event10", "<timed out>", {}, {"by_path_10"}, {}, true
+        }
+    };
+
+    auto* packed = evlist::pack_devices(devices);
+    ASSERT_NE(packed, nullptr);
+    ASSERT_EQ(packed->abi_version, EVLIST_ABI_VERSION);
+    ASSERT_EQ(packed->record_size, sizeof(evlist_device_record));
+    ASSERT_EQ(packed->count, 2);
+
+    const auto* first = evlist_device_at(packed, 0);
+    ASSERT_EQ(string_at(packed, first->device_path), "/dev/input/event3");
+    ASSERT_EQ(string_at(packed, first->name), "keyboard");
+    ASSERT_EQ(string_at(packed, first->by_id), "by_id_3");
+    ASSERT_EQ(string_at(packed, first->by_path), "");
+    ASSERT_EQ(first->flags, EVLIST_DEVICE_HAS_BY_ID);
+    ASSERT_EQ(string_at(packed, first->parent), "input3");
+    ASSERT_EQ(string_at(packed, first->vendor), "046d");
+    ASSERT_EQ(string_at(packed, first->product), "c52b");
+    ASSERT_EQ(string_at(packed, first->bus), "0003");
+    ASSERT_EQ(string_at(packed, first->phys), "usb-0000:00:14.0-2");
+    ASSERT_EQ(string_at(packed, first->uniq), "S1");
+
+    std::string capabilities{};
+    for (const auto& capability : evlist::create_capabilities()) {
+        capabilities += capabilities.empty() ? "" : ",";
+        capabilities += capability;
+    }
+    ASSERT_EQ(string_at(packed, first->capabilities), capabilities);
+    ASSERT_EQ(
+        first->capability_bits,
+        (1U << EV_SYN) | (1U << EV_KEY) | (1U << EV_REL) | (1U << EV_MSC)
+    );
+
+    const auto* second = evlist_device_at(packed, 1);
+    ASSERT_EQ(string_at(packed, second->device_path), "/dev/input/event10");
+    ASSERT_EQ(string_at(packed, second->by_path), "by_path_10");
+    ASSERT_EQ(string_at(packed, second->capabilities), "");
+    ASSERT_EQ(second->capability_bits, 0);
+    ASSERT_EQ(string_at(packed, second->parent), "");
+    ASSERT_EQ(
+        second->flags, EVLIST_DEVICE_HAS_BY_PATH | EVLIST_DEVICE_TIMED_OUT
+    );
+
+    ASSERT_EQ(
+        string_at(packed, second->uniq).end(),
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        reinterpret_cast<const char*>(packed) + packed->size - 1
+    );
+
+    evlist_free(packed);
+}
+
+TEST(EvlistCTest, ListDevices) {
+    const std::vector<evlist_filter> filters{
+        {EVLIST_COLUMN_NAME, "evlist-test-no-device-has-this-name"}
+    };
+
+    evlist_devices* devices = nullptr;
+    ASSERT_EQ(
+        evlist_list_devices(filters.data(), filters.size(), 0, &devices), 0
+    );
+    ASSERT_NE(devices, nullptr);
+    ASSERT_EQ(devices->count, 0);
+    ASSERT_EQ(devices->size, sizeof(evlist_devices));
+    evlist_free(devices);
+}
+
+TEST(EvlistCTest, ListDevicesInvalid) {
+    evlist_devices* devices = nullptr;
+    const std::vector<evlist_filter> invalid_column{{11, "a"}};
+    ASSERT_EQ(
+        evlist_list_devices(invalid_column.data(), 1, 0, &devices), EINVAL
+    );
+    ASSERT_EQ(devices, nullptr);
+
+    ASSERT_EQ(evlist_list_devices(nullptr, 1, 0, &devices), EINVAL);
+    ASSERT_EQ(evlist_list_devices(nullptr, 0, 0, nullptr), EINVAL);
+    evlist_free(nullptr);
+}
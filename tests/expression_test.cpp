@@ -0,0 +1,106 @@
+#include "evlist/expression.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "evlist/device.h"
+
+namespace {
+
+bool matches(const std::string& expression, const evlist::InputDevice& device) {
+    return evlist::FilterExpression::parse(expression).value().matches(device);
+}
+
+} // namespace
+
+TEST(FilterExpressionTest, Matches) {
+    const evlist::InputDevice keyboard{
+        "/dev/input/event3",
+        "Logitech USB Receiver",
+        "usb-Logitech-event-kbd",
+        {},
+        {"EV_SYN", "EV_KEY"}
+    };
+    const evlist::InputDevice tablet{
+        "/dev/input/event4",
+        "Wacom Tablet",
+        {},
+        {},
+        {"EV_SYN", "EV_KEY", "EV_ABS"}
+    };
+
+    auto expression =
+        R"((name~"Logitech" or by_id~"kbd") and not capabilities=EV_ABS)";
+    ASSERT_TRUE(matches(expression, keyboard));
+    ASSERT_FALSE(matches(expression, tablet));
+
+    ASSERT_TRUE(matches("name=Wacom or capabilities=EV_ABS", tablet));
+    ASSERT_TRUE(matches(R"(name="Wacom Tablet")", tablet));
+    ASSERT_TRUE(matches("not not NAME~^Wacom", tablet));
+    ASSERT_FALSE(matches("by_id~kbd", tablet));
+    ASSERT_TRUE(matches("by_id=\"\"", tablet));
+
+    // The operators of `--filter` are not regex searches.
+    ASSERT_FALSE(matches("name~=wacom", tablet));
+    ASSERT_TRUE(matches(R"(name~="WACOM TABLET")", tablet));
+    ASSERT_TRUE(matches("name*=Tab and name^=Wac", tablet));
+    ASSERT_FALSE(matches("name^=Tab or name*=wacom", tablet));
+    ASSERT_FALSE(matches("name~=.*", tablet));
+
+    // `and` binds tighter than `or`.
+    ASSERT_TRUE(matches("name=x and name=y or capabilities=EV_KEY", tablet));
+    ASSERT_FALSE(matches("name=x and (name=y or capabilities=EV_KEY)", tablet));
+}
+
+TEST(FilterExpressionTest, MemoisedRegex) {
+    const evlist::InputDevice keyboard{
+        "/dev/input/event3", "keyboard", {}, {}, {"EV_SYN", "EV_KEY"}
+    };
+    const evlist::InputDevice tablet{
+        "/dev/input/event4", "tablet", {}, {}, {"EV_SYN", "EV_KEY", "EV_ABS"}
+    };
+
+    auto expression =
+        evlist::FilterExpression::parse("capabilities~^EV_A").value();
+    auto memos = expression.memos();
+    ASSERT_FALSE(expression.matches(keyboard, memos));
+    ASSERT_TRUE(expression.matches(tablet, memos));
+    ASSERT_EQ(memos.front().size(), 3);
+
+    // Repeated values are answered by the memo rather than the regex.
+    memos.front()("EV_REL", [](std::string_view) { return true; });
+    const evlist::InputDevice mouse{
+        "/dev/input/event5", "mouse", {}, {}, {"EV_SYN", "EV_REL"}
+    };
+    ASSERT_TRUE(expression.matches(mouse, memos));
+    ASSERT_FALSE(expression.matches(mouse));
+}
+
+TEST(FilterExpressionTest, Compile) {
+    // Jumps are emitted between operands and shared comparisons are reused.
+    auto expression =
+        evlist::FilterExpression::parse("name=a or name=b and not name=a");
+    ASSERT_TRUE(expression.has_value());
+    ASSERT_EQ(expression->size(), 6);
+}
+
+TEST(FilterExpressionTest, ParseErrors) {
+    for (const auto* expression :
+         {"",
+          "name",
+          "name=",
+          "unknown=a",
+          "(name=a",
+          "name=a name=b",
+          "name=\"a",
+          "name~[",
+          "name*",
+          "name^~a",
+          "name=a and"}) {
+        ASSERT_FALSE(evlist::FilterExpression::parse(expression).has_value())
+            << expression;
+    }
+}
@@ -0,0 +1,93 @@
+#include "evlist/format.h"
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "evlist/cli.h"
+
+namespace {
+
+using Rows = std::vector<std::array<std::string, 2>>;
+
+struct Context {
+    std::string* output;
+
+    [[nodiscard]] auto out() const { return std::back_inserter(*output); }
+};
+
+std::string format(evlist::Format output_format, const Rows& rows) {
+    std::string output{};
+    Context ctx{&output};
+    evlist::format_rows(ctx, output_format, rows);
+    return output;
+}
+
+const Rows ROWS{
+    {"NAME", "VALUE"},
+    {"a", "plain"},
+    {"b\"", "tab\tnew\nline\\"},
+};
+
+} // namespace
+
+TEST(FormatTest, Table) {
+    ASSERT_EQ(
+        format(evlist::Format::TABLE, {{"NAME", "VALUE"}, {"name", "value"}}),
+        "NAME VALUE\n"
+        "name value\n"
+    );
+}
+
+TEST(FormatTest, Csv) {
+    ASSERT_EQ(
+        format(evlist::Format::CSV, ROWS),
+        R"("NAME","VALUE")"
+        "\n"
+        R"("a","plain")"
+        "\n"
+        "\"b\"\"\",\"tab\tnew\nline\\\"\n"
+    );
+}
+
+TEST(FormatTest, Tsv) {
+    ASSERT_EQ(
+        format(evlist::Format::TSV, ROWS),
+        "NAME\tVALUE\n"
+        "a\tplain\n"
+        "b\"\ttab\\tnew\\nline\\\\\n"
+    );
+}
+
+TEST(FormatTest, Json) {
+    ASSERT_EQ(
+        format(evlist::Format::JSON, ROWS),
+        "[\n"
+        R"({"NAME":"a","VALUE":"plain"},)"
+        "\n"
+        R"({"NAME":"b\"","VALUE":"tab\tnew\nline\\"})"
+        "\n]\n"
+    );
+    ASSERT_EQ(format(evlist::Format::JSON, {{"NAME", "VALUE"}}), "[\n]\n");
+}
+
+TEST(FormatTest, JsonControlCharacters) {
+    ASSERT_EQ(
+        format(evlist::Format::NDJSON, {{"NAME", "VALUE"}, {"\x01", "\x1f"}}),
+        R"({"NAME":"\u0001","VALUE":"\u001f"})"
+        "\n"
+    );
+}
+
+TEST(FormatTest, Ndjson) {
+    ASSERT_EQ(
+        format(evlist::Format::NDJSON, ROWS),
+        R"({"NAME":"a","VALUE":"plain"})"
+        "\n"
+        R"({"NAME":"b\"","VALUE":"tab\tnew\nline\\"})"
+        "\n"
+    );
+}
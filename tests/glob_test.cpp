@@ -0,0 +1,123 @@
+#include "evlist/glob.h"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "common/common.h"
+#include "evlist/cli.h"
+#include "evlist/device.h"
+
+TEST(GlobTest, Literal) {
+    const evlist::Glob glob{"event1"};
+    ASSERT_EQ(glob.literal(), "event1");
+    ASSERT_TRUE(glob.matches("event1"));
+    ASSERT_FALSE(glob.matches("event10"));
+    ASSERT_FALSE(glob.matches("event"));
+
+    ASSERT_TRUE(evlist::Glob{""}.matches(""));
+    ASSERT_FALSE(evlist::Glob{""}.matches("a"));
+    ASSERT_FALSE(evlist::Glob{"event*"}.literal().has_value());
+    ASSERT_EQ(evlist::Glob{R"(event\*)"}.literal(), "event*");
+}
+
+TEST(GlobTest, Wildcards) {
+    const evlist::Glob star{"usb-*-kbd"};
+    ASSERT_TRUE(star.matches("usb-Logitech-kbd"));
+    ASSERT_TRUE(star.matches("usb--kbd"));
+    ASSERT_FALSE(star.matches("usb-kbd"));
+    ASSERT_FALSE(star.matches("usb-Logitech-kbd-1"));
+
+    const evlist::Glob question{"event1?"};
+    ASSERT_TRUE(question.matches("event10"));
+    ASSERT_FALSE(question.matches("event1"));
+    ASSERT_FALSE(question.matches("event100"));
+
+    const evlist::Glob middle{"*a?c*a?c*"};
+    ASSERT_TRUE(middle.matches("abcabc"));
+    ASSERT_TRUE(middle.matches("xxabcyyaxc"));
+    ASSERT_FALSE(middle.matches("abc"));
+    ASSERT_FALSE(middle.matches("abcab"));
+
+    // The suffix must not overlap the middle segments.
+    ASSERT_FALSE(evlist::Glob{"*ab*ba"}.matches("aba"));
+    ASSERT_TRUE(evlist::Glob{"**"}.matches(""));
+    ASSERT_TRUE(evlist::Glob{"a**b"}.matches("ab"));
+}
+
+TEST(GlobTest, Classes) {
+    const evlist::Glob range{"event[0-3]"};
+    ASSERT_TRUE(range.matches("event0"));
+    ASSERT_TRUE(range.matches("event3"));
+    ASSERT_FALSE(range.matches("event4"));
+
+    const evlist::Glob negated{"event[!0-3]"};
+    ASSERT_FALSE(negated.matches("event0"));
+    ASSERT_TRUE(negated.matches("event4"));
+    ASSERT_TRUE(evlist::Glob{"event[^a]"}.matches("eventb"));
+
+    ASSERT_TRUE(evlist::Glob{"[]a]"}.matches("]"));
+    ASSERT_TRUE(evlist::Glob{"[a-]"}.matches("-"));
+
+    // An unterminated class matches itself.
+    ASSERT_TRUE(evlist::Glob{"event[0"}.matches("event[0"));
+}
+
+TEST(GlobTest, Escapes) {
+    ASSERT_TRUE(evlist::Glob{R"(a\*b)"}.matches("a*b"));
+    ASSERT_FALSE(evlist::Glob{R"(a\*b)"}.matches("axb"));
+    ASSERT_TRUE(evlist::Glob{R"(a\?)"}.matches("a?"));
+    ASSERT_TRUE(evlist::Glob{R"([\]])"}.matches("]"));
+    ASSERT_TRUE(evlist::Glob{R"(a\)"}.matches(R"(a\)"));
+}
+
+TEST(GlobTest, FilterDevices) {
+    const evlist::InputDevice first{
+        "/dev/input/event3",
+        "3",
+        {"by_id_3"},
+        {"by_path_3"},
+        evlist::create_capabilities()
+    };
+    const evlist::InputDevice second{
+        "/dev/input/event10",
+        "10",
+        {"by_id_10"},
+        {"by_path_10"},
+        evlist::create_capabilities()
+    };
+    const evlist::InputDevice third{
+        "/dev/input/event11",
+        "11",
+        {"usb_by_id_2_10"},
+        {"by_path_2_10"},
+        evlist::create_capabilities()
+    };
+
+    auto by_id = evlist::InputDevices{std::vector{first, second, third}};
+    by_id.filter({{evlist::Filter::BY_ID, "by_id_*"}}, false, true);
+    ASSERT_EQ(by_id.devices().size(), 2);
+
+    auto path = evlist::InputDevices{std::vector{first, second, third}};
+    path.filter(
+        {{evlist::Filter::DEVICE_PATH, "/dev/input/event1[01]"}}, false, true
+    );
+    ASSERT_EQ(path.devices().size(), 2);
+    ASSERT_EQ(path.devices()[0], second);
+
+    auto name = evlist::InputDevices{std::vector{first, second, third}};
+    name.filter({{evlist::Filter::NAME, "?"}}, false, true);
+    ASSERT_EQ(name.devices().size(), 1);
+    ASSERT_EQ(name.devices()[0], first);
+
+    // Globs without wildcards are compared for equality once unescaped.
+    auto literal = evlist::InputDevices{std::vector{first, second, third}};
+    literal.filter({{evlist::Filter::NAME, R"(1\0)"}}, false, true);
+    ASSERT_EQ(literal.devices().size(), 1);
+    ASSERT_EQ(literal.devices()[0], second);
+
+    // Regex takes precedence over a glob.
+    auto regex = evlist::InputDevices{std::vector{first, second, third}};
+    regex.filter({{evlist::Filter::NAME, "^.$"}}, true, true);
+    ASSERT_EQ(regex.devices().size(), 1);
+}
@@ -0,0 +1,100 @@
+#include "evlist/group.h"
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <format>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "evlist/cli.h"
+#include "evlist/device.h"
+
+namespace {
+
+using Counts = std::vector<std::pair<std::string_view, std::size_t>>;
+
+std::vector<evlist::InputDevice> create_devices() {
+    std::vector<evlist::InputDevice> devices{};
+    devices.emplace_back(
+        "/dev/input/event0",
+        "keyboard",
+        std::nullopt,
+        "/dev/input/by-path/platform-i8042-serio-0-event-kbd",
+        std::vector<std::string>{"EV_SYN", "EV_KEY"}
+    );
+    devices.emplace_back(
+        "/dev/input/event1",
+        "mouse",
+        "/dev/input/by-id/usb-mouse-event-mouse",
+        "/dev/input/by-path/pci-0000:00:14.0-usb-0:1:1.0-event-mouse",
+        std::vector<std::string>{"EV_SYN", "EV_KEY", "EV_REL"}
+    );
+    devices.emplace_back(
+        "/dev/input/event2",
+        "keyboard",
+        std::nullopt,
+        "/dev/input/by-path/pci-0000:00:14.0-usb-0:2:1.0-event-kbd",
+        std::vector<std::string>{"EV_SYN", "EV_KEY"}
+    );
+    return devices;
+}
+
+evlist::DeviceGroups group(
+    evlist::Format output_format, evlist::Filter column
+) {
+    evlist::DeviceGroups groups{output_format, column};
+    for (const auto& device : create_devices()) {
+        groups.add(device);
+    }
+    return groups;
+}
+
+} // namespace
+
+TEST(DeviceGroupsTest, Name) {
+    ASSERT_EQ(
+        group(evlist::Format::TABLE, evlist::Filter::NAME).counts(),
+        (Counts{{"keyboard", 2}, {"mouse", 1}})
+    );
+}
+
+TEST(DeviceGroupsTest, Capabilities) {
+    ASSERT_EQ(
+        group(evlist::Format::TABLE, evlist::Filter::CAPABILITIES).counts(),
+        (Counts{{"EV_KEY", 3}, {"EV_SYN", 3}, {"EV_REL", 1}})
+    );
+}
+
+TEST(DeviceGroupsTest, ByPathBus) {
+    ASSERT_EQ(
+        group(evlist::Format::TABLE, evlist::Filter::BY_PATH).counts(),
+        (Counts{{"pci", 2}, {"platform", 1}})
+    );
+}
+
+TEST(DeviceGroupsTest, MissingValues) {
+    // Devices without a value are counted in an empty group.
+    ASSERT_EQ(
+        group(evlist::Format::TABLE, evlist::Filter::BY_ID).counts(),
+        (Counts{{"", 2}, {"/dev/input/by-id/usb-mouse-event-mouse", 1}})
+    );
+}
+
+TEST(DeviceGroupsTest, Format) {
+    ASSERT_EQ(
+        std::format("{}", group(evlist::Format::TABLE, evlist::Filter::NAME)),
+        "NAME     COUNT\n"
+        "keyboard 2\n"
+        "mouse    1\n"
+    );
+    ASSERT_EQ(
+        std::format("{}", group(evlist::Format::CSV, evlist::Filter::BY_PATH)),
+        "\"BY_PATH\",\"COUNT\"\n"
+        "\"pci\",\"2\"\n"
+        "\"platform\",\"1\"\n"
+    );
+}
@@ -0,0 +1,217 @@
+#include "evlist/hotplug.h"
+
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <deque>
+#include <expected>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include "evlist/cli.h"
+#include "evlist/list.h"
+
+namespace {
+
+namespace fs = std::filesystem;
+
+using namespace std::string_view_literals;
+
+/**
+ * A source of synthetic uevents which never waits, where an empty message
+ * reports that uevents were dropped.
+ */
+class FakeUeventSource final : public evlist::UeventSource {
+public:
+    explicit FakeUeventSource(std::deque<std::string> messages)
+        : messages_{std::move(messages)} {}
+
+    std::expected<std::size_t, std::system_error> receive(
+        std::span<char> buffer, std::chrono::milliseconds /*timeout*/
+    ) override {
+        if (messages_.empty()) {
+            return 0;
+        }
+
+        auto message = std::move(messages_.front());
+        messages_.pop_front();
+        if (message.empty()) {
+            return std::unexpected{std::system_error{
+                std::make_error_code(std::errc::no_buffer_space)
+            }};
+        }
+        auto size = std::min(message.size(), buffer.size());
+        std::copy_n(message.begin(), size, buffer.begin());
+        return size;
+    }
+
+private:
+    std::deque<std::string> messages_;
+};
+
+std::string uevent(
+    std::string_view action,
+    std::string_view devpath,
+    std::string_view subsystem,
+    std::string_view devname
+) {
+    auto message = std::format(
+        "{0}@{1}\0ACTION={0}\0DEVPATH={1}\0SUBSYSTEM={2}\0SEQNUM=1\0"sv,
+        action,
+        devpath,
+        subsystem
+    );
+    if (!devname.empty()) {
+        message += std::format("DEVNAME={}", devname);
+        message.push_back('\0');
+    }
+    return message;
+}
+
+} // namespace
+
+TEST(UeventTest, Parse) {
+    auto message = uevent(
+        "add",
+        "/devices/platform/i8042/serio0/input/input3/event5",
+        "input",
+        "input/event5"
+    );
+    auto parsed = evlist::Uevent::parse(message);
+    ASSERT_TRUE(parsed.has_value());
+    ASSERT_EQ(parsed->action, evlist::UeventAction::ADD);
+    ASSERT_EQ(
+        parsed->devpath, "/devices/platform/i8042/serio0/input/input3/event5"
+    );
+    ASSERT_EQ(parsed->subsystem, "input");
+    ASSERT_EQ(parsed->devname, "input/event5");
+    ASSERT_EQ(parsed->event_device(), "event5");
+
+    // The fields point into the message rather than copying it.
+    ASSERT_GE(parsed->devname.data(), message.data());
+    ASSERT_LT(parsed->devname.data(), message.data() + message.size());
+}
+
+TEST(UeventTest, ParseIgnored) {
+    ASSERT_FALSE(evlist::Uevent::parse("libudev\0\xfe\xed"sv).has_value());
+    ASSERT_FALSE(evlist::Uevent::parse(
+                     uevent("bind", "/devices/usb1", "usb", "")
+    )
+                     .has_value());
+    ASSERT_FALSE(evlist::Uevent::parse(""sv).has_value());
+
+    // Parent input devices and other subsystems have no event device.
+    auto parent = evlist::Uevent::parse(
+        uevent("add", "/devices/input/input3", "input", "")
+    );
+    ASSERT_TRUE(parent.has_value());
+    ASSERT_FALSE(parent->event_device().has_value());
+
+    auto mouse = evlist::Uevent::parse(
+        uevent("add", "/devices/input/input3/mouse0", "input", "input/mouse0")
+    );
+    ASSERT_FALSE(mouse->event_device().has_value());
+
+    auto block = evlist::Uevent::parse(
+        uevent("add", "/devices/block/sda", "block", "sda")
+    );
+    ASSERT_FALSE(block->event_device().has_value());
+}
+
+TEST(HotplugListenerTest, ProbeAffectedDevices) {
+    const auto root = fs::temp_directory_path() /
+                      std::format("evlist_{}_hotplug", getpid());
+    fs::create_directories(root / "input");
+    for (const auto* device : {"event1", "event2"}) {
+        fs::create_directories(root / "sys" / device / "device");
+        fs::create_symlink("/dev/null", root / "input" / device);
+    }
+    std::ofstream{root / "sys/event1/device/name"} << "keyboard\n";
+    std::ofstream{root / "sys/event2/device/name"} << "mouse\n";
+
+    std::deque<std::string> messages{
+        uevent("add", "/devices/input/input1", "input", ""),
+        uevent("add", "/devices/input/input1/event1", "input", "input/event1"),
+        uevent("add", "/devices/block/sda", "block", "sda"),
+        uevent("add", "/devices/input/input2/event2", "input", "input/event2"),
+        uevent(
+            "remove", "/devices/input/input1/event1", "input", "input/event1"
+        ),
+    };
+    evlist::HotplugListener listener{
+        std::make_unique<FakeUeventSource>(std::move(messages)),
+        evlist::InputDeviceLister{
+            evlist::Format::TABLE, false, {{evlist::Filter::NAME, "keyboard"}}
+        }
+            .with_input_directory(root / "input")
+            .with_sys_class(root / "sys")
+    };
+
+    std::vector<std::pair<evlist::UeventAction, std::string>> events{};
+    std::vector<std::string> names{};
+    auto polled = listener.poll(
+        std::chrono::milliseconds{0},
+        [&events, &names](const evlist::HotplugEvent& event) {
+            events.emplace_back(event.action, event.name);
+            if (event.device.has_value()) {
+                names.emplace_back(event.device->name());
+                ASSERT_EQ(
+                    event.device->device_path().filename(), event.name
+                );
+            }
+        }
+    );
+
+    ASSERT_TRUE(polled.has_value());
+    ASSERT_EQ(*polled, 3);
+    ASSERT_EQ(
+        events,
+        (std::vector<std::pair<evlist::UeventAction, std::string>>{
+            {evlist::UeventAction::ADD, "event1"},
+            {evlist::UeventAction::ADD, "event2"},
+            {evlist::UeventAction::REMOVE, "event1"},
+        })
+    );
+    // The mouse does not match the filter, so it is not returned.
+    ASSERT_EQ(names, std::vector<std::string>{"keyboard"});
+
+    fs::remove_all(root);
+}
+
+TEST(HotplugListenerTest, DroppedEvents) {
+    std::deque<std::string> messages{
+        "",
+        uevent(
+            "remove", "/devices/input/input1/event1", "input", "input/event1"
+        ),
+    };
+    evlist::HotplugListener listener{
+        std::make_unique<FakeUeventSource>(std::move(messages)),
+        evlist::InputDeviceLister{}
+    };
+
+    // Dropped events are reported, and later events are still received.
+    std::vector<std::string> names{};
+    auto on_event = [&names](const evlist::HotplugEvent& event) {
+        names.emplace_back(event.name);
+    };
+    auto dropped = listener.poll(std::chrono::milliseconds{0}, on_event);
+    ASSERT_FALSE(dropped.has_value());
+    ASSERT_EQ(
+        dropped.error().code(),
+        std::make_error_code(std::errc::no_buffer_space)
+    );
+    ASSERT_EQ(listener.poll(std::chrono::milliseconds{0}, on_event), 1);
+    ASSERT_EQ(names, std::vector<std::string>{"event1"});
+}
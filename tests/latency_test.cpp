@@ -0,0 +1,87 @@
+#include "evlist/latency.h"
+
+#include <gtest/gtest.h>
+#include <linux/input.h>
+
+#include <chrono>
+#include <cstdint>
+#include <format>
+#include <limits>
+#include <vector>
+
+#include "evlist/cli.h"
+#include "evlist/device.h"
+
+TEST(LatencyHistogramTest, Buckets) {
+    for (uint64_t value = 0; value < 64; value++) {
+        ASSERT_EQ(evlist::LatencyHistogram::bucket(value), value);
+        ASSERT_EQ(evlist::LatencyHistogram::highest(value), value);
+    }
+
+    ASSERT_EQ(evlist::LatencyHistogram::bucket(64), 64);
+    ASSERT_EQ(evlist::LatencyHistogram::bucket(65), 64);
+    ASSERT_EQ(evlist::LatencyHistogram::highest(64), 65);
+    ASSERT_EQ(
+        evlist::LatencyHistogram::bucket(std::numeric_limits<uint64_t>::max()),
+        evlist::LatencyHistogram::BUCKETS - 1
+    );
+
+    // Every value is within the relative error of its bucket.
+    for (uint64_t value = 1; value < std::numeric_limits<uint64_t>::max() / 3;
+         value = value * 3 + 1) {
+        auto highest = evlist::LatencyHistogram::highest(
+            evlist::LatencyHistogram::bucket(value)
+        );
+        ASSERT_GE(highest, value);
+        ASSERT_LE(
+            highest - value, value / evlist::LatencyHistogram::SUB_BUCKETS
+        );
+    }
+}
+
+TEST(LatencyHistogramTest, Percentile) {
+    evlist::LatencyHistogram histogram{};
+    ASSERT_EQ(histogram.percentile(50), 0);
+
+    for (uint64_t value = 1; value <= 1000; value++) {
+        histogram.record(value);
+    }
+    ASSERT_EQ(histogram.count(), 1000);
+    ASSERT_EQ(histogram.max(), 1000);
+    ASSERT_NEAR(histogram.percentile(50), 500, 500 / 32);
+    ASSERT_NEAR(histogram.percentile(99), 990, 990 / 32);
+    ASSERT_EQ(histogram.percentile(100), 1000);
+    ASSERT_EQ(histogram.percentile(0), 1);
+
+    histogram.reset();
+    ASSERT_EQ(histogram.count(), 0);
+    ASSERT_EQ(histogram.max(), 0);
+}
+
+TEST(DeviceLatenciesTest, Record) {
+    evlist::DeviceLatencies latencies{
+        evlist::Format::TABLE,
+        {evlist::InputDevice{"/dev/input/event3", "3", {}, {}, {}}}
+    };
+
+    std::vector<input_event> events(3);
+    events[0].input_event_sec = 10;
+    events[0].input_event_usec = 0;
+    events[1].input_event_sec = 10;
+    events[1].input_event_usec = 999'990;
+    events[2].input_event_sec = 11;
+    events[2].input_event_usec = 500;
+    latencies.record(0, events, std::chrono::microseconds{11'000'000});
+
+    const auto& histogram = latencies.histogram(0);
+    ASSERT_EQ(histogram.count(), 3);
+    ASSERT_EQ(histogram.max(), 1'000'000);
+    ASSERT_EQ(histogram.percentile(50), 10);
+    ASSERT_EQ(histogram.percentile(0), 0);
+
+    ASSERT_EQ(
+        std::format("{}", latencies),
+        "DEVICE_PATH       NAME EVENTS P50_US P99_US  P999_US MAX_US\n"
+        "/dev/input/event3 3    3      10     1000000 1000000 1000000\n"
+    );
+}
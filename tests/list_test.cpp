@@ -1,10 +1,20 @@
 #include "evlist/list.h"
 
+#include <fcntl.h>
 #include <gtest/gtest.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 #include <algorithm>
+#include <chrono>
+#include <cstddef>
 #include <filesystem>
+#include <format>
+#include <fstream>
+#include <future>
 #include <string>
+#include <thread>
+#include <utility>
 #include <vector>
 
 #include "common/common.h"
@@ -12,7 +22,99 @@
 
 namespace fs = std::filesystem;
 
-TEST(InputDeviceListerTest, ElevatedContainsAllDevices) {
+namespace {
+
+/**
+ * Creates a fake `/dev/input` and `/sys/class/input` tree in a temporary
+ * directory for each test, which is removed even if the test fails. Device
+ * nodes are stood in for by links to `/dev/null`.
+ */
+class InputDeviceListerTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        const auto* test =
+            ::testing::UnitTest::GetInstance()->current_test_info();
+        root_ = fs::temp_directory_path() /
+                std::format("evlist_{}_{}", getpid(), test->name());
+        fs::create_directories(root_ / "input");
+    }
+
+    void TearDown() override {
+        // Unblock probes which are still reading a slow name.
+        for (const auto& fifo : fifos_) {
+            auto writer = open(fifo.c_str(), O_WRONLY | O_NONBLOCK | O_CLOEXEC);
+            if (writer >= 0) {
+                close(writer);
+            }
+        }
+        fs::remove_all(root_);
+    }
+
+    /**
+     * Add an event device with a name.
+     */
+    void add_device(const std::string& device, const std::string& name) {
+        add_node(device);
+        std::ofstream{root_ / "sys" / device / "device/name"} << name << '\n';
+    }
+
+    /**
+     * Add an event device whose name is a FIFO without a writer, so reading
+     * it blocks until the test ends.
+     */
+    void add_slow_device(const std::string& device) {
+        add_node(device);
+        auto fifo = root_ / "sys" / device / "device/name";
+        ASSERT_EQ(mkfifo(fifo.c_str(), S_IRUSR | S_IWUSR), 0);
+        fifos_.emplace_back(std::move(fifo));
+    }
+
+    /**
+     * Create a lister of the fake tree.
+     */
+    [[nodiscard]] evlist::InputDeviceLister lister(
+        std::vector<evlist::FilterTerm> filter = {}
+    ) const {
+        return evlist::InputDeviceLister{
+            evlist::Format::TABLE, false, std::move(filter)
+        }
+            .with_input_directory(root_ / "input")
+            .with_sys_class(root_ / "sys");
+    }
+
+    [[nodiscard]] const fs::path& root() const { return root_; }
+
+    /**
+     * Count the slow devices whose name a probe has started reading, which
+     * also unblocks those probes.
+     */
+    [[nodiscard]] std::size_t probed_slow_devices() const {
+        // Opening a FIFO to write without blocking only succeeds if it has a
+        // reader.
+        std::size_t probed = 0;
+        for (const auto& fifo : fifos_) {
+            auto writer = open(fifo.c_str(), O_WRONLY | O_NONBLOCK | O_CLOEXEC);
+            if (writer >= 0) {
+                close(writer);
+                probed++;
+            }
+        }
+        return probed;
+    }
+
+private:
+    fs::path root_;
+    std::vector<fs::path> fifos_;
+
+    void add_node(const std::string& device) {
+        fs::create_directories(root_ / "sys" / device / "device");
+        fs::create_symlink("/dev/null", root_ / "input" / device);
+    }
+};
+
+} // namespace
+
+TEST_F(InputDeviceListerTest, ElevatedContainsAllDevices) {
     const evlist::InputDevices devices =
         evlist::InputDeviceLister{}.list_input_devices().value();
 
@@ -44,10 +146,238 @@ TEST(InputDeviceListerTest, ElevatedContainsAllDevices) {
     );
 }
 
-TEST(InputDeviceListerTest, ElevatedContainsAllIdSymlinks) {
+TEST_F(InputDeviceListerTest, ElevatedContainsAllIdSymlinks) {
     evlist::check_devices([](auto& device) { return device.by_id(); });
 }
 
-TEST(InputDeviceListerTest, ElevatedContainsAllPathSymlinks) {
+TEST_F(InputDeviceListerTest, ElevatedContainsAllPathSymlinks) {
     evlist::check_devices([](auto& device) { return device.by_path(); });
 }
+
+TEST_F(InputDeviceListerTest, DeadlineSlowDevice) {
+    add_device("event0", "fast");
+    ASSERT_NO_FATAL_FAILURE(add_slow_device("event1"));
+
+    auto start = std::chrono::steady_clock::now();
+    auto devices = lister()
+                       .with_deadline(std::chrono::milliseconds{100})
+                       .list_input_devices()
+                       .value()
+                       .devices();
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    ASSERT_LT(elapsed, std::chrono::seconds{1});
+    ASSERT_EQ(devices.size(), 2);
+    ASSERT_EQ(devices[0].name(), "fast");
+    ASSERT_FALSE(devices[0].timed_out());
+    ASSERT_EQ(devices[1].device_path(), root() / "input/event1");
+    ASSERT_EQ(devices[1].name(), evlist::InputDeviceLister::TIMED_OUT_NAME);
+    ASSERT_TRUE(devices[1].timed_out());
+}
+
+TEST_F(InputDeviceListerTest, Limit) {
+    // Listing only finishes quickly if `event10` is never waited on.
+    add_device("event1", "a");
+    add_device("event2", "b");
+    ASSERT_NO_FATAL_FAILURE(add_slow_device("event10"));
+
+    auto list = [this](
+                    std::size_t limit,
+                    std::vector<evlist::FilterTerm> filter
+                ) {
+        return lister(std::move(filter))
+            .with_probe_deadline(std::chrono::milliseconds{100})
+            .with_limit(limit)
+            .list_input_devices()
+            .value()
+            .devices();
+    };
+
+    auto start = std::chrono::steady_clock::now();
+    auto devices = list(2, {});
+    ASSERT_LT(std::chrono::steady_clock::now() - start,
+              std::chrono::milliseconds{100});
+    ASSERT_EQ(devices.size(), 2);
+    ASSERT_EQ(devices[0].name(), "a");
+    ASSERT_EQ(devices[1].name(), "b");
+
+    devices = list(1, {{evlist::Filter::NAME, "b"}});
+    ASSERT_EQ(devices.size(), 1);
+    ASSERT_EQ(devices[0].device_path(), root() / "input/event2");
+
+    devices = list(4, {});
+    ASSERT_EQ(devices.size(), 3);
+    ASSERT_EQ(devices[2].device_path(), root() / "input/event10");
+    ASSERT_TRUE(devices[2].timed_out());
+}
+
+TEST_F(InputDeviceListerTest, LimitAcrossBatches) {
+    // Only the last devices match, so they are found in a later batch.
+    constexpr auto DEVICES = evlist::InputDeviceLister::MAX_PROBE_THREADS * 3;
+    for (std::size_t i = 0; i < DEVICES; i++) {
+        add_device(
+            std::format("event{}", i), i + 3 >= DEVICES ? "match" : "other"
+        );
+    }
+
+    auto devices = lister({{evlist::Filter::NAME, "match"}})
+                       .with_limit(2)
+                       .list_input_devices()
+                       .value()
+                       .devices();
+
+    ASSERT_EQ(devices.size(), 2);
+    ASSERT_EQ(
+        devices[0].device_path(),
+        root() / "input" / std::format("event{}", DEVICES - 3)
+    );
+    ASSERT_EQ(
+        devices[1].device_path(),
+        root() / "input" / std::format("event{}", DEVICES - 2)
+    );
+}
+
+TEST_F(InputDeviceListerTest, LimitProbesFewDevices) {
+    // The first device matches, so the later devices are never probed.
+    add_device("event0", "match");
+    for (std::size_t i = 1; i <= evlist::InputDeviceLister::MAX_PROBE_THREADS;
+         i++) {
+        ASSERT_NO_FATAL_FAILURE(add_slow_device(std::format("event{}", i)));
+    }
+
+    auto devices =
+        lister().with_limit(1).list_input_devices().value().devices();
+    ASSERT_EQ(devices.size(), 1);
+    ASSERT_EQ(devices[0].name(), "match");
+
+    // Give any probes which were started time to reach the name.
+    std::this_thread::sleep_for(std::chrono::milliseconds{100});
+    ASSERT_EQ(probed_slow_devices(), 0);
+}
+
+TEST_F(InputDeviceListerTest, MoreDevicesThanProbeThreads) {
+    // Devices beyond the number of probe threads are queued rather than
+    // timing out, including in listings that run at the same time.
+    constexpr auto DEVICES = evlist::InputDeviceLister::MAX_PROBE_THREADS * 3;
+    for (std::size_t i = 0; i < DEVICES; i++) {
+        add_device(std::format("event{}", i), std::format("device{}", i));
+    }
+
+    auto concurrent = std::async(std::launch::async, [this] {
+        return lister().list_input_devices().value().devices();
+    });
+    auto devices = lister().list_input_devices().value().devices();
+
+    ASSERT_EQ(devices.size(), DEVICES);
+    ASSERT_EQ(concurrent.get().size(), DEVICES);
+    for (std::size_t i = 0; i < DEVICES; i++) {
+        ASSERT_EQ(devices[i].name(), std::format("device{}", i));
+        ASSERT_FALSE(devices[i].timed_out());
+    }
+}
+
+TEST_F(InputDeviceListerTest, StreamBeforeSlowDevice) {
+    // The devices before `event1` are streamed immediately and the devices
+    // after it once it times out.
+    add_device("event0", "a");
+    ASSERT_NO_FATAL_FAILURE(add_slow_device("event1"));
+    add_device("event2", "b");
+    add_device("event10", "c");
+
+    auto lister = this->lister().with_probe_deadline(
+        std::chrono::milliseconds{500}
+    );
+
+    auto start = std::chrono::steady_clock::now();
+    auto stream = lister.stream_input_devices();
+    auto first = stream.next().value();
+    ASSERT_LT(std::chrono::steady_clock::now() - start,
+              std::chrono::milliseconds{500});
+    ASSERT_EQ(first->name(), "a");
+
+    std::vector<evlist::InputDevice> devices{};
+    while (auto device = stream.next().value()) {
+        devices.emplace_back(std::move(*device));
+    }
+    ASSERT_GE(std::chrono::steady_clock::now() - start,
+              std::chrono::milliseconds{500});
+    ASSERT_EQ(devices.size(), 3);
+    ASSERT_EQ(devices[0].device_path(), root() / "input/event1");
+    ASSERT_TRUE(devices[0].timed_out());
+    ASSERT_EQ(devices[1].name(), "b");
+    ASSERT_EQ(devices[2].name(), "c");
+
+    // The stream matches the listing apart from when devices are output.
+    auto listed = lister.list_input_devices().value().devices();
+    ASSERT_EQ(listed.size(), 4);
+    ASSERT_EQ(listed[0].device_path(), first->device_path());
+    for (std::size_t i = 0; i < devices.size(); i++) {
+        ASSERT_EQ(listed[i + 1].device_path(), devices[i].device_path());
+    }
+}
+
+TEST_F(InputDeviceListerTest, StreamLimitAndFilter) {
+    // The stream only finishes quickly if it stops without waiting for
+    // `event10`.
+    add_device("event1", "a");
+    add_device("event2", "b");
+    add_device("event3", "b");
+    ASSERT_NO_FATAL_FAILURE(add_slow_device("event10"));
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<evlist::InputDevice> devices{};
+    {
+        auto stream = lister({{evlist::Filter::NAME, "b"}})
+                          .with_limit(2)
+                          .stream_input_devices();
+        while (auto device = stream.next().value()) {
+            devices.emplace_back(std::move(*device));
+        }
+    }
+    ASSERT_LT(std::chrono::steady_clock::now() - start,
+              std::chrono::milliseconds{500});
+    ASSERT_EQ(devices.size(), 2);
+    ASSERT_EQ(devices[0].device_path(), root() / "input/event2");
+    ASSERT_EQ(devices[1].device_path(), root() / "input/event3");
+}
+
+TEST_F(InputDeviceListerTest, StreamMissingDirectory) {
+    auto stream = evlist::InputDeviceLister{}
+                      .with_input_directory("/nonexistent")
+                      .stream_input_devices();
+    ASSERT_FALSE(stream.next().value().has_value());
+}
+
+TEST_F(InputDeviceListerTest, ParentAttributes) {
+    // Two event devices share the same parent, which is linked to from each
+    // event device as in `/sys/class/input`.
+    fs::create_directories(root() / "sys/input7/id");
+    std::ofstream{root() / "sys/input7/name"} << "keyboard\n";
+    std::ofstream{root() / "sys/input7/id/vendor"} << "046d\n";
+    std::ofstream{root() / "sys/input7/id/product"} << "c52b\n";
+    std::ofstream{root() / "sys/input7/id/bustype"} << "0003\n";
+    std::ofstream{root() / "sys/input7/phys"} << "usb-0000:00:14.0-2/input0\n";
+    std::ofstream{root() / "sys/input7/uniq"} << "\n";
+    for (const auto* device : {"event1", "event2"}) {
+        fs::create_directories(root() / "sys" / device);
+        fs::create_directory_symlink(
+            "../input7", root() / "sys" / device / "device"
+        );
+        fs::create_symlink("/dev/null", root() / "input" / device);
+    }
+
+    auto devices = lister().list_input_devices().value();
+
+    const evlist::ParentDevice expected{
+        "input7", "046d", "c52b", "0003", "usb-0000:00:14.0-2/input0", ""
+    };
+    ASSERT_EQ(devices.devices().size(), 2);
+    for (const auto& device : devices.devices()) {
+        ASSERT_EQ(device.name(), "keyboard");
+        ASSERT_EQ(device.parent(), expected);
+    }
+
+    auto groups = devices.group_by_parent();
+    ASSERT_EQ(groups.size(), 1);
+    ASSERT_EQ(groups[0].size(), 2);
+}
@@ -0,0 +1,49 @@
+#include "evlist/memo.h"
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <format>
+#include <string>
+#include <string_view>
+
+TEST(PredicateMemoTest, EvaluateOnce) {
+    evlist::PredicateMemo memo{};
+    std::size_t evaluated = 0;
+    auto predicate = [&evaluated](std::string_view value) {
+        evaluated++;
+        return value.starts_with("EV_K");
+    };
+
+    for (std::size_t i = 0; i < 10; i++) {
+        ASSERT_FALSE(memo("EV_SYN", predicate));
+        ASSERT_TRUE(memo(std::string{"EV_KEY"}, predicate));
+    }
+    ASSERT_EQ(evaluated, 2);
+    ASSERT_EQ(memo.size(), 2);
+}
+
+TEST(PredicateMemoTest, Capacity) {
+    evlist::PredicateMemo memo{};
+    std::size_t evaluated = 0;
+    auto predicate = [&evaluated](std::string_view value) {
+        evaluated++;
+        return value.ends_with('0');
+    };
+
+    for (std::size_t i = 0; i < evlist::PredicateMemo::CAPACITY + 10; i++) {
+        ASSERT_EQ(
+            memo(std::format("/dev/input/event{}", i), predicate), i % 10 == 0
+        );
+    }
+    ASSERT_EQ(memo.size(), evlist::PredicateMemo::CAPACITY);
+
+    // Values past the capacity are still correct, but evaluated every time.
+    evaluated = 0;
+    auto last = std::format(
+        "/dev/input/event{}", evlist::PredicateMemo::CAPACITY + 9
+    );
+    ASSERT_FALSE(memo(last, predicate));
+    ASSERT_FALSE(memo("/dev/input/event1", predicate));
+    ASSERT_EQ(evaluated, 1);
+}
@@ -0,0 +1,99 @@
+#include "evlist/output.h"
+
+#include <gtest/gtest.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstddef>
+#include <format>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "common/common.h"
+#include "evlist/cli.h"
+#include "evlist/device.h"
+#include "evlist/events.h"
+
+namespace {
+
+/**
+ * Create devices with values that need escaping, where every third device
+ * has a parent.
+ */
+evlist::InputDevices create_devices(
+    evlist::Format output_format, std::size_t count
+) {
+    std::vector<evlist::InputDevice> devices{};
+    for (std::size_t i = 0; i < count; i++) {
+        auto& device = devices.emplace_back(
+            std::format("/dev/input/event{}", i),
+            std::format("device \"{}\"\t{}", i, std::string(i % 7, 'x')),
+            i % 2 == 0 ? std::optional{std::format("usb-{}-event-kbd", i)}
+                       : std::nullopt,
+            std::nullopt,
+            evlist::create_capabilities()
+        );
+        if (i % 3 == 0) {
+            device.with_parent(evlist::ParentDevice{
+                std::format("input{}", i / 3), "046d", "c52b", "0003", "", ""
+            });
+        }
+    }
+    return evlist::InputDevices{output_format, std::move(devices)};
+}
+
+/**
+ * Write the devices into a memory file and read back the output.
+ */
+std::string write(const evlist::InputDevices& devices, std::size_t threads) {
+    const evlist::FileDescriptor file{memfd_create("output_test", 0)};
+    EXPECT_TRUE(file.valid());
+    EXPECT_TRUE(evlist::write_devices(file.get(), devices, threads));
+
+    std::string output(
+        static_cast<std::size_t>(lseek(file.get(), 0, SEEK_CUR)), '\0'
+    );
+    EXPECT_EQ(
+        pread(file.get(), output.data(), output.size(), 0),
+        static_cast<ssize_t>(output.size())
+    );
+    return output;
+}
+
+} // namespace
+
+TEST(WriteDevicesTest, MatchesFormat) {
+    for (auto output_format :
+         {evlist::Format::TABLE,
+          evlist::Format::CSV,
+          evlist::Format::TSV,
+          evlist::Format::JSON,
+          evlist::Format::NDJSON}) {
+        for (auto parent_columns : {false, true}) {
+            for (std::size_t count :
+                 {std::size_t{0},
+                  std::size_t{3},
+                  evlist::MIN_CHUNK_ROWS * 4 + 5}) {
+                auto devices = create_devices(output_format, count);
+                devices.with_parent_columns(parent_columns);
+
+                auto expected = std::format("{}", devices);
+                for (std::size_t threads : {0, 1, 2, 3, 8}) {
+                    ASSERT_EQ(write(devices, threads), expected)
+                        << "format " << static_cast<int>(output_format)
+                        << ", parent columns " << parent_columns
+                        << ", devices " << count << ", threads " << threads;
+                }
+            }
+        }
+    }
+}
+
+TEST(WriteDevicesTest, InvalidDescriptor) {
+    auto devices = create_devices(evlist::Format::CSV, 1);
+    auto written = evlist::write_devices(-1, devices, 1);
+    ASSERT_FALSE(written.has_value());
+    ASSERT_EQ(written.error().code().value(), EBADF);
+}
@@ -0,0 +1,188 @@
+#include "evlist/pipeline.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstddef>
+#include <latch>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace {
+
+/**
+ * A value which pauses the producer moving it into the queue, between
+ * claiming a cell and publishing it.
+ */
+struct PausedValue {
+    int value;
+    std::latch* claimed{nullptr};
+    std::latch* publish{nullptr};
+
+    PausedValue(int value, std::latch* claimed, std::latch* publish)
+        : value{value}, claimed{claimed}, publish{publish} {}
+    PausedValue(const PausedValue&) = delete;
+    PausedValue(PausedValue&& other) noexcept : value{other.value} {
+        if (other.claimed != nullptr) {
+            std::exchange(other.claimed, nullptr)->count_down();
+            std::exchange(other.publish, nullptr)->wait();
+        }
+    }
+    PausedValue& operator=(const PausedValue&) = delete;
+    PausedValue& operator=(PausedValue&&) = default;
+    ~PausedValue() = default;
+};
+
+} // namespace
+
+TEST(MpscQueueTest, PushPop) {
+    evlist::MpscQueue<std::string> queue{3};
+    ASSERT_TRUE(queue.push("a"));
+    ASSERT_TRUE(queue.push("b"));
+
+    auto deadline = std::chrono::steady_clock::now();
+    ASSERT_EQ(queue.pop_until(deadline), "a");
+    ASSERT_EQ(queue.pop_until(deadline), "b");
+    ASSERT_FALSE(queue.pop_until(deadline).has_value());
+}
+
+TEST(MpscQueueTest, Full) {
+    // The capacity is rounded up to a power of two.
+    evlist::MpscQueue<int> queue{3};
+    for (int i = 0; i < 4; i++) {
+        ASSERT_TRUE(queue.push(i));
+    }
+    ASSERT_FALSE(queue.push(4));
+
+    ASSERT_EQ(queue.pop_until(std::chrono::steady_clock::now()), 0);
+    ASSERT_TRUE(queue.push(4));
+}
+
+TEST(MpscQueueTest, Wake) {
+    evlist::MpscQueue<int> queue{1};
+    std::thread waker{[&queue] {
+        std::this_thread::sleep_for(std::chrono::milliseconds{10});
+        queue.wake();
+    }};
+
+    auto value = queue.pop_until(
+        std::chrono::steady_clock::now() + std::chrono::seconds{10}
+    );
+    waker.join();
+    ASSERT_FALSE(value.has_value());
+
+    ASSERT_TRUE(queue.push(1));
+    ASSERT_EQ(queue.pop_until(std::chrono::steady_clock::now()), 1);
+}
+
+TEST(MpscQueueTest, ConcurrentProducers) {
+    constexpr std::size_t PRODUCERS{8};
+    constexpr std::size_t VALUES{1000};
+
+    evlist::MpscQueue<std::size_t> queue{PRODUCERS * VALUES};
+    std::vector<std::thread> producers{};
+    for (std::size_t producer = 0; producer < PRODUCERS; producer++) {
+        producers.emplace_back([&queue, producer] {
+            for (std::size_t i = 0; i < VALUES; i++) {
+                ASSERT_TRUE(queue.push(producer * VALUES + i));
+            }
+        });
+    }
+
+    // Every value arrives once, and values from each producer stay in order.
+    std::vector<bool> seen(PRODUCERS * VALUES);
+    std::vector<std::size_t> next(PRODUCERS);
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds{10};
+    for (std::size_t i = 0; i < PRODUCERS * VALUES; i++) {
+        auto value = queue.pop_until(deadline);
+        ASSERT_TRUE(value.has_value());
+        ASSERT_FALSE(seen.at(*value));
+        seen.at(*value) = true;
+
+        auto producer = *value / VALUES;
+        ASSERT_EQ(*value % VALUES, next.at(producer)++);
+    }
+
+    for (auto& producer : producers) {
+        producer.join();
+    }
+}
+
+TEST(MpscQueueTest, OutOfOrderProducers) {
+    evlist::MpscQueue<PausedValue> queue{2};
+    std::latch claimed{1};
+    std::latch publish{1};
+    std::thread first{[&queue, &claimed, &publish] {
+        ASSERT_TRUE(queue.push(PausedValue{1, &claimed, &publish}));
+    }};
+
+    // The second value is published before the first, which has claimed the
+    // head cell, so the consumer must wait for the first.
+    claimed.wait();
+    ASSERT_TRUE(queue.push(PausedValue{2, nullptr, nullptr}));
+    std::thread releaser{[&publish] {
+        std::this_thread::sleep_for(std::chrono::milliseconds{10});
+        publish.count_down();
+    }};
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds{10};
+    auto head = queue.pop_until(deadline);
+    auto next = queue.pop_until(deadline);
+    ASSERT_TRUE(head.has_value());
+    ASSERT_EQ(head->value, 1);
+    ASSERT_TRUE(next.has_value());
+    ASSERT_EQ(next->value, 2);
+
+    first.join();
+    releaser.join();
+}
+
+TEST(SpscQueueTest, PushPop) {
+    evlist::SpscQueue<int> queue{2};
+    ASSERT_TRUE(queue.push(1));
+    ASSERT_TRUE(queue.push(2));
+    ASSERT_FALSE(queue.push(3));
+
+    ASSERT_EQ(queue.pop(), 1);
+    ASSERT_TRUE(queue.push(3));
+    ASSERT_EQ(queue.pop(), 2);
+    ASSERT_EQ(queue.pop(), 3);
+}
+
+TEST(SpscQueueTest, Concurrent) {
+    constexpr int VALUES{10000};
+
+    evlist::SpscQueue<int> queue{16};
+    std::thread producer{[&queue] {
+        for (int i = 0; i < VALUES; i++) {
+            while (!queue.push(i)) {
+                std::this_thread::yield();
+            }
+        }
+    }};
+
+    for (int i = 0; i < VALUES; i++) {
+        ASSERT_EQ(queue.pop(), i);
+    }
+    producer.join();
+}
+
+TEST(ReorderBufferTest, Order) {
+    evlist::ReorderBuffer<std::string> buffer{4};
+    buffer.insert(2, "c");
+    ASSERT_FALSE(buffer.pop().has_value());
+
+    buffer.insert(0, "a");
+    ASSERT_EQ(buffer.pop(), "a");
+    ASSERT_FALSE(buffer.pop().has_value());
+
+    buffer.insert(3, "d");
+    buffer.insert(1, "b");
+    ASSERT_EQ(buffer.pop(), "b");
+    ASSERT_EQ(buffer.pop(), "c");
+    ASSERT_EQ(buffer.pop(), "d");
+    ASSERT_EQ(buffer.next(), 4);
+    ASSERT_FALSE(buffer.pop().has_value());
+}
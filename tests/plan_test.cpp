@@ -0,0 +1,98 @@
+#include "evlist/plan.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <format>
+#include <iterator>
+#include <optional>
+#include <regex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "evlist/cli.h"
+#include "evlist/device.h"
+
+TEST(FilterPlanTest, InitialOrder) {
+    const evlist::FilterPlan equality{
+        {{evlist::Filter::CAPABILITIES, "EV_KEY"},
+         {evlist::Filter::NAME, "keyboard"},
+         {evlist::Filter::DEVICE_PATH, "/dev/input/event0"}},
+        false
+    };
+    ASSERT_EQ(equality.order(), (std::vector<std::size_t>{1, 2, 0}));
+
+    ASSERT_LT(
+        evlist::FilterPlan::cost(evlist::Filter::NAME, false),
+        evlist::FilterPlan::cost(evlist::Filter::NAME, true)
+    );
+    ASSERT_LT(
+        evlist::FilterPlan::cost(evlist::Filter::BY_ID, true),
+        evlist::FilterPlan::cost(evlist::Filter::CAPABILITIES, true)
+    );
+}
+
+TEST(FilterPlanTest, RefineBySelectivity) {
+    // Both filters have the same cost, but only the second rejects devices.
+    evlist::FilterPlan plan{
+        {{evlist::Filter::NAME, "keyboard"}, {evlist::Filter::BY_ID, "kbd"}},
+        false
+    };
+    ASSERT_EQ(plan.order(), (std::vector<std::size_t>{0, 1}));
+
+    const evlist::InputDevice device{
+        "/dev/input/event0", "keyboard", {}, {}, {}
+    };
+    for (std::size_t i = 0; i < evlist::FilterPlan::REPLAN_INTERVAL; i++) {
+        ASSERT_FALSE(plan.matches(device));
+    }
+    ASSERT_EQ(plan.order(), (std::vector<std::size_t>{1, 0}));
+}
+
+TEST(FilterPlanTest, ResultUnchanged) {
+    std::vector<evlist::InputDevice> devices{};
+    for (std::size_t i = 0; i < 100; i++) {
+        std::vector<std::string> capabilities{"EV_SYN"};
+        if (i % 2 == 0) {
+            capabilities.emplace_back("EV_KEY");
+        }
+        if (i % 3 == 0) {
+            capabilities.emplace_back("EV_REL");
+        }
+        devices.emplace_back(
+            std::format("/dev/input/event{}", i),
+            std::format("device {}", i % 7),
+            std::format("by_id_{}", i % 5),
+            std::nullopt,
+            std::move(capabilities)
+        );
+    }
+
+    const std::vector<evlist::FilterTerm> filter{
+        {evlist::Filter::CAPABILITIES, "EV_(KEY|REL)"},
+        {evlist::Filter::BY_ID, "by_id_[0-2]"},
+        {evlist::Filter::NAME, "device [1-5]"}
+    };
+
+    std::vector<evlist::InputDevice> expected{};
+    std::ranges::copy_if(
+        devices, std::back_inserter(expected), [&filter](const auto& device) {
+            return std::ranges::all_of(filter, [&device](const auto& filter) {
+                return evlist::InputDevices::filter_device(
+                    device, filter.column, [&filter](const auto& compare) {
+                        return std::regex_search(
+                            compare, std::regex{filter.value}
+                        );
+                    }
+                );
+            });
+        }
+    );
+
+    evlist::InputDevices filtered{devices};
+    filtered.filter(filter, true);
+    ASSERT_FALSE(expected.empty());
+    ASSERT_EQ(filtered.devices(), expected);
+}
@@ -0,0 +1,97 @@
+#include "evlist/queries.h"
+
+#include <gtest/gtest.h>
+
+#include <format>
+#include <string>
+#include <vector>
+
+#include "evlist/cli.h"
+#include "evlist/device.h"
+
+namespace {
+
+evlist::InputDevices create_devices() {
+    return evlist::InputDevices{
+        evlist::Format::CSV,
+        {{"/dev/input/event0", "keyboard", {}, {}, {"EV_SYN", "EV_KEY"}},
+         {"/dev/input/event1", "mouse", {}, {}, {"EV_SYN", "EV_KEY", "EV_REL"}},
+         {"/dev/input/event2", "touchpad", {}, {}, {"EV_SYN", "EV_ABS"}}}
+    };
+}
+
+} // namespace
+
+TEST(DeviceQueriesTest, Evaluate) {
+    const auto devices = create_devices();
+    const evlist::DeviceQueries queries{
+        {{"keys", {{evlist::Filter::CAPABILITIES, "EV_KEY"}}},
+         {"pointers",
+          {{evlist::Filter::CAPABILITIES, "EV_KEY"},
+           {evlist::Filter::CAPABILITIES, "EV_REL"}}},
+         {"none", {{evlist::Filter::NAME, "tablet"}}},
+         {"all", {}}},
+        false
+    };
+    ASSERT_EQ(queries.predicates(), 3);
+
+    auto results = queries.evaluate(devices);
+    ASSERT_EQ(
+        results.names(),
+        (std::vector<std::string>{"keys", "pointers", "none", "all"})
+    );
+    ASSERT_EQ(results.matches(0).size(), 2);
+    ASSERT_EQ(results.matches(0)[1]->name(), "mouse");
+    ASSERT_EQ(results.matches(1).size(), 1);
+    ASSERT_EQ(results.matches(1)[0], &devices.devices()[1]);
+    ASSERT_TRUE(results.matches(2).empty());
+    ASSERT_EQ(results.matches(3).size(), 3);
+}
+
+TEST(DeviceQueriesTest, EvaluateRegex) {
+    const auto devices = create_devices();
+    const evlist::DeviceQueries queries{
+        {{"touch", {{evlist::Filter::NAME, "^touch"}}},
+         {"event", {{evlist::Filter::DEVICE_PATH, "event[01]$"}}}},
+        true
+    };
+
+    auto results = queries.evaluate(devices);
+    ASSERT_EQ(results.matches(0).size(), 1);
+    ASSERT_EQ(results.matches(0)[0]->name(), "touchpad");
+    ASSERT_EQ(results.matches(1).size(), 2);
+}
+
+TEST(DeviceQueriesTest, EvaluateGlob) {
+    const auto devices = create_devices();
+    const evlist::DeviceQueries queries{
+        {{"touch", {{evlist::Filter::NAME, "touch*"}}},
+         {"escaped", {{evlist::Filter::NAME, R"(touch\*)"}}},
+         {"mouse", {{evlist::Filter::NAME, "mouse"}}}},
+        false,
+        true
+    };
+    // An escaped glob is a literal, which is not shared with the glob.
+    ASSERT_EQ(queries.predicates(), 3);
+
+    auto results = queries.evaluate(devices);
+    ASSERT_EQ(results.matches(0).size(), 1);
+    ASSERT_TRUE(results.matches(1).empty());
+    ASSERT_EQ(results.matches(2).size(), 1);
+    ASSERT_EQ(results.matches(2)[0]->name(), "mouse");
+}
+
+TEST(DeviceQueriesTest, Format) {
+    const auto devices = create_devices();
+    const evlist::DeviceQueries queries{
+        {{"abs", {{evlist::Filter::CAPABILITIES, "EV_ABS"}}}}, false
+    };
+
+    ASSERT_EQ(
+        std::format("{}", queries.evaluate(devices)),
+        R"("QUERY","NAME","DEVICE_PATH","BY_ID","BY_PATH","CAPABILITIES")"
+        "\n"
+        R"("abs","touchpad","/dev/input/event2","","","[EV_SYN, EV_ABS]")"
+        "\n"
+    );
+}
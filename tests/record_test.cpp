@@ -0,0 +1,150 @@
+#include "evlist/record.h"
+
+#include <gtest/gtest.h>
+#include <linux/input.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include "common/common.h"
+#include "evlist/device.h"
+
+namespace {
+
+evlist::fs::path temporary_path(const std::string& name) {
+    return evlist::fs::temp_directory_path() /
+           std::format("evlist_{}_{}", getpid(), name);
+}
+
+input_event create_event(uint16_t code, int32_t value) {
+    input_event event{};
+    event.input_event_sec = 1;
+    event.input_event_usec = 2;
+    event.type = EV_KEY;
+    event.code = code;
+    event.value = value;
+    return event;
+}
+
+evlist::EventRecord create_record(
+    uint32_t device, uint16_t code, int32_t value
+) {
+    return evlist::EventRecord{
+        .seconds = 1,
+        .microseconds = 2,
+        .device = device,
+        .type = EV_KEY,
+        .code = code,
+        .value = value,
+        .reserved = 0
+    };
+}
+
+const std::vector<evlist::InputDevice> DEVICES{
+    evlist::InputDevice{
+        "/dev/input/event10",
+        "10",
+        {"by_id_10"},
+        {},
+        evlist::create_capabilities()
+    },
+    evlist::InputDevice{"/dev/input/event3", "3", {}, {"by_path_3"}, {}}
+};
+
+} // namespace
+
+TEST(EventRecorderTest, Record) {
+    auto path = temporary_path("record");
+    {
+        auto recorder = evlist::EventRecorder::create(path, DEVICES, 4).value();
+        const std::vector events{
+            create_event(KEY_A, 1), create_event(KEY_B, 0)
+        };
+        recorder.append(1, events);
+        recorder.append(0, std::vector{create_event(KEY_C, 1)});
+        ASSERT_EQ(recorder.written(), 3);
+        ASSERT_TRUE(recorder.sync().has_value());
+    }
+
+    auto recording = evlist::EventRecording::open(path).value();
+    ASSERT_EQ(recording.written(), 3);
+    ASSERT_EQ(recording.overwritten(), 0);
+    ASSERT_EQ(
+        recording.records(),
+        (std::vector{
+            create_record(1, KEY_A, 1),
+            create_record(1, KEY_B, 0),
+            create_record(0, KEY_C, 1)
+        })
+    );
+
+    ASSERT_EQ(recording.devices().size(), 2);
+    ASSERT_EQ(recording.devices()[0], DEVICES[0]);
+    ASSERT_EQ(recording.devices()[0].name(), "10");
+    ASSERT_EQ(recording.devices()[0].by_id(), DEVICES[0].by_id());
+    ASSERT_EQ(
+        recording.devices()[0].capabilities(), DEVICES[0].capabilities()
+    );
+    ASSERT_EQ(recording.devices()[1], DEVICES[1]);
+    ASSERT_EQ(recording.devices()[1].by_path(), DEVICES[1].by_path());
+
+    evlist::fs::remove(path);
+}
+
+TEST(EventRecorderTest, RecordWrapAround) {
+    auto path = temporary_path("wrap_around");
+    {
+        auto recorder = evlist::EventRecorder::create(path, DEVICES, 4).value();
+        std::vector<input_event> events{};
+        for (int32_t i = 0; i < 6; i++) {
+            events.emplace_back(create_event(KEY_A, i));
+        }
+        recorder.append(0, events);
+        recorder.append(1, std::vector{create_event(KEY_B, 6)});
+        ASSERT_EQ(recorder.written(), 7);
+    }
+
+    auto recording = evlist::EventRecording::open(path).value();
+    ASSERT_EQ(recording.written(), 7);
+    ASSERT_EQ(recording.overwritten(), 3);
+    ASSERT_EQ(
+        recording.records(),
+        (std::vector{
+            create_record(0, KEY_A, 3),
+            create_record(0, KEY_A, 4),
+            create_record(0, KEY_A, 5),
+            create_record(1, KEY_B, 6)
+        })
+    );
+
+    evlist::fs::remove(path);
+}
+
+TEST(EventRecorderTest, CreateZeroCapacity) {
+    auto path = temporary_path("zero_capacity");
+    ASSERT_FALSE(evlist::EventRecorder::create(path, DEVICES, 0).has_value());
+}
+
+TEST(EventRecorderTest, OpenInvalid) {
+    auto path = temporary_path("invalid");
+    {
+        std::ofstream file{path};
+        file << "not a recording, but long enough to contain a header";
+    }
+
+    auto recording = evlist::EventRecording::open(path);
+    ASSERT_FALSE(recording.has_value());
+    ASSERT_EQ(
+        recording.error().code(),
+        std::make_error_code(std::errc::invalid_argument)
+    );
+
+    evlist::fs::remove(path);
+    ASSERT_FALSE(evlist::EventRecording::open(path).has_value());
+}
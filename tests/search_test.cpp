@@ -0,0 +1,127 @@
+#include "evlist/search.h"
+
+#include <gtest/gtest.h>
+
+#include <cctype>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "common/common.h"
+#include "evlist/cli.h"
+#include "evlist/device.h"
+
+TEST(SearchTest, Contains) {
+    ASSERT_TRUE(evlist::contains("Logitech USB Receiver", "USB"));
+    ASSERT_TRUE(evlist::contains("Logitech USB Receiver", "L"));
+    ASSERT_TRUE(evlist::contains("Logitech USB Receiver", ""));
+    ASSERT_TRUE(evlist::contains("", ""));
+    ASSERT_FALSE(evlist::contains("", "a"));
+    ASSERT_FALSE(evlist::contains("Logitech USB Receiver", "usb"));
+    ASSERT_FALSE(evlist::contains("USB", "USB Receiver"));
+
+    // Place the substring at every position of values which are longer and
+    // shorter than a vector block, including across block boundaries.
+    for (std::size_t length : {5UZ, 17UZ, 40UZ, 100UZ}) {
+        for (std::size_t position = 0; position + 3 <= length; position++) {
+            std::string value(length, 'k');
+            value.replace(position, 3, "kbd");
+            ASSERT_TRUE(evlist::contains(value, "kbd"));
+            ASSERT_EQ(evlist::contains(value, "kbdk"), position + 3 < length);
+            ASSERT_FALSE(evlist::contains(value, "kbb"));
+        }
+    }
+
+    // Candidates where the first and last characters match but the middle
+    // does not.
+    ASSERT_FALSE(evlist::contains(std::string(64, 'a'), "aba"));
+    ASSERT_TRUE(evlist::contains(std::string(64, 'a') + "aba", "aba"));
+}
+
+TEST(SearchTest, EqualsIgnoreCase) {
+    ASSERT_TRUE(evlist::equals_ignore_case("", ""));
+    ASSERT_TRUE(evlist::equals_ignore_case("Logitech", "lOGITECH"));
+    ASSERT_FALSE(evlist::equals_ignore_case("Logitech", "Logitec"));
+    ASSERT_FALSE(evlist::equals_ignore_case("Logitech", "Logitecx"));
+
+    // Only ASCII letters are folded, including the characters either side of
+    // each range.
+    ASSERT_FALSE(evlist::equals_ignore_case("@", "`"));
+    ASSERT_FALSE(evlist::equals_ignore_case("[", "{"));
+    ASSERT_FALSE(evlist::equals_ignore_case("\xC0", "\xE0"));
+
+    // A difference at any position is found, whichever block it is in.
+    for (std::size_t length = 1; length < 70; length++) {
+        const std::string lhs(length, 'K');
+        ASSERT_TRUE(evlist::equals_ignore_case(lhs, std::string(length, 'k')));
+        for (std::size_t position = 0; position < length; position++) {
+            auto rhs = std::string(length, 'k');
+            rhs[position] = 'j';
+            ASSERT_FALSE(evlist::equals_ignore_case(lhs, rhs));
+        }
+    }
+
+    for (int first = 0; first < 256; first++) {
+        for (int second = 0; second < 256; second++) {
+            // Repeat the characters so that the vector paths are used.
+            const std::string lhs(40, static_cast<char>(first));
+            const std::string rhs(40, static_cast<char>(second));
+            ASSERT_EQ(
+                evlist::equals_ignore_case(lhs, rhs),
+                std::tolower(first) == std::tolower(second)
+            )
+                << first << " " << second;
+        }
+    }
+}
+
+TEST(SearchTest, FilterOperators) {
+    const evlist::InputDevice first{
+        "/dev/input/event3",
+        "Logitech USB Receiver",
+        {"usb-Logitech-event-kbd"},
+        {"by_path_3"},
+        evlist::create_capabilities()
+    };
+    const evlist::InputDevice second{
+        "/dev/input/event10",
+        "AT Translated Set 2 keyboard",
+        {},
+        {"by_path_10"},
+        evlist::create_capabilities()
+    };
+    const std::vector devices{first, second};
+
+    auto contains = evlist::InputDevices{devices};
+    contains.filter(
+        {{evlist::Filter::NAME, "USB", evlist::FilterOperator::CONTAINS}}, false
+    );
+    ASSERT_EQ(contains.devices(), std::vector{first});
+
+    auto prefix = evlist::InputDevices{devices};
+    prefix.filter(
+        {{evlist::Filter::DEVICE_PATH,
+          "/dev/input/event1",
+          evlist::FilterOperator::PREFIX}},
+        false
+    );
+    ASSERT_EQ(prefix.devices(), std::vector{second});
+
+    auto case_insensitive = evlist::InputDevices{devices};
+    case_insensitive.filter(
+        {{evlist::Filter::NAME,
+          "logitech usb receiver",
+          evlist::FilterOperator::CASE_INSENSITIVE}},
+        false
+    );
+    ASSERT_EQ(case_insensitive.devices(), std::vector{first});
+
+    // Operators compare literally, even when equality filters use a regex.
+    auto regex = evlist::InputDevices{devices};
+    regex.filter(
+        {{evlist::Filter::NAME, "^AT", evlist::FilterOperator::CONTAINS},
+         {evlist::Filter::BY_PATH, "by_path_1.$"}},
+        true
+    );
+    ASSERT_TRUE(regex.devices().empty());
+}
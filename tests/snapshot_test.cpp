@@ -0,0 +1,151 @@
+#include "evlist/snapshot.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstddef>
+#include <format>
+#include <optional>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "common/common.h"
+#include "evlist/device.h"
+#include "evlist/list.h"
+
+namespace {
+
+/**
+ * Create devices where every device is named after the generation, so that
+ * a reader can check it never sees a partially published snapshot.
+ */
+evlist::InputDevices create_generation(std::size_t generation) {
+    std::vector<evlist::InputDevice> devices{};
+    for (std::size_t i = 0; i < generation % 8 + 1; i++) {
+        devices.emplace_back(
+            std::format("/dev/input/event{}", i),
+            std::to_string(generation),
+            std::nullopt,
+            std::nullopt,
+            evlist::create_capabilities()
+        );
+    }
+    return evlist::InputDevices{std::move(devices)};
+}
+
+} // namespace
+
+TEST(InputDevicesSnapshotTest, LoadInitial) {
+    const evlist::InputDevicesSnapshot empty{};
+    ASSERT_TRUE(empty.load()->devices().empty());
+    ASSERT_EQ(empty.generation(), 0);
+
+    const evlist::InputDevicesSnapshot snapshot{create_generation(0)};
+    ASSERT_EQ(snapshot.load()->devices().size(), 1);
+}
+
+TEST(InputDevicesSnapshotTest, Publish) {
+    evlist::InputDevicesSnapshot snapshot{create_generation(0)};
+    auto previous = snapshot.load();
+
+    snapshot.publish(create_generation(1));
+    ASSERT_EQ(snapshot.generation(), 1);
+    ASSERT_EQ(snapshot.load()->devices().front().name(), "1");
+
+    // Readers keep their snapshot after newer ones are published.
+    snapshot.publish(create_generation(2));
+    snapshot.publish(create_generation(3));
+    ASSERT_EQ(previous->devices().front().name(), "0");
+    ASSERT_EQ(snapshot.load()->devices().front().name(), "3");
+}
+
+TEST(InputDevicesSnapshotTest, Update) {
+    evlist::InputDevicesSnapshot snapshot{create_generation(2)};
+    auto device = [](std::size_t number, std::string name) {
+        return evlist::InputDevice{
+            std::format("/dev/input/event{}", number),
+            std::move(name),
+            std::nullopt,
+            std::nullopt,
+            evlist::create_capabilities()
+        };
+    };
+
+    // Devices are added in natural sort order, and replaced or removed by
+    // their file name.
+    snapshot.update("event10", device(10, "added"));
+    snapshot.update("event1", device(1, "changed"));
+    snapshot.update("event0", std::nullopt);
+    ASSERT_EQ(snapshot.generation(), 3);
+
+    std::vector<std::string> names{};
+    for (const auto& updated : snapshot.load()->devices()) {
+        names.emplace_back(
+            std::format("{} {}", updated.device_path().string(), updated.name())
+        );
+    }
+    ASSERT_EQ(
+        names,
+        (std::vector<std::string>{
+            "/dev/input/event1 changed",
+            "/dev/input/event2 2",
+            "/dev/input/event10 added"
+        })
+    );
+}
+
+TEST(InputDevicesSnapshotTest, RefreshMissingDirectory) {
+    evlist::InputDevicesSnapshot snapshot{create_generation(0)};
+    auto result =
+        snapshot.refresh(evlist::InputDeviceLister{}.with_input_directory(
+            "/nonexistent"
+        ));
+
+    // A missing input directory lists no devices rather than failing.
+    ASSERT_TRUE(result.has_value());
+    ASSERT_TRUE(snapshot.load()->devices().empty());
+    ASSERT_EQ(snapshot.generation(), 1);
+}
+
+TEST(InputDevicesSnapshotTest, ConcurrentReaders) {
+    constexpr std::size_t READERS{8};
+    constexpr std::size_t PUBLISHES{2000};
+
+    evlist::InputDevicesSnapshot snapshot{create_generation(0)};
+    std::atomic<bool> done{false};
+    std::atomic<std::size_t> failures{0};
+
+    std::vector<std::thread> readers{};
+    for (std::size_t i = 0; i < READERS; i++) {
+        readers.emplace_back([&snapshot, &done, &failures] {
+            std::size_t last = 0;
+            while (!done.load()) {
+                auto devices = snapshot.load();
+                auto generation = std::stoul(devices->devices().front().name());
+                if (devices->devices().size() != generation % 8 + 1 ||
+                    generation < last) {
+                    failures++;
+                }
+                for (const auto& device : devices->devices()) {
+                    if (device.name() != std::to_string(generation)) {
+                        failures++;
+                    }
+                }
+                last = generation;
+            }
+        });
+    }
+
+    for (std::size_t generation = 1; generation <= PUBLISHES; generation++) {
+        snapshot.publish(create_generation(generation));
+    }
+    done.store(true);
+    for (auto& reader : readers) {
+        reader.join();
+    }
+
+    ASSERT_EQ(failures.load(), 0);
+    ASSERT_EQ(snapshot.generation(), PUBLISHES);
+}
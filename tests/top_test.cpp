@@ -0,0 +1,77 @@
+#include "evlist/top.h"
+
+#include <gtest/gtest.h>
+#include <linux/input.h>
+
+#include <chrono>
+#include <format>
+#include <vector>
+
+#include "evlist/cli.h"
+#include "evlist/device.h"
+
+namespace {
+
+input_event create_event(uint16_t type, uint16_t code) {
+    input_event event{};
+    event.type = type;
+    event.code = code;
+    return event;
+}
+
+} // namespace
+
+TEST(EventRatesTest, Counts) {
+    evlist::EventCounts counts{};
+    const std::vector events{
+        create_event(EV_KEY, KEY_A),
+        create_event(EV_SYN, SYN_REPORT),
+        create_event(EV_SYN, SYN_DROPPED),
+        create_event(EV_MAX + 1, 0)
+    };
+    counts.record(events);
+
+    ASSERT_EQ(counts.events(), 4);
+    ASSERT_EQ(counts.syn_dropped(), 1);
+    ASSERT_EQ(counts.types()[EV_KEY], 1);
+    ASSERT_EQ(counts.types()[EV_SYN], 2);
+
+    counts.reset();
+    ASSERT_EQ(counts.events(), 0);
+    ASSERT_EQ(counts.types()[EV_SYN], 0);
+}
+
+TEST(EventRatesTest, Rates) {
+    evlist::EventRates rates{
+        evlist::Format::TABLE,
+        {{"/dev/input/event0", "slow", {}, {}, {}},
+         {"/dev/input/event1", "fast", {}, {}, {}}}
+    };
+
+    const std::vector slow{create_event(EV_KEY, KEY_A)};
+    const std::vector fast{
+        create_event(EV_REL, REL_X),
+        create_event(EV_REL, REL_Y),
+        create_event(EV_SYN, SYN_REPORT),
+        create_event(EV_SYN, SYN_DROPPED)
+    };
+    rates.record(0, slow);
+    rates.record(1, fast);
+    rates.finish_interval(std::chrono::milliseconds{500});
+
+    ASSERT_EQ(rates.order(), (std::vector<std::size_t>{1, 0}));
+    ASSERT_DOUBLE_EQ(rates.rate(0), 2);
+    ASSERT_DOUBLE_EQ(rates.rate(1), 8);
+    ASSERT_EQ(rates.counts(1).syn_dropped(), 1);
+
+    ASSERT_EQ(
+        std::format("{}", rates),
+        "DEVICE_PATH       NAME EVENTS_PER_SEC SYN_DROPPED TYPES\n"
+        "/dev/input/event1 fast 8.0            1           EV_SYN=2, EV_REL=2\n"
+        "/dev/input/event0 slow 2.0            0           EV_KEY=1\n"
+    );
+
+    // The next interval starts with no events.
+    rates.finish_interval(std::chrono::seconds{1});
+    ASSERT_DOUBLE_EQ(rates.rate(1), 0);
+}